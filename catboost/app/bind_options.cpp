@@ -895,6 +895,50 @@ static void BindDistributedTrainingParams(NLastGetopt::TOpts* parserPtr, NJson::
         .Handler1T<TString>([plainJsonPtr](const TString& nodeFile) {
             (*plainJsonPtr)["file_with_hosts"] = nodeFile;
         });
+
+    parser
+        .AddLongOption("workers-load-learn-data")
+        .NoArgument()
+        .Help("Workers load and quantize their parts of learn dataset themselves, master sends them only quantization borders and row ranges; requires learn dataset in dsv format and --has-time")
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr)["workers_load_learn_data"] = true;
+        });
+
+    parser
+        .AddLongOption("exchange-stats-in-float")
+        .NoArgument()
+        .Help("Send bucket stats between hosts as float instead of double; reduces network traffic, split scores become approximate")
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr)["exchange_stats_in_float"] = true;
+        });
+
+    parser
+        .AddLongOption("worker-response-timeout")
+        .RequiredArgument("seconds")
+        .Help("Stop training if workers don't respond in this time, 0 means wait forever (default); "
+              "use with --snapshot-file to resume training with the same or replaced worker hosts")
+        .Handler1T<ui32>([plainJsonPtr](ui32 timeout) {
+            (*plainJsonPtr)["worker_response_timeout"] = timeout;
+        });
+
+    parser
+        .AddLongOption("local-worker-count")
+        .RequiredArgument("int")
+        .Help("Run distributed training on this host: start this number of workers as child processes "
+              "and use this process as their master; thread count is divided between workers and master")
+        .Handler1T<ui32>([plainJsonPtr](ui32 workerCount) {
+            (*plainJsonPtr)["local_worker_count"] = workerCount;
+        });
+
+    parser
+        .AddLongOption("local-workers-numa-affinity")
+        .NoArgument()
+        .Help("Distribute local workers among NUMA nodes and run each worker only on cpus of its node, "
+              "so that its part of data is allocated in memory of the node; Linux only. "
+              "Training without local workers has no NUMA handling")
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr)["local_workers_numa_affinity"] = true;
+        });
 }
 
 static void BindSystemParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* plainJsonPtr) {
@@ -973,6 +1017,12 @@ static void BindBinarizationParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonVa
         .Handler1T<ENanMode>([plainJsonPtr](const auto nanMode) {
             (*plainJsonPtr)["nan_mode"] = ToString(nanMode);
         });
+
+    parser.AddLongOption("use-quantile-sketches-for-borders", "Calc float feature borders from quantile sketches of all feature values instead of a random subset of objects")
+        .NoArgument()
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr)["use_quantile_sketches_for_borders"] = true;
+        });
 }
 
 static void BindCatboostParams(NLastGetopt::TOpts* parserPtr, NJson::TJsonValue* plainJsonPtr) {
@@ -0,0 +1,163 @@
+#include "local_workers.h"
+
+#include <catboost/libs/helpers/cpu_affinity.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+
+#include <util/datetime/base.h>
+#include <util/generic/xrange.h>
+#include <util/network/sock.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/string/strip.h>
+#include <util/system/execpath.h>
+#include <util/system/fs.h>
+#include <util/system/info.h>
+#include <util/system/mktemp.h>
+
+
+static constexpr TDuration WorkerStartTimeout = TDuration::Seconds(60);
+
+
+static bool IsLocalPortFree(ui16 port) {
+    TInetStreamSocket socket;
+    TSockAddrInet addr("127.0.0.1", port);
+    return socket.Bind(&addr) >= 0;
+}
+
+static TVector<ui16> GetFreeLocalPorts(ui32 count) {
+    /* probe sockets are kept bound until all ports are chosen, so the ports are distinct;
+     * ports are released before workers bind them, so one may be taken in between, then its worker fails to start
+     */
+    TVector<TInetStreamSocket> sockets(count);
+    TVector<ui16> ports;
+    for (auto& socket : sockets) {
+        TSockAddrInet addr("127.0.0.1", 0);
+        CB_ENSURE(socket.Bind(&addr) >= 0, "Can't find free TCP port for local worker");
+        ports.push_back(addr.GetPort());
+    }
+    return ports;
+}
+
+/* cpu lists of online NUMA nodes with cpus (memory-only nodes are skipped) in kernel format, e.g. "0-15,64-79";
+ * empty if NUMA topology is unknown
+ */
+static TVector<TString> GetNumaNodeCpuLists() {
+    TVector<TString> cpuLists;
+#if defined(_linux_)
+    // node ids may be non-contiguous, e.g. "0,2-3"
+    const TString onlineNodesPath = "/sys/devices/system/node/online";
+    if (!NFs::Exists(onlineNodesPath)) {
+        return cpuLists;
+    }
+    for (ui32 node : NCB::ParseCpuList(StripString(TFileInput(onlineNodesPath).ReadAll()))) {
+        const TString path = "/sys/devices/system/node/node" + ToString(node) + "/cpulist";
+        if (!NFs::Exists(path)) {
+            continue;
+        }
+        TString cpuList = StripString(TFileInput(path).ReadAll());
+        if (!cpuList.empty()) {
+            cpuLists.push_back(std::move(cpuList));
+        }
+    }
+#endif
+    return cpuLists;
+}
+
+TLocalWorkers::TLocalWorkers(ui32 workerCount, bool bindToNumaNodes, NJson::TJsonValue* plainJsonPtr)
+    : HostsFile(MakeTempName(nullptr, "catboost_hosts"))
+{
+    auto& plainJson = *plainJsonPtr;
+    CB_ENSURE(workerCount > 0, "Local worker count should be positive");
+    CB_ENSURE(
+        !plainJson.Has("node_type") && !plainJson.Has("file_with_hosts"),
+        "Local workers can't be used with --node-type and --file-with-hosts"
+    );
+
+    /* master and workers share cores of this host: master mostly waits for workers, it needs threads
+     * only for steps between worker calls (test approxes, metrics), so it gets the cores left by workers
+     */
+    const ui32 threadCount = plainJson.Has("thread_count")
+        ? plainJson["thread_count"].GetUInteger()
+        : NSystemInfo::CachedNumberOfCpus();
+    CB_ENSURE(threadCount > 0, "Thread count should be positive");
+    const ui32 workerThreadCount = Max<ui32>(1, (threadCount - 1) / workerCount);
+    const ui32 masterThreadCount = (threadCount > workerCount * workerThreadCount)
+        ? threadCount - workerCount * workerThreadCount
+        : 1;
+
+    TVector<TString> numaNodeCpuLists;
+    if (bindToNumaNodes) {
+        numaNodeCpuLists = GetNumaNodeCpuLists();
+        CB_ENSURE(!numaNodeCpuLists.empty(), "Can't get NUMA nodes of this host");
+        if (workerCount % numaNodeCpuLists.size() != 0) {
+            CATBOOST_WARNING_LOG << "Local worker count " << workerCount << " is not a multiple of NUMA node count "
+                << numaNodeCpuLists.size() << ", NUMA nodes will have different load" << Endl;
+        }
+    }
+
+    const TVector<ui16> ports = GetFreeLocalPorts(workerCount);
+    {
+        TFileOutput hosts(HostsFile.Name());
+        for (auto port : ports) {
+            hosts << "localhost:" << port << Endl;
+        }
+    }
+
+    const TShellCommandOptions options = TShellCommandOptions()
+        .SetAsync(true)
+        .SetLatency(100)
+        .SetUseShell(false)
+        .SetInheritOutput(true)
+        .SetInheritError(true);
+    for (auto workerIdx : xrange(workerCount)) {
+        TList<TString> args = {
+            "run-worker",
+            "--node-port", ToString(ports[workerIdx]),
+            "--thread-count", ToString(workerThreadCount)
+        };
+        if (bindToNumaNodes) {
+            // worker allocates its part of data after pinning, so first touch places it on its node
+            const ui32 node = workerIdx % numaNodeCpuLists.size();
+            args.push_back("--cpu-list");
+            args.push_back(numaNodeCpuLists[node]);
+            CATBOOST_INFO_LOG << "Local worker " << workerIdx << " runs on NUMA node " << node
+                << " (cpus " << numaNodeCpuLists[node] << ")" << Endl;
+        }
+        Workers.emplace_back(MakeHolder<TShellCommand>(GetExecPath(), args, options));
+        Workers.back()->Run();
+    }
+
+    const TInstant deadline = WorkerStartTimeout.ToDeadLine();
+    for (auto workerIdx : xrange(workerCount)) {
+        while (IsLocalPortFree(ports[workerIdx])) {
+            CB_ENSURE(
+                Workers[workerIdx]->GetStatus() == TShellCommand::SHELL_RUNNING,
+                "Local worker on port " << ports[workerIdx] << " exited: " << Workers[workerIdx]->GetError()
+            );
+            CB_ENSURE(Now() < deadline, "Local worker on port " << ports[workerIdx] << " didn't start in " << WorkerStartTimeout);
+            Sleep(TDuration::MilliSeconds(100));
+        }
+    }
+    CATBOOST_INFO_LOG << "Started " << workerCount << " local workers with " << workerThreadCount << " threads each, "
+        << "master uses " << masterThreadCount << " threads" << Endl;
+
+    plainJson["thread_count"] = masterThreadCount;
+    plainJson["node_type"] = "Master";
+    plainJson["file_with_hosts"] = HostsFile.Name();
+}
+
+TLocalWorkers::~TLocalWorkers() {
+    for (auto& worker : Workers) {
+        if (worker->GetStatus() == TShellCommand::SHELL_RUNNING) {
+            worker->Terminate();
+            worker->Wait();
+        }
+    }
+}
+
+void TLocalWorkers::Wait() {
+    for (auto& worker : Workers) {
+        worker->Wait();
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <library/json/json_value.h>
+
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+#include <util/system/shellcommand.h>
+#include <util/system/tempfile.h>
+
+
+/* Runs workers of distributed training as child processes of this process on localhost
+ * and makes plain options of this process describe the master of these workers.
+ * Thread count of plain options is divided between workers and master.
+ * Workers exit when master finishes training, see Wait.
+ * If bindToNumaNodes, workers are distributed round-robin among NUMA nodes of this host
+ * and each worker runs only on cpus of its node. This is the only NUMA handling: training
+ * without local workers runs all threads of one process unpinned, its data isn't placed per node.
+ *
+ * Master and workers communicate over loopback TCP through library/par exactly as hosts of
+ * regular distributed training do, there is no shared memory transport: messages of a tree depth
+ * are candidate lists and bucket stats whose size doesn't depend on object count. Data locality
+ * comes from workers loading their parts of learn data themselves (workers_load_learn_data)
+ * after being bound to NUMA nodes.
+ */
+class TLocalWorkers {
+public:
+    TLocalWorkers(ui32 workerCount, bool bindToNumaNodes, NJson::TJsonValue* plainJsonPtr);
+    ~TLocalWorkers(); // terminates workers which are still running
+
+    void Wait();
+
+private:
+    TTempFile HostsFile;
+    TVector<THolder<TShellCommand>> Workers;
+};
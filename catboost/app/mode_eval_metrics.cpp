@@ -118,6 +118,11 @@ int mode_eval_metrics(int argc, const char* argv[]) {
         .SetFlag(&calcOnParts)
         .NoArgument();
 
+    bool singlePass = false;
+    parser.AddLongOption("single-pass", "Read pool once, approxes for non-additive metrics are stored in tmp-dir")
+        .SetFlag(&singlePass)
+        .NoArgument();
+
     parser.SetFreeArgsNum(0);
     {
         NLastGetopt::TOptsParseResult parseResult(&parser, argc, argv);
@@ -156,6 +161,22 @@ int mode_eval_metrics(int argc, const char* argv[]) {
         metrics
     );
 
+    if (singlePass) {
+        CB_ENSURE(!calcOnParts, "single-pass and calc-on-parts options are incompatible");
+        ReadAndProceedPoolInBlocks(params, plotParams.ReadBlockSize, [&](TDataProviderPtr datasetPart) {
+            auto processedDataProvider = CreateModelCompatibleProcessedDataProvider(
+                *datasetPart,
+                metricDescriptions,
+                model,
+                &rand,
+                &executor);
+            plotCalcer.ProceedDataSetInSinglePass(processedDataProvider);
+        }, &executor);
+        plotCalcer.FinishProceedDataSetInSinglePass();
+        plotCalcer.SaveResult(plotParams.ResultDirectory, params.OutputPath.Path, true /*saveMetrics*/, saveStats).ClearTempFiles();
+        return 0;
+    }
+
     TVector<TProcessedDataProvider> datasetParts;
     if (plotCalcer.HasAdditiveMetric()) {
         ReadAndProceedPoolInBlocks(params, plotParams.ReadBlockSize, [&](TDataProviderPtr datasetPart) {
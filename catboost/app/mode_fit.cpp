@@ -1,5 +1,6 @@
 #include "modes.h"
 #include "bind_options.h"
+#include "local_workers.h"
 
 #include <catboost/libs/algo/helpers.h>
 #include <catboost/libs/data_new/baseline.h>
@@ -41,6 +42,16 @@ int mode_fit(int argc, const char* argv[]) {
     TString paramsFile;
     NJson::TJsonValue catBoostFlatJsonOptions;
     ParseCommandLine(argc, argv, &catBoostFlatJsonOptions, &paramsFile, &poolLoadParams);
+    const bool bindLocalWorkersToNumaNodes = catBoostFlatJsonOptions.Has("local_workers_numa_affinity");
+    catBoostFlatJsonOptions.EraseValue("local_workers_numa_affinity");
+    THolder<TLocalWorkers> localWorkers;
+    if (catBoostFlatJsonOptions.Has("local_worker_count")) {
+        const ui32 localWorkerCount = catBoostFlatJsonOptions["local_worker_count"].GetUInteger();
+        catBoostFlatJsonOptions.EraseValue("local_worker_count");
+        localWorkers = MakeHolder<TLocalWorkers>(localWorkerCount, bindLocalWorkersToNumaNodes, &catBoostFlatJsonOptions);
+    } else {
+        CB_ENSURE(!bindLocalWorkersToNumaNodes, "--local-workers-numa-affinity requires --local-worker-count");
+    }
     NJson::TJsonValue catBoostJsonOptions;
     NJson::TJsonValue outputOptionsJson;
     InitOptions(paramsFile, &catBoostJsonOptions, &outputOptionsJson);
@@ -53,6 +64,9 @@ int mode_fit(int argc, const char* argv[]) {
     //Cout << LabeledOutput(outputOptions.UseBestModel.IsSet()) << Endl;
 
     TrainModel(poolLoadParams, outputOptions, catBoostJsonOptions);
+    if (localWorkers) {
+        localWorkers->Wait();
+    }
 
     #if defined(USE_MPI)
     if (mpiManager.IsMaster()) {
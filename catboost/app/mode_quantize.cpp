@@ -0,0 +1,106 @@
+#include "modes.h"
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/options/analytical_mode_params.h>
+#include <catboost/libs/quantized_pool/converter.h>
+
+#include <library/getopt/small/last_getopt.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/serialized_enum.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/string/iterator.h>
+#include <util/system/info.h>
+
+
+using namespace NCB;
+
+
+struct TQuantizeParams {
+    TPoolConversionParams ConversionParams;
+    TString OutputPath;
+    int ThreadCount = NSystemInfo::CachedNumberOfCpus();
+
+    TQuantizeParams() {
+        ConversionParams.FloatFeaturesBinarization.NanMode.Set(ENanMode::Min);
+    }
+
+    void BindParserOpts(NLastGetopt::TOpts& parser) {
+        parser.AddLongOption('i', "input-path", "input pool path")
+            .StoreResult(&ConversionParams.PoolPath)
+            .RequiredArgument("PATH")
+            .Required();
+        BindDsvPoolFormatParams(&parser, &ConversionParams.DsvPoolFormatParams);
+        parser.AddLongOption('o', "output-path", "quantized pool path")
+            .StoreResult(&OutputPath)
+            .RequiredArgument("PATH")
+            .Required();
+        parser.AddLongOption("input-borders-file", "file with borders, borders for other features are calculated on the first block")
+            .StoreResult(&ConversionParams.InputBordersPath)
+            .RequiredArgument("PATH");
+        parser.AddLongOption('x', "border-count", "count of borders per float feature. Should be in range [1, 255]")
+            .RequiredArgument("int")
+            .Handler1T<ui32>([this](ui32 count) {
+                ConversionParams.FloatFeaturesBinarization.BorderCount.Set(count);
+            });
+        parser.AddLongOption("feature-border-type", TString::Join("Must be one of: ", GetEnumAllNames<EBorderSelectionType>()))
+            .RequiredArgument("border-type")
+            .Handler1T<EBorderSelectionType>([this](const auto type) {
+                ConversionParams.FloatFeaturesBinarization.BorderSelectionType.Set(type);
+            });
+        parser.AddLongOption("nan-mode", TString::Join("Must be one of: ", GetEnumAllNames<ENanMode>(), " Default: ", ToString(ENanMode::Min)))
+            .RequiredArgument("nan-mode")
+            .Handler1T<ENanMode>([this](const auto nanMode) {
+                ConversionParams.FloatFeaturesBinarization.NanMode.Set(nanMode);
+            });
+        parser.AddLongOption('I', "ignore-features", "don't use the specified features (the features are separated by colon and can be specified as an inclusive interval, for example: -I 4:78-89:312)")
+            .RequiredArgument("INDEXES")
+            .Handler1T<TString>([this](const TString& indicesLine) {
+                for (const auto& t : StringSplitter(indicesLine).Split(':')) {
+                    const auto s = t.Token();
+                    const ui32 from = FromString<ui32>(s.Before('-'));
+                    const ui32 to = FromString<ui32>(s.After('-')) + 1;
+                    for (ui32 i = from; i < to; ++i) {
+                        ConversionParams.IgnoredFeatures.push_back(i);
+                    }
+                }
+            });
+        parser.AddLongOption("class-names", "names for classes.")
+            .RequiredArgument("comma separated list of names")
+            .Handler1T<TString>([this](const TString& namesLine) {
+                for (const auto& t : StringSplitter(namesLine).Split(',')) {
+                    ConversionParams.ClassNames.push_back(FromString<TString>(t.Token()));
+                }
+            });
+        parser.AddLongOption("block-size", "number of objects read, quantized and written at once")
+            .StoreResult(&ConversionParams.BlockSize)
+            .RequiredArgument("INT")
+            .DefaultValue(ConversionParams.BlockSize);
+        parser.AddLongOption('T', "thread-count", "worker thread count (default: core count)")
+            .StoreResult(&ThreadCount)
+            .RequiredArgument("INT");
+    }
+};
+
+int mode_quantize(int argc, const char* argv[]) {
+    TQuantizeParams params;
+
+    auto parser = NLastGetopt::TOpts();
+    parser.AddHelpOption();
+    params.BindParserOpts(parser);
+    parser.SetFreeArgsNum(0);
+    NLastGetopt::TOptsParseResult parserResult{&parser, argc, argv};
+
+    params.ConversionParams.DsvPoolFormatParams.Validate();
+    params.ConversionParams.FloatFeaturesBinarization.Validate();
+    CB_ENSURE(params.ConversionParams.BlockSize > 0, "block size should be positive");
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(params.ThreadCount - 1);
+
+    TFileOutput output(params.OutputPath);
+    ConvertPoolToQuantized(params.ConversionParams, &output, &localExecutor);
+    output.Finish();
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include "modes.h"
 
 #include <catboost/libs/distributed/worker.h>
+#include <catboost/libs/helpers/cpu_affinity.h>
 
 #include <library/getopt/small/last_getopt.h>
 
@@ -11,12 +12,15 @@ namespace {
     struct TWorkerParams {
         ui32 NodePort = 0;
         ui32 ThreadCount = NSystemInfo::CachedNumberOfCpus();
+        TString CpuList;
 
         void BindParserOpts(NLastGetopt::TOpts& parser) {
             parser.AddLongOption('T', "thread-count", "worker thread count (default: core count)")
                 .StoreResult(&ThreadCount);
             parser.AddLongOption("node-port", "TCP port for this worker; default is 0")
                 .StoreResult(&NodePort);
+            parser.AddLongOption("cpu-list", "run worker only on these cpus, e.g. 0-15,64-79; default is all cpus")
+                .StoreResult(&CpuList);
         }
     };
 } // anonymous namespace
@@ -30,6 +34,9 @@ int mode_run_worker(int argc, const char* argv[]) {
     parser.SetFreeArgsNum(0);
     NLastGetopt::TOptsParseResult parserResult{&parser, argc, argv};
 
+    if (!params.CpuList.empty()) {
+        NCB::SetProcessCpuAffinity(params.CpuList);
+    }
     RunWorker(params.ThreadCount, params.NodePort);
 
     return 0;
@@ -799,3 +799,75 @@ void TStats3D::Add(const TStats3D& stats3D) {
         Stats[statIdx].Add(stats3D.Stats[statIdx]);
     }
 }
+
+template <typename TValue>
+static void SaveNonEmptyBucketStats(
+    TConstArrayRef<TBucketStats> stats,
+    TConstArrayRef<ui64> nonEmptyMask,
+    IBinSaver* binSaver
+) {
+    TVector<TValue> values;
+    for (auto statIdx : xrange(stats.size())) {
+        if (nonEmptyMask[statIdx / 64] & (1ull << (statIdx % 64))) {
+            const auto& bucket = stats[statIdx];
+            values.insert(
+                values.end(),
+                {TValue(bucket.SumWeightedDelta), TValue(bucket.SumWeight), TValue(bucket.SumDelta), TValue(bucket.Count)});
+        }
+    }
+    binSaver->Add(0, &values);
+}
+
+template <typename TValue>
+static void LoadNonEmptyBucketStats(
+    TConstArrayRef<ui64> nonEmptyMask,
+    TArrayRef<TBucketStats> stats,
+    IBinSaver* binSaver
+) {
+    TVector<TValue> values;
+    binSaver->Add(0, &values);
+    size_t valueIdx = 0;
+    for (auto statIdx : xrange(stats.size())) {
+        if (nonEmptyMask[statIdx / 64] & (1ull << (statIdx % 64))) {
+            CB_ENSURE_INTERNAL(valueIdx + 4 <= values.size(), "Not enough values for nonempty buckets");
+            stats[statIdx] = TBucketStats{values[valueIdx], values[valueIdx + 1], values[valueIdx + 2], values[valueIdx + 3]};
+            valueIdx += 4;
+        } else {
+            stats[statIdx] = TBucketStats{0, 0, 0, 0};
+        }
+    }
+    CB_ENSURE_INTERNAL(valueIdx == values.size(), "Too many values for nonempty buckets");
+}
+
+int TStats3D::operator&(IBinSaver& binSaver) {
+    binSaver.AddMulti(BucketCount, MaxLeafCount, SplitEnsembleSpec, SaveStatsAsFloat);
+
+    ui64 statCount = Stats.size();
+    binSaver.Add(0, &statCount);
+    TVector<ui64> nonEmptyMask;
+    if (binSaver.IsReading()) {
+        binSaver.Add(0, &nonEmptyMask);
+        CB_ENSURE_INTERNAL(nonEmptyMask.size() == CeilDiv<ui64>(statCount, 64), "Wrong size of nonempty buckets mask");
+        Stats.yresize(statCount);
+        if (SaveStatsAsFloat) {
+            LoadNonEmptyBucketStats<float>(nonEmptyMask, Stats, &binSaver);
+        } else {
+            LoadNonEmptyBucketStats<double>(nonEmptyMask, Stats, &binSaver);
+        }
+    } else {
+        nonEmptyMask.resize(CeilDiv<ui64>(statCount, 64), 0);
+        for (auto statIdx : xrange(Stats.size())) {
+            const auto& bucket = Stats[statIdx];
+            if (bucket.SumWeightedDelta != 0 || bucket.SumWeight != 0 || bucket.SumDelta != 0 || bucket.Count != 0) {
+                nonEmptyMask[statIdx / 64] |= 1ull << (statIdx % 64);
+            }
+        }
+        binSaver.Add(0, &nonEmptyMask);
+        if (SaveStatsAsFloat) {
+            SaveNonEmptyBucketStats<float>(Stats, nonEmptyMask, &binSaver);
+        } else {
+            SaveNonEmptyBucketStats<double>(Stats, nonEmptyMask, &binSaver);
+        }
+    }
+    return 0;
+}
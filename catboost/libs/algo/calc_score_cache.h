@@ -331,8 +331,14 @@ struct TStats3D {
 
     TSplitEnsembleSpec SplitEnsembleSpec;
 
+    // used only for sending between hosts, see TSystemOptions::ExchangeStatsInFloat
+    bool SaveStatsAsFloat = false;
+
 public:
-    SAVELOAD(Stats, BucketCount, MaxLeafCount, SplitEnsembleSpec);
+    /* Empty buckets are skipped: only a bitmask of nonempty buckets and their stats are saved,
+     * bucket stats are saved as float if SaveStatsAsFloat is set
+     */
+    int operator&(IBinSaver& binSaver);
 
     void Add(const TStats3D& stats3D);
 };
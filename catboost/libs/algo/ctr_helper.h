@@ -19,7 +19,8 @@ struct TCtrInfo {
     TVector<float> Priors;
 
 public:
-    Y_SAVELOAD_DEFINE(Type, BorderCount, TargetClassifierIdx, Priors);
+    // sent to workers in distributed training with online ctrs
+    SAVELOAD(Type, BorderCount, TargetClassifierIdx, Priors);
 };
 
 inline int GetTargetBorderCount(const TCtrInfo& ctrInfo, ui32 targetClassesCount) {
@@ -56,8 +57,6 @@ public:
         return TargetClassifiers;
     }
 
-    Y_SAVELOAD_DEFINE(TargetClassifiers, SimpleCtrs, PerFeatureCtrs, TreeCtrs)
-
 private:
     TVector<TTargetClassifier> TargetClassifiers;
 
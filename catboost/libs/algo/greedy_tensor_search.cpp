@@ -553,6 +553,7 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
             * CalcDerivativesStDevFromZero(*fold, ctx->Params.BoostingOptions->BoostingType)
             * CalcDerivativesStDevFromZeroMultiplier(learnSampleCount, modelLength);
         if (!ctx->Params.SystemOptions->IsSingleHost()) {
+            MapCalcOnlineCtrs(data, candList, ctx);
             if (isPairwiseScoring) {
                 MapRemotePairwiseCalcScore(scoreStDev, perPackMasks, &candList, ctx);
             } else {
@@ -584,7 +585,9 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
             }
         }
 
-        fold->DropEmptyCTRs();
+        if (ctx->Params.SystemOptions->IsSingleHost()) {
+            fold->DropEmptyCTRs();
+        } // else master keeps only unique values counts of ctrs computed on workers
         CheckInterrupted(); // check after long-lasting operation
         profile.AddOperation(TStringBuilder() << "Calc scores " << curDepth);
 
@@ -631,7 +634,8 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
         }
         TSplit bestSplit = bestSplitCandidate->GetBestSplit(*data.Learn->ObjectsData);
 
-        if (bestSplit.Type == ESplitType::OnlineCtr) {
+        // in distributed mode workers already have ctr values, master computes them after the tree is built
+        if (bestSplit.Type == ESplitType::OnlineCtr && ctx->Params.SystemOptions->IsSingleHost()) {
             const auto& proj = bestSplit.Ctr.Projection;
             if (fold->GetCtrRef(proj).Feature.empty()) {
                 ComputeOnlineCTRs(data,
@@ -645,6 +649,7 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
             }
         }
 
+        int redundantIdx = -1;
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             SetPermutedIndices(bestSplit, *data.Learn->ObjectsData, curDepth + 1, *fold, &indices, ctx->LocalExecutor);
             if (isSamplingPerTree) {
@@ -653,21 +658,15 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
                     ctx->SmallestSplitSideDocs.SelectSmallestSplitSide(curDepth + 1, ctx->SampledDocs, ctx->LocalExecutor);
                 }
             }
+            redundantIdx = GetRedundantSplitIdx(GetIsLeafEmpty(curDepth + 1, indices));
         } else {
-            Y_ASSERT(bestSplit.Type != ESplitType::OnlineCtr);
-            MapSetIndices(bestSplit, ctx);
+            redundantIdx = MapSetIndicesAndGetRedundantSplitIdx(bestSplit, ctx);
         }
         currentSplitTree.AddSplit(bestSplit);
         CATBOOST_INFO_LOG << BuildDescription(*ctx->Layout, bestSplit) << " score " << bestScore << "\n";
 
         profile.AddOperation(TStringBuilder() << "Select best split " << curDepth);
 
-        int redundantIdx = -1;
-        if (ctx->Params.SystemOptions->IsSingleHost()) {
-            redundantIdx = GetRedundantSplitIdx(GetIsLeafEmpty(curDepth + 1, indices));
-        } else {
-            redundantIdx = MapGetRedundantSplitIdx(ctx);
-        }
         if (redundantIdx != -1) {
             currentSplitTree.DeleteSplit(redundantIdx);
             CATBOOST_INFO_LOG << "  tensor " << redundantIdx << " is redundant, remove it and stop\n";
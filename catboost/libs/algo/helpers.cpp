@@ -97,22 +97,26 @@ void CalcErrors(
                 auto queryInfo = targetData->GetGroupInfo().GetOrElse(TConstArrayRef<TQueryInfo>());
 
                 TVector<bool> skipMetricOnTrain = GetSkipMetricOnTrain(errors);
+                TVector<const IMetric*> learnMetrics;
                 for (int i = 0; i < errors.ysize(); ++i) {
                     if (!skipMetricOnTrain[i]) {
-                        const auto& additiveStats = EvalErrors(
-                            ctx->LearnProgress.AvrgApprox,
-                            target,
-                            weights,
-                            queryInfo,
-                            errors[i],
-                            ctx->LocalExecutor
-                        );
-                        ctx->LearnProgress.MetricsAndTimeHistory.AddLearnError(
-                            *errors[i].Get(),
-                            errors[i]->GetFinalError(additiveStats)
-                        );
+                        learnMetrics.push_back(errors[i].Get());
                     }
                 }
+                const auto additiveStats = EvalErrors(
+                    ctx->LearnProgress.AvrgApprox,
+                    target,
+                    weights,
+                    queryInfo,
+                    learnMetrics,
+                    ctx->LocalExecutor
+                );
+                for (auto metricIdx : xrange(learnMetrics.size())) {
+                    ctx->LearnProgress.MetricsAndTimeHistory.AddLearnError(
+                        *learnMetrics[metricIdx],
+                        learnMetrics[metricIdx]->GetFinalError(additiveStats[metricIdx])
+                    );
+                }
             } else {
                 MapCalcErrors(ctx);
             }
@@ -141,6 +145,8 @@ void CalcErrors(
             auto queryInfo = targetData->GetGroupInfo().GetOrElse(TConstArrayRef<TQueryInfo>());;
 
             const auto& testApprox = ctx->LearnProgress.TestApprox[testIdx];
+            TVector<const IMetric*> testMetrics;
+            TVector<int> testMetricErrorIndices;
             for (int i = 0; i < errors.ysize(); ++i) {
                 if (!calcAllMetrics && (i != errorTrackerMetricIdx)) {
                     continue;
@@ -148,20 +154,24 @@ void CalcErrors(
                 if (!maybeTarget && errors[i]->NeedTarget()) {
                     continue;
                 }
+                testMetrics.push_back(errors[i].Get());
+                testMetricErrorIndices.push_back(i);
+            }
 
-                const auto& additiveStats = EvalErrors(
-                    testApprox,
-                    target,
-                    weights,
-                    queryInfo,
-                    errors[i],
-                    ctx->LocalExecutor
-                );
-                bool updateBestIteration = (i == 0) && (testIdx == trainingDataProviders.Test.size() - 1);
+            const auto additiveStats = EvalErrors(
+                testApprox,
+                target,
+                weights,
+                queryInfo,
+                testMetrics,
+                ctx->LocalExecutor
+            );
+            for (auto metricIdx : xrange(testMetrics.size())) {
+                bool updateBestIteration = (testMetricErrorIndices[metricIdx] == 0) && (testIdx == trainingDataProviders.Test.size() - 1);
                 ctx->LearnProgress.MetricsAndTimeHistory.AddTestError(
                     testIdx,
-                    *errors[i].Get(),
-                    errors[i]->GetFinalError(additiveStats),
+                    *testMetrics[metricIdx],
+                    testMetrics[metricIdx]->GetFinalError(additiveStats[metricIdx]),
                     updateBestIteration
                 );
             }
@@ -22,6 +22,7 @@
 
 #include <library/par/par.h>
 
+#include <util/datetime/base.h>
 #include <util/generic/noncopyable.h>
 #include <util/generic/hash_set.h>
 
@@ -138,6 +139,8 @@ public:
     TBucketStatsCache PrevTreeLevelStats;
     TObj<NPar::IRootEnvironment> RootEnvironment;
     TObj<NPar::IEnvironment> SharedTrainData;
+    TDuration WorkerResponseTimeout = TDuration::Zero(); // unlimited
+    bool HasUnresponsiveWorkers = false; // master must not wait for workers when stopping
     TProfileInfo Profile;
 
 private:
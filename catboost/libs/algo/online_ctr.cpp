@@ -11,7 +11,9 @@
 #include <catboost/libs/model/model.h>
 
 #include <util/generic/bitops.h>
+#include <util/generic/hash.h>
 #include <util/generic/utility.h>
+#include <util/generic/xrange.h>
 #include <util/system/mem_info.h>
 #include <util/thread/singleton.h>
 
@@ -116,6 +118,7 @@ static void CalcOnlineCTRClasses(
     const TVector<ui64>& enumeratedCatFeatures,
     size_t leafCount,
     const TVector<int>& permutedTargetClass,
+    TConstArrayRef<int> initialClassCounts, // [leaf * targetClassesCount + class], can be empty
     int targetClassesCount,
     int targetBorderCount,
     const TVector<float>& priors,
@@ -132,6 +135,15 @@ static void CalcOnlineCTRClasses(
     TVector<int> totalCountByDoc(blockSize);
     TVector<TVector<int>> goodCountByBorderByDoc(targetBorderCount, TVector<int>(blockSize));
     TBucketsView bv(leafCount, targetClassesCount);
+    if (!initialClassCounts.empty()) {
+        for (size_t leaf = 0; leaf < leafCount; ++leaf) {
+            auto bordersData = bv.GetBorders(leaf);
+            for (int classIdx = 0; classIdx < targetClassesCount; ++classIdx) {
+                bordersData[classIdx] = initialClassCounts[leaf * targetClassesCount + classIdx];
+                bv.GetTotal(leaf) += bordersData[classIdx];
+            }
+        }
+    }
 
     auto calcGoodCounts = [&](int blockStart, int nextBlockStart, int docOffset) {
         for (int docId = blockStart; docId < nextBlockStart; ++docId) {
@@ -187,6 +199,7 @@ static void CalcOnlineCTRSimple(
     const TVector<ui64>& enumeratedCatFeatures,
     size_t leafCount,
     const TVector<int>& permutedTargetClass,
+    TConstArrayRef<int> initialClassCounts, // [leaf * SIMPLE_CLASSES_COUNT + class], can be empty
     const TVector<float>& priors,
     int ctrBorderCount,
     TArray2D<TVector<ui8>>* feature) {
@@ -199,6 +212,13 @@ static void CalcOnlineCTRSimple(
     auto ctrArrSimple = TCtrCalcer::GetCtrHistoryArr(leafCount + blockSize);
     auto totalCount = reinterpret_cast<int*>(ctrArrSimple.data() + leafCount);
     auto goodCount = totalCount + blockSize;
+    if (!initialClassCounts.empty()) {
+        for (size_t leaf = 0; leaf < leafCount; ++leaf) {
+            for (int classIdx = 0; classIdx < SIMPLE_CLASSES_COUNT; ++classIdx) {
+                ctrArrSimple[leaf].N[classIdx] = initialClassCounts[leaf * SIMPLE_CLASSES_COUNT + classIdx];
+            }
+        }
+    }
 
     auto calcGoodCount = [&](int blockStart, int nextBlockStart, int docOffset) {
         for (int docId = blockStart; docId < nextBlockStart; ++docId) {
@@ -244,6 +264,7 @@ static void CalcOnlineCTRMean(
     const TVector<ui64>& enumeratedCatFeatures,
     size_t leafCount,
     const TVector<int>& permutedTargetClass,
+    TConstArrayRef<int> initialClassCounts, // [leaf * (targetBorderCount + 1) + class], can be empty
     int targetBorderCount,
     const TVector<float>& priors,
     int ctrBorderCount,
@@ -257,6 +278,17 @@ static void CalcOnlineCTRMean(
     TVector<float> sum(blockSize);
     TVector<int> count(blockSize);
     auto ctrArrMean = TCtrCalcer::GetCtrMeanHistoryArr(leafCount);
+    if (!initialClassCounts.empty()) {
+        // sums are accumulated in other order than in sequential pass, so they can differ in last bits
+        const int targetClassesCount = targetBorderCount + 1;
+        for (size_t leaf = 0; leaf < leafCount; ++leaf) {
+            for (int classIdx = 0; classIdx < targetClassesCount; ++classIdx) {
+                const int count = initialClassCounts[leaf * targetClassesCount + classIdx];
+                ctrArrMean[leaf].Sum += count * (static_cast<float>(classIdx) / targetBorderCount);
+                ctrArrMean[leaf].Count += count;
+            }
+        }
+    }
 
     auto calcCount = [&](int blockStart, int nextBlockStart, int docOffset) {
         for (int docId = blockStart; docId < nextBlockStart; ++docId) {
@@ -358,6 +390,143 @@ static inline void CountOnlineCTRTotal(
     }
 }
 
+static void CalcProjectionHashes(
+    const TQuantizedForCPUObjectsDataProvider& objectsData,
+    const TFeaturesArraySubsetIndexing& featuresSubsetIndexing,
+    const TProjection& proj,
+    TArrayRef<ui64> hashArr // must be zero-filled
+) {
+    if (hashArr.empty()) {
+        return;
+    }
+    if (proj.IsSingleCatFeature()) {
+        // Shortcut for simple ctrs
+        auto catFeatureIdx = TCatFeatureIdx((ui32)proj.CatFeatures[0]);
+        ProcessFeatureForCalcHashes<IQuantizedCatValuesHolder>(
+            objectsData.GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
+            featuresSubsetIndexing,
+            /*processBinaryInPacks*/ false,
+            /*isBinaryFeatureEquals1*/ false, // unused
+            TArrayRef<TBinaryFeaturesPack>(), // unused
+            TArrayRef<TBinaryFeaturesPack>(), // unused
+            [&]() { return *objectsData.GetCatFeature(*catFeatureIdx); },
+            [&](ui32 packIdx) { return objectsData.GetBinaryFeaturesPack(packIdx); },
+            [hashArr] (ui32 i, ui32 featureValue) {
+                hashArr[i] = (ui64)featureValue + 1;
+            }
+        );
+    } else {
+        CalcHashes(
+            proj,
+            objectsData,
+            featuresSubsetIndexing,
+            nullptr,
+            /*processBinaryFeaturesInPacks*/ true,
+            hashArr.begin(),
+            hashArr.end());
+    }
+}
+
+static bool HasCounterCtrs(TConstArrayRef<TCtrInfo> ctrInfo) {
+    return AnyOf(ctrInfo, [] (const auto& info) { return info.Type == ECtrType::Counter; });
+}
+
+// class count of each target classifier used by ctrs, 0 for unused classifiers
+static TVector<int> GetUsedClassesCounts(TConstArrayRef<TCtrInfo> ctrInfo, TConstArrayRef<int> targetClassesCount) {
+    TVector<int> usedClassesCounts(targetClassesCount.size(), 0);
+    for (const auto& info : ctrInfo) {
+        if (info.Type != ECtrType::Counter) {
+            usedClassesCounts[info.TargetClassifierIdx] = targetClassesCount[info.TargetClassifierIdx];
+        }
+    }
+    return usedClassesCounts;
+}
+
+static void CalcOnlineCTRsFromHashes(
+    const TVector<size_t>& testOffsets,
+    const TVector<ui64>& enumeratedCatFeatures, // reindexed hashes of learn and test objects
+    size_t leafCount,
+    const TFold& fold,
+    TConstArrayRef<TCtrInfo> ctrInfo,
+    const TVector<int>& counterCTRTotal, // [leaf], used only for Counter ctrs
+    int counterCTRDenominator,
+    TConstArrayRef<TVector<int>> initialClassCounts, // [targetClassifierIdx], can be empty
+    TOnlineCTR* dst
+) {
+    const size_t totalSampleCount = testOffsets.back();
+    dst->Feature.resize(ctrInfo.size());
+    for (int ctrIdx = 0; ctrIdx < dst->Feature.ysize(); ++ctrIdx) {
+        const ECtrType ctrType = ctrInfo[ctrIdx].Type;
+        const ui32 classifierId = ctrInfo[ctrIdx].TargetClassifierIdx;
+        int targetClassesCount = fold.TargetClassesCount[classifierId];
+
+        const ui32 targetBorderCount = GetTargetBorderCount(ctrInfo[ctrIdx], targetClassesCount);
+        const ui32 ctrBorderCount = ctrInfo[ctrIdx].BorderCount;
+        const auto& priors = ctrInfo[ctrIdx].Priors;
+        dst->Feature[ctrIdx].SetSizes(priors.size(), targetBorderCount);
+
+        for (ui32 border = 0; border < targetBorderCount; ++border) {
+            for (int prior = 0; prior < priors.ysize(); ++prior) {
+                Clear(&dst->Feature[ctrIdx][border][prior], totalSampleCount);
+            }
+        }
+
+        TConstArrayRef<int> ctrInitialClassCounts;
+        if (ctrType != ECtrType::Counter && !initialClassCounts.empty()) {
+            ctrInitialClassCounts = initialClassCounts[classifierId];
+        }
+
+        if (ctrType == ECtrType::Borders && targetClassesCount == SIMPLE_CLASSES_COUNT) {
+            CalcOnlineCTRSimple(
+                testOffsets,
+                enumeratedCatFeatures,
+                leafCount,
+                fold.LearnTargetClass[classifierId],
+                ctrInitialClassCounts,
+                priors,
+                ctrBorderCount,
+                &dst->Feature[ctrIdx]);
+
+        } else if (ctrType == ECtrType::BinarizedTargetMeanValue) {
+            CalcOnlineCTRMean(
+                testOffsets,
+                enumeratedCatFeatures,
+                leafCount,
+                fold.LearnTargetClass[classifierId],
+                ctrInitialClassCounts,
+                targetClassesCount - 1,
+                priors,
+                ctrBorderCount,
+                &dst->Feature[ctrIdx]);
+
+        } else if (ctrType == ECtrType::Buckets ||
+                   (ctrType == ECtrType::Borders && targetClassesCount > SIMPLE_CLASSES_COUNT)) {
+            CalcOnlineCTRClasses(
+                testOffsets,
+                enumeratedCatFeatures,
+                leafCount,
+                fold.LearnTargetClass[classifierId],
+                ctrInitialClassCounts,
+                targetClassesCount,
+                GetTargetBorderCount(ctrInfo[ctrIdx], targetClassesCount),
+                priors,
+                ctrBorderCount,
+                ctrType,
+                &dst->Feature[ctrIdx]);
+        } else {
+            Y_ASSERT(ctrType == ECtrType::Counter);
+            CalcOnlineCTRCounter(
+                testOffsets,
+                counterCTRTotal,
+                enumeratedCatFeatures,
+                counterCTRDenominator,
+                priors,
+                ctrBorderCount,
+                &dst->Feature[ctrIdx]);
+        }
+    }
+}
+
 void ComputeOnlineCTRs(
     const TTrainingForCPUDataProviders& data,
     const TFold& fold,
@@ -367,7 +536,6 @@ void ComputeOnlineCTRs(
 
     const TCtrHelper& ctrHelper = ctx->CtrsHelper;
     const auto& ctrInfo = ctrHelper.GetCtrInfo(proj);
-    dst->Feature.resize(ctrInfo.size());
     size_t learnSampleCount = data.Learn->GetObjectCount();
     const TVector<size_t>& testOffsets = data.CalcTestOffsets();
     size_t totalSampleCount = learnSampleCount + data.GetTestSampleCount();
@@ -379,78 +547,29 @@ void ComputeOnlineCTRs(
     Y_STATIC_THREAD(THashArr) tlsHashArr;
     Y_STATIC_THREAD(TRehashHash) rehashHashTlsVal;
     TVector<ui64>& hashArr = tlsHashArr.Get();
+    Clear(&hashArr, totalSampleCount);
+    CalcProjectionHashes(
+        *data.Learn->ObjectsData,
+        fold.LearnPermutationFeaturesSubset,
+        proj,
+        MakeArrayRef(hashArr.data(), learnSampleCount));
+    for (size_t docOffset = learnSampleCount, testIdx = 0;
+         docOffset < totalSampleCount && testIdx < data.Test.size();
+         ++testIdx)
+    {
+        const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
+        CalcProjectionHashes(
+            *data.Test[testIdx]->ObjectsData,
+            data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
+            proj,
+            MakeArrayRef(hashArr.data() + docOffset, testSampleCount));
+        docOffset += testSampleCount;
+    }
     if (proj.IsSingleCatFeature()) {
-        // Shortcut for simple ctrs
-
-        auto catFeatureIdx = TCatFeatureIdx((ui32)proj.CatFeatures[0]);
-
-        Clear(&hashArr, totalSampleCount);
-        TArrayRef<ui64> hashArrView = hashArr;
-        if (learnSampleCount > 0) {
-            ProcessFeatureForCalcHashes<IQuantizedCatValuesHolder>(
-                data.Learn->ObjectsData->GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
-                fold.LearnPermutationFeaturesSubset,
-                /*processBinaryInPacks*/ false,
-                /*isBinaryFeatureEquals1*/ false, // unused
-                TArrayRef<TBinaryFeaturesPack>(), // unused
-                TArrayRef<TBinaryFeaturesPack>(), // unused
-                [&]() { return *data.Learn->ObjectsData->GetCatFeature(*catFeatureIdx); },
-                [&](ui32 packIdx) { return data.Learn->ObjectsData->GetBinaryFeaturesPack(packIdx); },
-                [hashArrView] (ui32 i, ui32 featureValue) {
-                    hashArrView[i] = (ui64)featureValue + 1;
-                }
-            );
-        }
-        for (size_t docOffset = learnSampleCount, testIdx = 0;
-             docOffset < totalSampleCount && testIdx < data.Test.size();
-             ++testIdx)
-        {
-            const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
-
-            ProcessFeatureForCalcHashes<IQuantizedCatValuesHolder>(
-                data.Test[testIdx]->ObjectsData->GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
-                data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
-                /*processBinaryInPacks*/ false,
-                /*isBinaryFeatureEquals1*/ false, // unused
-                TArrayRef<TBinaryFeaturesPack>(), // unused
-                TArrayRef<TBinaryFeaturesPack>(), // unused
-                [&]() { return *data.Test[testIdx]->ObjectsData->GetCatFeature(*catFeatureIdx); },
-                [&](ui32 packIdx) { return data.Test[testIdx]->ObjectsData->GetBinaryFeaturesPack(packIdx); },
-                [hashArrView, docOffset] (ui32 i, ui32 featureValue) {
-                    hashArrView[docOffset + i] = (ui64)featureValue + 1;
-                }
-            );
-
-            docOffset += testSampleCount;
-        }
         rehashHashTlsVal.Get().MakeEmpty(
             quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(proj.CatFeatures[0])).OnLearnOnly
         );
     } else {
-        Clear(&hashArr, totalSampleCount);
-        CalcHashes(
-            proj,
-            *data.Learn->ObjectsData,
-            fold.LearnPermutationFeaturesSubset,
-            nullptr,
-            /*processBinaryFeaturesInPacks*/ true,
-            hashArr.begin(),
-            hashArr.begin() + learnSampleCount);
-        for (size_t docOffset = learnSampleCount, testIdx = 0;
-             docOffset < totalSampleCount && testIdx < data.Test.size();
-             ++testIdx)
-        {
-            const size_t testSampleCount = data.Test[testIdx]->GetObjectCount();
-            CalcHashes(
-                proj,
-                *data.Test[testIdx]->ObjectsData,
-                data.Test[testIdx]->ObjectsData->GetFeaturesArraySubsetIndexing(),
-                nullptr,
-                /*processBinaryFeaturesInPacks*/ true,
-                hashArr.begin() + docOffset,
-                hashArr.begin() + docOffset + testSampleCount);
-            docOffset += testSampleCount;
-        }
         size_t approxBucketsCount = 1;
         for (auto cf : proj.CatFeatures) {
             approxBucketsCount *= quantizedFeaturesInfo.GetUniqueValuesCounts(TCatFeatureIdx(cf)).OnLearnOnly;
@@ -485,11 +604,7 @@ void ComputeOnlineCTRs(
 
     TVector<int> counterCTRTotal;
     int counterCTRDenominator = 0;
-    if (AnyOf(
-            ctrInfo.begin(),
-            ctrInfo.begin() + dst->Feature.ysize(),
-            [] (const auto& info) { return info.Type == ECtrType::Counter; }))
-    {
+    if (HasCounterCtrs(ctrInfo)) {
         counterCTRTotal.resize(leafCount);
         int sampleCount = learnSampleCount;
         if (ctx->Params.CatFeatureParams->CounterCalcMethod == ECounterCalc::Full) {
@@ -500,68 +615,198 @@ void ComputeOnlineCTRs(
         counterCTRDenominator = *MaxElement(counterCTRTotal.begin(), counterCTRTotal.end());
     }
 
-    for (int ctrIdx = 0; ctrIdx < dst->Feature.ysize(); ++ctrIdx) {
-        const ECtrType ctrType = ctrInfo[ctrIdx].Type;
-        const ui32 classifierId = ctrInfo[ctrIdx].TargetClassifierIdx;
-        int targetClassesCount = fold.TargetClassesCount[classifierId];
-
-        const ui32 targetBorderCount = GetTargetBorderCount(ctrInfo[ctrIdx], targetClassesCount);
-        const ui32 ctrBorderCount = ctrInfo[ctrIdx].BorderCount;
-        const auto& priors = ctrInfo[ctrIdx].Priors;
-        dst->Feature[ctrIdx].SetSizes(priors.size(), targetBorderCount);
+    CalcOnlineCTRsFromHashes(
+        testOffsets,
+        hashArr,
+        leafCount,
+        fold,
+        ctrInfo,
+        counterCTRTotal,
+        counterCTRDenominator,
+        /*initialClassCounts*/ {},
+        dst);
+}
 
-        for (ui32 border = 0; border < targetBorderCount; ++border) {
-            for (int prior = 0; prior < priors.ysize(); ++prior) {
-                Clear(&dst->Feature[ctrIdx][border][prior], totalSampleCount);
-            }
+// reindexes hashes of learn part objects to leaves in order of first appearance, returns hash of each leaf
+static TVector<ui64> CalcLearnPartLeaves(
+    const TQuantizedForCPUObjectsDataProvider& objectsData,
+    const TFold& fold,
+    const TProjection& proj,
+    TVector<ui64>* hashArr
+) {
+    Clear(hashArr, fold.GetLearnSampleCount());
+    CalcProjectionHashes(objectsData, fold.LearnPermutationFeaturesSubset, proj, *hashArr);
+
+    TVector<ui64> leafHashes;
+    THashMap<ui64, ui32> reindexHash;
+    for (auto& hash : *hashArr) {
+        const auto [it, isNew] = reindexHash.emplace(hash, leafHashes.size());
+        if (isNew) {
+            leafHashes.push_back(hash);
         }
+        hash = it->second;
+    }
+    return leafHashes;
+}
 
-        if (ctrType == ECtrType::Borders && targetClassesCount == SIMPLE_CLASSES_COUNT) {
-            CalcOnlineCTRSimple(
-                testOffsets,
-                hashArr,
-                leafCount,
-                fold.LearnTargetClass[classifierId],
-                priors,
-                ctrBorderCount,
-                &dst->Feature[ctrIdx]);
+TOnlineCtrPartStats CalcOnlineCtrPartStats(
+    const TQuantizedForCPUObjectsDataProvider& learnPartObjectsData,
+    const TFold& fold,
+    const TProjection& proj,
+    TConstArrayRef<TCtrInfo> ctrInfo
+) {
+    TVector<ui64> hashArr;
+    TOnlineCtrPartStats stats;
+    stats.Hashes = CalcLearnPartLeaves(learnPartObjectsData, fold, proj, &hashArr);
+    const size_t leafCount = stats.Hashes.size();
+
+    stats.TotalCounts.resize(leafCount, 0);
+    for (auto leaf : hashArr) {
+        ++stats.TotalCounts[leaf];
+    }
 
-        } else if (ctrType == ECtrType::BinarizedTargetMeanValue) {
-            CalcOnlineCTRMean(
-                testOffsets,
-                hashArr,
-                leafCount,
-                fold.LearnTargetClass[classifierId],
-                targetClassesCount - 1,
-                priors,
-                ctrBorderCount,
-                &dst->Feature[ctrIdx]);
+    const auto usedClassesCounts = GetUsedClassesCounts(ctrInfo, fold.TargetClassesCount);
+    stats.ClassCounts.resize(usedClassesCounts.size());
+    for (auto classifierIdx : xrange(usedClassesCounts.size())) {
+        const int classCount = usedClassesCounts[classifierIdx];
+        if (classCount == 0) {
+            continue;
+        }
+        const auto& targetClass = fold.LearnTargetClass[classifierIdx];
+        auto& classCounts = stats.ClassCounts[classifierIdx];
+        classCounts.resize(leafCount * classCount, 0);
+        for (auto objectIdx : xrange(hashArr.size())) {
+            ++classCounts[hashArr[objectIdx] * classCount + targetClass[objectIdx]];
+        }
+    }
+    return stats;
+}
 
-        } else if (ctrType == ECtrType::Buckets ||
-                   (ctrType == ECtrType::Borders && targetClassesCount > SIMPLE_CLASSES_COUNT)) {
-            CalcOnlineCTRClasses(
-                testOffsets,
-                hashArr,
-                leafCount,
-                fold.LearnTargetClass[classifierId],
-                targetClassesCount,
-                GetTargetBorderCount(ctrInfo[ctrIdx], targetClassesCount),
-                priors,
-                ctrBorderCount,
-                ctrType,
-                &dst->Feature[ctrIdx]);
-        } else {
-            Y_ASSERT(ctrType == ECtrType::Counter);
-            CalcOnlineCTRCounter(
-                testOffsets,
-                counterCTRTotal,
-                hashArr,
-                counterCTRDenominator,
-                priors,
-                ctrBorderCount,
-                &dst->Feature[ctrIdx]);
+TVector<TOnlineCtrPartPrefix> MergeOnlineCtrPartStats(
+    const TTrainingForCPUDataProviders& data,
+    const TProjection& proj,
+    TConstArrayRef<TCtrInfo> ctrInfo,
+    TConstArrayRef<int> targetClassesCount,
+    ECounterCalc counterCalcMethod,
+    TConstArrayRef<TOnlineCtrPartStats> partsStats,
+    size_t* uniqueValuesCount,
+    size_t* counterUniqueValuesCount
+) {
+    const auto classCountsPerClassifier = GetUsedClassesCounts(ctrInfo, targetClassesCount);
+
+    // counts of objects from already processed parts
+    THashMap<ui64, ui32> hashToLeaf;
+    TVector<int> totalCounts; // [leaf]
+    TVector<TVector<int>> classCounts(classCountsPerClassifier.size()); // [targetClassifierIdx][leaf * classCount + class]
+
+    TVector<TOnlineCtrPartPrefix> prefixes(partsStats.size());
+    for (auto partIdx : xrange(partsStats.size())) {
+        const auto& partStats = partsStats[partIdx];
+        auto& prefix = prefixes[partIdx];
+        const size_t partLeafCount = partStats.Hashes.size();
+        CB_ENSURE_INTERNAL(
+            partStats.TotalCounts.size() == partLeafCount && partStats.ClassCounts.size() == classCounts.size(),
+            "Stats of learn data part have wrong size");
+
+        TVector<ui32> partLeafToLeaf(partLeafCount);
+        prefix.TotalCounts.resize(partLeafCount, 0);
+        for (auto partLeaf : xrange(partLeafCount)) {
+            const auto [it, isNew] = hashToLeaf.emplace(partStats.Hashes[partLeaf], totalCounts.size());
+            if (isNew) {
+                totalCounts.push_back(0);
+                for (auto classifierIdx : xrange(classCounts.size())) {
+                    classCounts[classifierIdx].resize(
+                        classCounts[classifierIdx].size() + classCountsPerClassifier[classifierIdx],
+                        0);
+                }
+            }
+            partLeafToLeaf[partLeaf] = it->second;
+            prefix.TotalCounts[partLeaf] = totalCounts[it->second];
+            totalCounts[it->second] += partStats.TotalCounts[partLeaf];
+        }
+
+        prefix.ClassCounts.resize(classCounts.size());
+        for (auto classifierIdx : xrange(classCounts.size())) {
+            const int classCount = classCountsPerClassifier[classifierIdx];
+            if (classCount == 0) {
+                continue;
+            }
+            const auto& partClassCounts = partStats.ClassCounts[classifierIdx];
+            CB_ENSURE_INTERNAL(
+                partClassCounts.size() == partLeafCount * classCount,
+                "Class counts of learn data part have wrong size");
+            auto& prefixClassCounts = prefix.ClassCounts[classifierIdx];
+            prefixClassCounts.resize(partLeafCount * classCount);
+            for (auto partLeaf : xrange(partLeafCount)) {
+                int* leafClassCounts = classCounts[classifierIdx].data() + partLeafToLeaf[partLeaf] * classCount;
+                for (auto classIdx : xrange(classCount)) {
+                    prefixClassCounts[partLeaf * classCount + classIdx] = leafClassCounts[classIdx];
+                    leafClassCounts[classIdx] += partClassCounts[partLeaf * classCount + classIdx];
+                }
+            }
         }
     }
+    *uniqueValuesCount = *counterUniqueValuesCount = totalCounts.size();
+
+    if (HasCounterCtrs(ctrInfo)) {
+        if (counterCalcMethod == ECounterCalc::Full) {
+            for (const auto& testData : data.Test) {
+                TVector<ui64> hashArr;
+                Clear(&hashArr, testData->GetObjectCount());
+                CalcProjectionHashes(
+                    *testData->ObjectsData,
+                    testData->ObjectsData->GetFeaturesArraySubsetIndexing(),
+                    proj,
+                    hashArr);
+                for (auto hash : hashArr) {
+                    const auto [it, isNew] = hashToLeaf.emplace(hash, totalCounts.size());
+                    if (isNew) {
+                        totalCounts.push_back(0);
+                    }
+                    ++totalCounts[it->second];
+                }
+            }
+            *counterUniqueValuesCount = totalCounts.size();
+        }
+        const int counterDenominator = *MaxElement(totalCounts.begin(), totalCounts.end());
+        for (auto partIdx : xrange(partsStats.size())) {
+            const auto& partHashes = partsStats[partIdx].Hashes;
+            auto& prefix = prefixes[partIdx];
+            prefix.CounterTotals.yresize(partHashes.size());
+            for (auto partLeaf : xrange(partHashes.size())) {
+                prefix.CounterTotals[partLeaf] = totalCounts[hashToLeaf.at(partHashes[partLeaf])];
+            }
+            prefix.CounterDenominator = counterDenominator;
+        }
+    }
+    return prefixes;
+}
+
+void ComputeOnlineCTRsForLearnPart(
+    const TQuantizedForCPUObjectsDataProvider& learnPartObjectsData,
+    const TFold& fold,
+    const TProjection& proj,
+    TConstArrayRef<TCtrInfo> ctrInfo,
+    const TOnlineCtrPartPrefix& prefix,
+    TOnlineCTR* dst
+) {
+    TVector<ui64> hashArr;
+    const size_t leafCount = CalcLearnPartLeaves(learnPartObjectsData, fold, proj, &hashArr).size();
+    CB_ENSURE_INTERNAL(
+        prefix.TotalCounts.size() == leafCount,
+        "Counts of preceding objects don't match leaves of learn data part");
+    dst->CounterUniqueValuesCount = dst->UniqueValuesCount = leafCount;
+
+    CalcOnlineCTRsFromHashes(
+        /*testOffsets*/ {hashArr.size()},
+        hashArr,
+        leafCount,
+        fold,
+        ctrInfo,
+        prefix.CounterTotals,
+        prefix.CounterDenominator,
+        prefix.ClassCounts,
+        dst);
 }
 
 void CalcFinalCtrsImpl(
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ctr_helper.h"
 #include "index_hash_calcer.h"
 #include "projection.h"
 #include "target_classifier.h"
@@ -61,6 +62,62 @@ void ComputeOnlineCTRs(
     TOnlineCTR* dst
 );
 
+/* Online ctrs for a learn dataset split into contiguous parts (used in distributed training where each
+ * worker has one part): CalcOnlineCtrPartStats is called for each part, MergeOnlineCtrPartStats collects
+ * counts of objects from preceding parts for each of them, and ComputeOnlineCTRsForLearnPart computes
+ * ctr values of the part as if all preceding parts were processed before it.
+ * Learn objects must not be permuted, ctr leaf count limit is not supported.
+ */
+
+// counts of objects with each hash value of projection in a learn data part
+struct TOnlineCtrPartStats {
+    TVector<ui64> Hashes; // [leaf], leaves are in order of first appearance in the part
+    TVector<int> TotalCounts; // [leaf]
+    TVector<TVector<int>> ClassCounts; // [targetClassifierIdx][leaf * classCount + class], empty if unused by ctrs
+
+public:
+    SAVELOAD(Hashes, TotalCounts, ClassCounts);
+};
+
+// counts of objects from preceding learn data parts for leaves of a part
+struct TOnlineCtrPartPrefix {
+    TVector<int> TotalCounts; // [leaf]
+    TVector<TVector<int>> ClassCounts; // [targetClassifierIdx][leaf * classCount + class], empty if unused by ctrs
+    TVector<int> CounterTotals; // [leaf], counts in all learn parts (and test if counter_calc_method == Full)
+    int CounterDenominator = 0;
+
+public:
+    SAVELOAD(TotalCounts, ClassCounts, CounterTotals, CounterDenominator);
+};
+
+TOnlineCtrPartStats CalcOnlineCtrPartStats(
+    const NCB::TQuantizedForCPUObjectsDataProvider& learnPartObjectsData,
+    const TFold& fold,
+    const TProjection& proj,
+    TConstArrayRef<TCtrInfo> ctrInfo
+);
+
+// partsStats are in order of parts, data is used only to count test objects for Counter ctrs
+TVector<TOnlineCtrPartPrefix> MergeOnlineCtrPartStats(
+    const NCB::TTrainingForCPUDataProviders& data,
+    const TProjection& proj,
+    TConstArrayRef<TCtrInfo> ctrInfo,
+    TConstArrayRef<int> targetClassesCount, // [targetClassifierIdx]
+    ECounterCalc counterCalcMethod,
+    TConstArrayRef<TOnlineCtrPartStats> partsStats,
+    size_t* uniqueValuesCount,
+    size_t* counterUniqueValuesCount
+);
+
+void ComputeOnlineCTRsForLearnPart(
+    const NCB::TQuantizedForCPUObjectsDataProvider& learnPartObjectsData,
+    const TFold& fold,
+    const TProjection& proj,
+    TConstArrayRef<TCtrInfo> ctrInfo,
+    const TOnlineCtrPartPrefix& prefix,
+    TOnlineCTR* dst
+);
+
 class TCtrValueTable;
 
 
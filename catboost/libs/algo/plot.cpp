@@ -99,25 +99,65 @@ void TMetricsPlotCalcer::Append(const TVector<TVector<double>>& approx, TVector<
 }
 
 TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSetForAdditiveMetrics(const TProcessedDataProvider& processedData) {
-    ProceedDataSet(processedData, 0, Iterations.ysize(), /*isAdditiveMetrics=*/true);
+    ProceedDataSet(
+        processedData,
+        0,
+        Iterations.ysize(),
+        /*computeAdditiveMetrics*/ true,
+        /*saveApproxForNonAdditiveMetrics*/ false
+    );
     return *this;
 }
 
-TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSetForNonAdditiveMetrics(const TProcessedDataProvider& processedData) {
-    if (ProcessedIterationsCount == 0) {
-        const ui32 newPoolSize = NonAdditiveMetricsData.Target.size() + processedData.ObjectsData->GetObjectCount();
-        NonAdditiveMetricsData.Target.reserve(newPoolSize);
-        NonAdditiveMetricsData.Weights.reserve(newPoolSize);
+void TMetricsPlotCalcer::AppendNonAdditiveMetricsData(const TProcessedDataProvider& processedData) {
+    const ui32 newPoolSize = NonAdditiveMetricsData.Target.size() + processedData.ObjectsData->GetObjectCount();
+    NonAdditiveMetricsData.Target.reserve(newPoolSize);
+    NonAdditiveMetricsData.Weights.reserve(newPoolSize);
+
+    const auto target = *processedData.TargetData->GetTarget();
+    NonAdditiveMetricsData.Target.insert(NonAdditiveMetricsData.Target.end(), target.begin(), target.end());
 
-        const auto target = *processedData.TargetData->GetTarget();
-        NonAdditiveMetricsData.Target.insert(NonAdditiveMetricsData.Target.end(), target.begin(), target.end());
+    const auto weights = GetWeights(*processedData.TargetData);
+    NonAdditiveMetricsData.Weights.insert(NonAdditiveMetricsData.Weights.end(), weights.begin(), weights.end());
+}
 
-        const auto weights = GetWeights(*processedData.TargetData);
-        NonAdditiveMetricsData.Weights.insert(NonAdditiveMetricsData.Weights.end(), weights.begin(), weights.end());
+TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSetForNonAdditiveMetrics(const TProcessedDataProvider& processedData) {
+    if (ProcessedIterationsCount == 0) {
+        AppendNonAdditiveMetricsData(processedData);
     }
     ui32 begin = ProcessedIterationsCount;
     ui32 end = Min<ui32>(ProcessedIterationsCount + ProcessedIterationsStep, Iterations.size());
-    ProceedDataSet(processedData, begin, end, /*isAdditiveMetrics=*/false);
+    ProceedDataSet(
+        processedData,
+        begin,
+        end,
+        /*computeAdditiveMetrics*/ false,
+        /*saveApproxForNonAdditiveMetrics*/ true
+    );
+    return *this;
+}
+
+TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSetInSinglePass(const TProcessedDataProvider& processedData) {
+    CB_ENSURE(ProcessedIterationsCount == 0, "Single pass is not compatible with processing by parts of iterations");
+    if (HasNonAdditiveMetric()) {
+        AppendNonAdditiveMetricsData(processedData);
+    }
+    ProceedDataSet(
+        processedData,
+        0,
+        Iterations.ysize(),
+        /*computeAdditiveMetrics*/ HasAdditiveMetric(),
+        /*saveApproxForNonAdditiveMetrics*/ HasNonAdditiveMetric()
+    );
+    return *this;
+}
+
+TMetricsPlotCalcer& TMetricsPlotCalcer::FinishProceedDataSetInSinglePass() {
+    if (HasNonAdditiveMetric()) {
+        ComputeNonAdditiveMetrics(0, Iterations.size());
+        DeleteApprox(Iterations.size() - 1);
+    }
+    ProcessedIterationsCount = Iterations.size();
     return *this;
 }
 
@@ -202,7 +242,8 @@ TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSet(
     const TProcessedDataProvider& processedData,
     ui32 beginIterationIndex,
     ui32 endIterationIndex,
-    bool isAdditiveMetrics
+    bool computeAdditiveMetrics,
+    bool saveApproxForNonAdditiveMetrics
 ) {
     TModelCalcerOnPool modelCalcerOnPool(Model, processedData.ObjectsData, &Executor);
 
@@ -231,14 +272,15 @@ TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSet(
         modelCalcerOnPool.ApplyModelMulti(EPredictionType::InternalRawFormulaVal, begin, end, &FlatApproxBuffer, &NextApproxBuffer);
         Append(NextApproxBuffer, &CurApproxBuffer);
 
-        if (isAdditiveMetrics) {
+        if (computeAdditiveMetrics) {
             ComputeAdditiveMetric(
                 CurApproxBuffer,
                 target,
                 weights,
                 groupInfos,
                 iterationIndex);
-        } else {
+        }
+        if (saveApproxForNonAdditiveMetrics) {
             SaveApproxToFile(iterationIndex, CurApproxBuffer);
         }
         begin = end;
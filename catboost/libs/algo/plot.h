@@ -49,6 +49,13 @@ public:
     TMetricsPlotCalcer& ProceedDataSetForNonAdditiveMetrics(const NCB::TProcessedDataProvider& processedData);
     TMetricsPlotCalcer& FinishProceedDataSetForNonAdditiveMetrics();
 
+    /* Computes additive metrics and saves approxes of all plot points for non-additive metrics to tmp dir,
+     * so the pool is read only once and only one plot point approx is kept in memory for non-additive metrics.
+     * Call FinishProceedDataSetInSinglePass after all dataset parts are processed.
+     */
+    TMetricsPlotCalcer& ProceedDataSetInSinglePass(const NCB::TProcessedDataProvider& processedData);
+    TMetricsPlotCalcer& FinishProceedDataSetInSinglePass();
+
     void ComputeNonAdditiveMetrics(const TVector<NCB::TProcessedDataProvider>& datasetParts);
 
     TMetricsPlotCalcer& SaveResult(const TString& resultDir, const TString& metricsFile, bool saveMetrics, bool saveStats);
@@ -69,9 +76,12 @@ private:
         const NCB::TProcessedDataProvider& processedData,
         ui32 beginIterationIndex,
         ui32 endIterationIndex,
-        bool isAdditive
+        bool computeAdditiveMetrics,
+        bool saveApproxForNonAdditiveMetrics
     );
 
+    void AppendNonAdditiveMetricsData(const NCB::TProcessedDataProvider& processedData);
+
     template <class TOutput>
     void WritePartialStats(TOutput* output, const char sep) const
     {
@@ -188,4 +188,7 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
         profile.AddOperation("Update final approxes");
         CheckInterrupted(); // check after long-lasting operation
     }
+    if (ctx->Params.IsProfile && !ctx->Params.SystemOptions->IsSingleHost()) {
+        MapAddWorkerProfile(ctx);
+    }
 }
@@ -0,0 +1,77 @@
+#include <catboost/libs/algo/calc_score_cache.h>
+
+#include <library/binsaver/util_stream_io.h>
+
+#include <util/generic/xrange.h>
+#include <util/stream/buffer.h>
+
+#include <library/unittest/registar.h>
+
+
+static TStats3D MakeStats3D(int statCount, bool saveStatsAsFloat) {
+    TStats3D stats3D;
+    stats3D.BucketCount = 5;
+    stats3D.MaxLeafCount = 2;
+    stats3D.SplitEnsembleSpec = TSplitEnsembleSpec(/*isBinarySplitsPack*/false, ESplitType::OnlineCtr);
+    stats3D.SaveStatsAsFloat = saveStatsAsFloat;
+    stats3D.Stats.yresize(statCount);
+    for (auto statIdx : xrange(statCount)) {
+        if (statIdx % 3 == 0) {
+            stats3D.Stats[statIdx] = TBucketStats{0, 0, 0, 0};
+        } else {
+            stats3D.Stats[statIdx] = TBucketStats{0.1 * statIdx, 2.5, -0.3 * statIdx, double(statIdx)};
+        }
+    }
+    return stats3D;
+}
+
+static TStats3D SaveAndLoad(TStats3D& stats3D) {
+    TBuffer buffer;
+    {
+        TBufferOutput out(buffer);
+        SerializeToStream(out, stats3D);
+    }
+    TStats3D loadedStats3D;
+    TBufferInput in(buffer);
+    SerializeFromStream(in, loadedStats3D);
+    return loadedStats3D;
+}
+
+Y_UNIT_TEST_SUITE(TStats3DSerialization) {
+    Y_UNIT_TEST(TestDouble) {
+        for (int statCount : {0, 1, 63, 64, 65, 200}) {
+            auto stats3D = MakeStats3D(statCount, /*saveStatsAsFloat*/false);
+            const auto loadedStats3D = SaveAndLoad(stats3D);
+
+            UNIT_ASSERT_VALUES_EQUAL(loadedStats3D.BucketCount, stats3D.BucketCount);
+            UNIT_ASSERT_VALUES_EQUAL(loadedStats3D.MaxLeafCount, stats3D.MaxLeafCount);
+            UNIT_ASSERT(loadedStats3D.SplitEnsembleSpec == stats3D.SplitEnsembleSpec);
+            UNIT_ASSERT(!loadedStats3D.SaveStatsAsFloat);
+            UNIT_ASSERT_VALUES_EQUAL(loadedStats3D.Stats.size(), stats3D.Stats.size());
+            for (auto statIdx : xrange(stats3D.Stats.size())) {
+                const auto& expected = stats3D.Stats[statIdx];
+                const auto& loaded = loadedStats3D.Stats[statIdx];
+                UNIT_ASSERT_VALUES_EQUAL(loaded.SumWeightedDelta, expected.SumWeightedDelta);
+                UNIT_ASSERT_VALUES_EQUAL(loaded.SumWeight, expected.SumWeight);
+                UNIT_ASSERT_VALUES_EQUAL(loaded.SumDelta, expected.SumDelta);
+                UNIT_ASSERT_VALUES_EQUAL(loaded.Count, expected.Count);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestFloat) {
+        auto stats3D = MakeStats3D(100, /*saveStatsAsFloat*/true);
+        const auto loadedStats3D = SaveAndLoad(stats3D);
+
+        UNIT_ASSERT(loadedStats3D.SaveStatsAsFloat);
+        UNIT_ASSERT_VALUES_EQUAL(loadedStats3D.Stats.size(), stats3D.Stats.size());
+        for (auto statIdx : xrange(stats3D.Stats.size())) {
+            const auto& expected = stats3D.Stats[statIdx];
+            const auto& loaded = loadedStats3D.Stats[statIdx];
+            UNIT_ASSERT_VALUES_EQUAL(loaded.SumWeightedDelta, float(expected.SumWeightedDelta));
+            UNIT_ASSERT_VALUES_EQUAL(loaded.SumWeight, float(expected.SumWeight));
+            UNIT_ASSERT_VALUES_EQUAL(loaded.SumDelta, float(expected.SumDelta));
+            UNIT_ASSERT_VALUES_EQUAL(loaded.Count, float(expected.Count));
+        }
+    }
+}
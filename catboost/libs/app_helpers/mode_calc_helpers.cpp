@@ -9,11 +9,17 @@
 #include <catboost/libs/labels/label_helper_builder.h>
 #include <catboost/libs/logging/logging.h>
 
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
 #include <util/string/cast.h>
 #include <util/string/iterator.h>
+#include <util/system/atomic.h>
+#include <util/system/guard.h>
+#include <util/system/mutex.h>
+#include <util/thread/pool.h>
 
-#include <util/generic/utility.h>
-#include <util/generic/xrange.h>
+#include <exception>
+#include <functional>
 
 
 void NCB::PrepareCalcModeParamsParser(
@@ -128,16 +134,88 @@ static NCB::TEvalResult Apply(
     return resultApprox;
 }
 
+namespace {
+    /*
+     * One stage of the calc pipeline: tasks are executed in order of addition by a dedicated thread,
+     * Add blocks while queueSizeLimit tasks are pending, so memory used by pending blocks is bounded.
+     * The first exception is saved and rethrown by Add or Finish, tasks after it are skipped.
+     */
+    class TPipelineStage {
+    public:
+        explicit TPipelineStage(size_t queueSizeLimit)
+            : ThreadPool(TThreadPool::BlockingMode, TThreadPool::NonCatchingMode)
+        {
+            ThreadPool.Start(1, queueSizeLimit);
+        }
+
+        ~TPipelineStage() {
+            // not finished normally - don't process the remaining tasks
+            AtomicSet(Cancelled, 1);
+        }
+
+        void Add(std::function<void()>&& task) {
+            RethrowIfFailed();
+            ThreadPool.SafeAddFunc([this, task = std::move(task)] () {
+                if (AtomicGet(Cancelled) || HasFailed()) {
+                    return;
+                }
+                try {
+                    task();
+                } catch (...) {
+                    with_lock(Lock) {
+                        if (!Exception) {
+                            Exception = std::current_exception();
+                        }
+                    }
+                }
+            });
+        }
+
+        // wait for all added tasks
+        void Finish() {
+            ThreadPool.Stop();
+            RethrowIfFailed();
+        }
+
+        void RethrowIfFailed() {
+            with_lock(Lock) {
+                if (Exception) {
+                    std::rethrow_exception(Exception);
+                }
+            }
+        }
+
+    private:
+        bool HasFailed() {
+            with_lock(Lock) {
+                return (bool)Exception;
+            }
+        }
+
+    private:
+        TAtomic Cancelled = 0;
+        TMutex Lock;
+        std::exception_ptr Exception;
+
+        // destroyed (and stopped) first
+        TThreadPool ThreadPool;
+    };
+}
+
 void NCB::CalcModelSingleHost(
     const NCB::TAnalyticalModeCommonParams& params,
     size_t iterationsLimit,
     size_t evalPeriod,
     const TFullModel& model ) {
 
-    CB_ENSURE(params.OutputPath.Scheme == "dsv" || params.OutputPath.Scheme == "stream", "Local model evaluation supports only \"dsv\"  and \"stream\" output file schemas.");
-    TSetLogging logging(params.OutputPath.Scheme == "dsv" ? ELoggingLevel::Info : ELoggingLevel::Silent);
+    CB_ENSURE(
+        params.OutputPath.Scheme == "dsv" || params.OutputPath.Scheme == "binary" || params.OutputPath.Scheme == "stream",
+        "Local model evaluation supports only \"dsv\", \"binary\" and \"stream\" output file schemas."
+    );
+    const bool isBinaryOutput = params.OutputPath.Scheme == "binary";
+    TSetLogging logging(params.OutputPath.Scheme != "stream" ? ELoggingLevel::Info : ELoggingLevel::Silent);
     THolder<IOutputStream> outputStream;
-    if (params.OutputPath.Scheme == "dsv") {
+    if (params.OutputPath.Scheme != "stream") {
          outputStream = MakeHolder<TOFStream>(params.OutputPath.Path);
     } else {
         CB_ENSURE(params.OutputPath.Path == "stdout" || params.OutputPath.Path == "stderr", "Local model evaluation supports only stderr and stdout paths.");
@@ -155,15 +233,29 @@ void NCB::CalcModelSingleHost(
     bool IsFirstBlock = true;
     ui64 docIdOffset = 0;
     auto poolColumnsPrinter = CreatePoolColumnPrinter(params.InputPath, params.DsvPoolFormatParams.Format);
+    const auto visibleLabelsHelper = BuildLabelsHelper<TExternalLabelsHelper>(model);
     const int blockSize = Max<int>(32, static_cast<int>(10000. / (static_cast<double>(iterationsLimit) / evalPeriod) / model.ObliviousTrees.ApproxDimension));
-    ReadAndProceedPoolInBlocks(params, blockSize, [&](const NCB::TDataProviderPtr datasetPart) {
-        if (IsFirstBlock) {
-            ValidateColumnOutput(params.OutputColumnsIds, *datasetPart, true);
-        }
-        auto approx = Apply(model, *datasetPart, 0, iterationsLimit, evalPeriod, &executor);
-        auto visibleLabelsHelper = BuildLabelsHelper<TExternalLabelsHelper>(model);
 
-        poolColumnsPrinter->UpdateColumnTypeInfo(datasetPart->MetaInfo.ColumnsInfo);
+    /* Blocks are parsed in this thread, predicted and written in the pipeline stages, so parsing of
+     * block N + 1, prediction of block N and writing of block N - 1 overlap.
+     * All stages share executor for parallel work.
+     */
+    const size_t pipelineQueueSizeLimit = 2;
+    TPipelineStage writeStage(pipelineQueueSizeLimit);
+    TPipelineStage predictStage(pipelineQueueSizeLimit);
+
+    auto writeBlock = [&] (const NCB::TDataProvider& datasetPart, const NCB::TEvalResult& approx, bool isFirstBlock, ui64 blockDocIdOffset) {
+        if (isBinaryOutput) {
+            OutputEvalResultToBinaryFile(
+                approx,
+                &executor,
+                params.OutputColumnsIds,
+                visibleLabelsHelper,
+                outputStream.Get()
+            );
+            return;
+        }
+        poolColumnsPrinter->UpdateColumnTypeInfo(datasetPart.MetaInfo.ColumnsInfo);
 
         TSetLoggingSilent inThisScope;
         OutputEvalResultToFile(
@@ -171,18 +263,34 @@ void NCB::CalcModelSingleHost(
             &executor,
             params.OutputColumnsIds,
             visibleLabelsHelper,
-            *datasetPart,
+            datasetPart,
             true,
             outputStream.Get(),
             // TODO: src file columns output is incompatible with block processing
             poolColumnsPrinter,
             /*testFileWhichOf*/ {0, 0},
-            IsFirstBlock,
-            docIdOffset,
+            isFirstBlock,
+            blockDocIdOffset,
             std::make_pair(evalPeriod, iterationsLimit)
         );
+    };
+
+    ReadAndProceedPoolInBlocks(params, blockSize, [&](const NCB::TDataProviderPtr datasetPart) {
+        if (IsFirstBlock) {
+            ValidateColumnOutput(params.OutputColumnsIds, *datasetPart, true);
+        }
+        writeStage.RethrowIfFailed();
+        predictStage.Add([&, datasetPart, isFirstBlock = IsFirstBlock, blockDocIdOffset = docIdOffset] () {
+            auto approx = Apply(model, *datasetPart, 0, iterationsLimit, evalPeriod, &executor);
+            writeStage.Add([&, datasetPart, approx = std::move(approx), isFirstBlock, blockDocIdOffset] () {
+                writeBlock(*datasetPart, approx, isFirstBlock, blockDocIdOffset);
+            });
+        });
         docIdOffset += datasetPart->ObjectsGrouping->GetObjectCount();
         IsFirstBlock = false;
     }, &executor);
-}
 
+    predictStage.Finish();
+    writeStage.Finish();
+    outputStream->Finish();
+}
@@ -6,6 +6,7 @@
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/libs/options/system_options.h>
 
 #include <util/generic/ptr.h>
 #include <util/generic/serialized_enum.h>
@@ -83,6 +84,11 @@ void NCB::PrepareFstrModeParamsParser(
             CB_ENSURE(TryFromString<int>(verbose, params.Verbose), "verbose should be integer");
             CB_ENSURE(params.Verbose >= 0, "verbose should be non-negative");
         });
+    parser.AddLongOption("shap-used-ram-limit", "Try to limit used memory for ShapValues calculation, trees are processed by chunks if needed")
+        .RequiredArgument("SIZE")
+        .Handler1T<TString>([&params](const TString& limit) {
+            params.ShapUsedRamLimit = ParseMemorySizeDescription(limit);
+        });
     parser.SetFreeArgsNum(0);
 }
 
@@ -132,7 +138,13 @@ void NCB::ModeFstrSingleHost(const NCB::TAnalyticalModeCommonParams& params) {
             CalcAndOutputInteraction(model, nullptr, &params.OutputPath.Path);
             break;
         case EFstrType::ShapValues:
-            CalcAndOutputShapValues(model, *poolLoader(), params.OutputPath.Path, params.Verbose, localExecutor.Get());
+            CalcAndOutputShapValues(
+                model,
+                *poolLoader(),
+                params.OutputPath.Path,
+                params.Verbose,
+                localExecutor.Get(),
+                params.ShapUsedRamLimit);
             break;
         default:
             Y_ASSERT(false);
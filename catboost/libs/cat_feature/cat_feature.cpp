@@ -2,7 +2,27 @@
 
 #include <util/digest/city.h>
 #include <util/generic/strbuf.h>
+#include <util/generic/utility.h>
+#include <util/system/compiler.h>
+#include <util/system/yassert.h>
+
+// strings are usually short and scattered in memory, so hashing is bound by memory latency
+static constexpr size_t CatFeatureHashPrefetchDistance = 8;
 
 ui32 CalcCatFeatureHash(const TStringBuf feature) noexcept {
     return CityHash64(feature) & 0xffffffff;
 }
+
+void CalcCatFeatureHashes(TConstArrayRef<TStringBuf> features, TArrayRef<ui32> hashes) noexcept {
+    Y_ASSERT(features.size() <= hashes.size());
+    const size_t count = features.size();
+    for (size_t i = 0; i < Min(count, CatFeatureHashPrefetchDistance); ++i) {
+        Y_PREFETCH_READ(features[i].data(), 3);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (i + CatFeatureHashPrefetchDistance < count) {
+            Y_PREFETCH_READ(features[i + CatFeatureHashPrefetchDistance].data(), 3);
+        }
+        hashes[i] = CalcCatFeatureHash(features[i]);
+    }
+}
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <util/generic/array_ref.h>
 #include <util/generic/strbuf.h>
 #include <util/system/types.h>
 
 ui32 CalcCatFeatureHash(const TStringBuf feature) noexcept;
 
+// same as CalcCatFeatureHash for each value, data of next values is prefetched while current value is hashed
+void CalcCatFeatureHashes(TConstArrayRef<TStringBuf> features, TArrayRef<ui32> hashes) noexcept;
+
 // deprecated, for compatibility, prefer CalcCatFeatureHash in new code
 inline int CalcCatFeatureHashInt(const TStringBuf feature) noexcept {
     ui32 hashVal = CalcCatFeatureHash(feature);
@@ -5,6 +5,7 @@
 #include <library/threading/future/future.h>
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
 #include <util/system/types.h>
 
@@ -111,6 +112,10 @@ namespace NCB {
             return ParseBuffer.size();
         }
 
+        TConstArrayRef<TData> GetParseBuffer() const {
+            return ParseBuffer;
+        }
+
         size_t GetLinesProcessed() const {
             return LinesProcessed;
         }
@@ -9,6 +9,8 @@
 #include <library/object_factory/object_factory.h>
 
 #include <util/generic/maybe.h>
+#include <util/generic/utility.h>
+#include <util/generic/ylimits.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/vector.h>
 #include <util/stream/file.h>
@@ -79,6 +81,21 @@ namespace NCB {
     }
 
 
+    ui32 TCBDsvDataLoader::GetEstimatedObjectCount() {
+        const TMaybe<ui64> dataSize = LineDataReader->GetDataSize();
+        const auto firstBlockLines = AsyncRowProcessor.GetParseBuffer();
+        if (!dataSize || firstBlockLines.empty()) {
+            return 0;
+        }
+        ui64 firstBlockSize = 0;
+        for (const auto& line : firstBlockLines) {
+            firstBlockSize += line.size() + 1; // with line end
+        }
+        // 5% more, so that variance of line sizes rarely makes the storage grow
+        const ui64 estimate = *dataSize * firstBlockLines.size() / firstBlockSize * 21 / 20;
+        return (ui32)Min<ui64>(estimate, Max<ui32>());
+    }
+
     void TCBDsvDataLoader::StartBuilder(bool inBlock,
                                           ui32 objectCount, ui32 /*offset*/,
                                           IRawObjectsOrderDataVisitor* visitor)
@@ -9,7 +9,6 @@
 #include <util/generic/ptr.h>
 #include <util/generic/string.h>
 #include <util/generic/vector.h>
-#include <util/generic/ylimits.h>
 #include <util/system/types.h>
 
 
@@ -54,15 +53,7 @@ namespace NCB {
 
         TVector<TColumn> CreateColumnsDescription(ui32 columnsCount);
 
-        ui32 GetObjectCount() override {
-            const ui64 dataLineCount = LineDataReader->GetDataLineCount();
-            CB_ENSURE(
-                dataLineCount <= Max<ui32>(), "CatBoost does not support datasets with more than "
-                << Max<ui32>() << " objects"
-            );
-            // cast is safe - was checked above
-            return (ui32)dataLineCount;
-        }
+        ui32 GetEstimatedObjectCount() override;
 
         void StartBuilder(
             bool inBlock,
@@ -0,0 +1,410 @@
+#include "columnar_loader.h"
+
+#include "baseline.h"
+#include "loader.h"
+#include "meta_info.h"
+
+#include <catboost/libs/data_types/groupid.h>
+#include <catboost/libs/data_util/exists_checker.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/maybe_owning_array_holder.h>
+#include <catboost/libs/helpers/resource_holder.h>
+
+#include <library/object_factory/object_factory.h>
+
+#include <util/generic/cast.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
+#include <util/memory/blob.h>
+#include <util/stream/mem.h>
+#include <util/stream/output.h>
+#include <util/string/cast.h>
+#include <util/ysaveload.h>
+
+
+namespace NCB {
+
+    static constexpr char COLUMNAR_POOL_MAGIC_DATA[] = "CatboostColumnarPool";
+    static const TStringBuf COLUMNAR_POOL_MAGIC(COLUMNAR_POOL_MAGIC_DATA, sizeof(COLUMNAR_POOL_MAGIC_DATA));
+    static constexpr ui32 COLUMNAR_POOL_VERSION = 1;
+
+    size_t GetValueSize(EColumnarValueType valueType) {
+        switch (valueType) {
+            case EColumnarValueType::Float32:
+                return sizeof(float);
+            case EColumnarValueType::Int32:
+                return sizeof(i32);
+            case EColumnarValueType::Int64:
+                return sizeof(i64);
+        }
+        ythrow TCatBoostException() << "Unknown columnar value type " << static_cast<ui32>(valueType);
+    }
+
+    static void SaveString(TStringBuf str, IOutputStream* output) {
+        const ui32 size = SafeIntegerCast<ui32>(str.size());
+        ::Save(output, size);
+        output->Write(str.data(), str.size());
+    }
+
+    static void WritePadding(ui64 size, IOutputStream* output) {
+        static const char zeroes[COLUMNAR_POOL_DATA_ALIGNMENT] = {};
+        output->Write(zeroes, size);
+    }
+
+    static ui64 AlignUp(ui64 offset) {
+        return (offset + COLUMNAR_POOL_DATA_ALIGNMENT - 1) / COLUMNAR_POOL_DATA_ALIGNMENT
+            * COLUMNAR_POOL_DATA_ALIGNMENT;
+    }
+
+    void SaveColumnarPool(ui64 objectCount, TConstArrayRef<TColumnarPoolColumn> columns, IOutputStream* output) {
+        ui64 headerSize = COLUMNAR_POOL_MAGIC.size() + sizeof(ui32) + sizeof(ui64) + sizeof(ui32);
+        for (const auto& column : columns) {
+            headerSize += sizeof(ui32) + ToString(column.Type).size();
+            headerSize += sizeof(ui32) + column.Name.size();
+            headerSize += sizeof(ui8) + sizeof(ui64);
+        }
+
+        TVector<ui64> dataOffsets;
+        dataOffsets.reserve(columns.size());
+        ui64 dataOffset = AlignUp(headerSize);
+        for (const auto& column : columns) {
+            CB_ENSURE(
+                column.Data.size() == objectCount * GetValueSize(column.ValueType),
+                "Column " << column.Type << " '" << column.Name << "' has " << column.Data.size()
+                << " bytes of data, expected " << objectCount * GetValueSize(column.ValueType));
+            dataOffsets.push_back(dataOffset);
+            dataOffset = AlignUp(dataOffset + column.Data.size());
+        }
+
+        output->Write(COLUMNAR_POOL_MAGIC.data(), COLUMNAR_POOL_MAGIC.size());
+        ::Save(output, COLUMNAR_POOL_VERSION);
+        ::Save(output, objectCount);
+        ::Save(output, SafeIntegerCast<ui32>(columns.size()));
+        for (auto i : xrange(columns.size())) {
+            SaveString(ToString(columns[i].Type), output);
+            SaveString(columns[i].Name, output);
+            ::Save(output, static_cast<ui8>(columns[i].ValueType));
+            ::Save(output, dataOffsets[i]);
+        }
+
+        ui64 written = headerSize;
+        for (auto i : xrange(columns.size())) {
+            WritePadding(dataOffsets[i] - written, output);
+            output->Write(columns[i].Data.data(), columns[i].Data.size());
+            written = dataOffsets[i] + columns[i].Data.size();
+        }
+    }
+
+
+    namespace {
+        class TBlobHolder : public IResourceHolder {
+        public:
+            explicit TBlobHolder(TBlob&& blob)
+                : Blob(std::move(blob))
+            {}
+
+            const TBlob& GetBlob() const {
+                return Blob;
+            }
+
+        private:
+            TBlob Blob;
+        };
+
+        struct TColumnarPoolColumnData {
+            EColumnarValueType ValueType;
+            TConstArrayRef<ui8> Data;
+        };
+
+        class TColumnarDataLoader : public IRawFeaturesOrderDatasetLoader {
+        public:
+            explicit TColumnarDataLoader(TDatasetLoaderPullArgs&& args);
+
+            void Do(IRawFeaturesOrderDataVisitor* visitor) override;
+
+        private:
+            void ReadHeader();
+
+            template <class T>
+            TConstArrayRef<T> GetValues(const TColumnarPoolColumnData& column) const {
+                return MakeArrayRef(reinterpret_cast<const T*>(column.Data.data()), ObjectCount);
+            }
+
+            template <class TIntValue>
+            void ProcessIntColumn(
+                const TColumn& column,
+                const TColumnarPoolColumnData& columnData,
+                const TMaybe<ui32>& flatFeatureIdx,
+                IRawFeaturesOrderDataVisitor* visitor) const;
+
+            template <class TIntValue>
+            void AddCatFeature(
+                ui32 flatFeatureIdx,
+                TConstArrayRef<TIntValue> values,
+                IRawFeaturesOrderDataVisitor* visitor) const;
+
+        private:
+            TDatasetLoaderCommonArgs Args;
+            TIntrusivePtr<TBlobHolder> BlobHolder;
+            ui32 ObjectCount = 0;
+            TVector<TColumn> Columns;
+            TVector<TColumnarPoolColumnData> ColumnsData;
+            TDataMetaInfo DataMetaInfo;
+            TVector<bool> FeatureIgnored;
+        };
+    }
+
+    TColumnarDataLoader::TColumnarDataLoader(TDatasetLoaderPullArgs&& args)
+        : Args(std::move(args.CommonArgs))
+        , BlobHolder(MakeIntrusive<TBlobHolder>(TBlob::FromFile(args.PoolPath.Path)))
+    {
+        CB_ENSURE(!Args.PairsFilePath.Inited() || CheckExists(Args.PairsFilePath),
+                  "TColumnarDataLoader:PairsFilePath does not exist");
+        CB_ENSURE(!Args.GroupWeightsFilePath.Inited() || CheckExists(Args.GroupWeightsFilePath),
+                  "TColumnarDataLoader:GroupWeightsFilePath does not exist");
+        CB_ENSURE(!Args.BaselineFilePath.Inited() || CheckExists(Args.BaselineFilePath),
+                  "TColumnarDataLoader:BaselineFilePath does not exist");
+
+        ReadHeader();
+
+        // column types are stored in the pool itself, so column description is not used
+        DataMetaInfo = TDataMetaInfo(
+            TDataColumnsMetaInfo{Columns},
+            Args.GroupWeightsFilePath.Inited(),
+            Args.PairsFilePath.Inited(),
+            TBaselineReader(Args.BaselineFilePath, Args.ClassNames).GetBaselineCount(),
+            Nothing(),
+            Args.ClassNames
+        );
+        CB_ENSURE(DataMetaInfo.GetFeatureCount() > 0, "Pool should have at least one factor");
+
+        ProcessIgnoredFeaturesList(Args.IgnoredFeatures, &DataMetaInfo, &FeatureIgnored);
+    }
+
+    void TColumnarDataLoader::ReadHeader() {
+        const TBlob& blob = BlobHolder->GetBlob();
+        TMemoryInput input(blob.AsCharPtr(), blob.Size());
+
+        char magic[sizeof(COLUMNAR_POOL_MAGIC_DATA)];
+        CB_ENSURE(
+            input.Load(magic, sizeof(magic)) == sizeof(magic) && TStringBuf(magic, sizeof(magic)) == COLUMNAR_POOL_MAGIC,
+            "Not a columnar pool: wrong magic");
+
+        ui32 version = 0;
+        ::Load(&input, version);
+        CB_ENSURE(version == COLUMNAR_POOL_VERSION, "Unsupported columnar pool version " << version);
+
+        ui64 objectCount = 0;
+        ::Load(&input, objectCount);
+        CB_ENSURE(objectCount > 0, "Pool is empty");
+        CB_ENSURE(
+            objectCount <= static_cast<ui64>(Max<ui32>()),
+            "CatBoost does not support datasets with more than " << Max<ui32>() << " objects"
+        );
+        ObjectCount = static_cast<ui32>(objectCount);
+
+        ui32 columnCount = 0;
+        ::Load(&input, columnCount);
+        // each column has at least type and name sizes, value type and data offset in the header
+        const ui64 minColumnHeaderSize = 2 * sizeof(ui32) + sizeof(ui8) + sizeof(ui64);
+        CB_ENSURE(
+            columnCount <= input.Avail() / minColumnHeaderSize,
+            "Columnar pool header is truncated");
+
+        auto loadString = [&input] () {
+            ui32 size = 0;
+            ::Load(&input, size);
+            CB_ENSURE(input.Avail() >= size, "Columnar pool header is truncated");
+            TString result(input.Buf(), size);
+            input.Skip(size);
+            return result;
+        };
+
+        for (auto columnIdx : xrange(columnCount)) {
+            TColumn column;
+            column.Type = FromString<EColumn>(loadString());
+            column.Id = loadString();
+
+            ui8 valueType = 0;
+            ::Load(&input, valueType);
+            ui64 dataOffset = 0;
+            ::Load(&input, dataOffset);
+
+            TColumnarPoolColumnData columnData;
+            columnData.ValueType = static_cast<EColumnarValueType>(valueType);
+            // objectCount fits into ui32 and values are at most 8 bytes, so dataSize doesn't overflow
+            const ui64 dataSize = objectCount * GetValueSize(columnData.ValueType);
+            CB_ENSURE(
+                dataOffset % COLUMNAR_POOL_DATA_ALIGNMENT == 0,
+                "Data of column #" << columnIdx << " is not aligned");
+            // written so that offset from the file can't overflow
+            CB_ENSURE(
+                dataOffset <= blob.Size() && dataSize <= blob.Size() - dataOffset,
+                "Data of column #" << columnIdx << " is out of file bounds");
+            columnData.Data = MakeArrayRef(blob.AsUnsignedCharPtr() + dataOffset, static_cast<size_t>(dataSize));
+
+            switch (column.Type) {
+                case EColumn::Num:
+                case EColumn::Label:
+                case EColumn::Weight:
+                case EColumn::GroupWeight:
+                case EColumn::Baseline:
+                    CB_ENSURE(
+                        columnData.ValueType == EColumnarValueType::Float32,
+                        "Column #" << columnIdx << " of type " << column.Type << " must have Float32 values");
+                    break;
+                case EColumn::Categ:
+                case EColumn::GroupId:
+                case EColumn::SubgroupId:
+                    CB_ENSURE(
+                        columnData.ValueType != EColumnarValueType::Float32,
+                        "Column #" << columnIdx << " of type " << column.Type << " must have integer values");
+                    break;
+                case EColumn::Timestamp:
+                    CB_ENSURE(
+                        columnData.ValueType == EColumnarValueType::Int64,
+                        "Column #" << columnIdx << " of type " << column.Type << " must have Int64 values");
+                    break;
+                case EColumn::SampleId:
+                case EColumn::Auxiliary:
+                    break;
+                case EColumn::Sparse:
+                case EColumn::Prediction:
+                    CB_ENSURE(false, "Column #" << columnIdx << " has unsupported type " << column.Type);
+            }
+
+            Columns.push_back(std::move(column));
+            ColumnsData.push_back(columnData);
+        }
+    }
+
+    template <class TIntValue>
+    void TColumnarDataLoader::AddCatFeature(
+        ui32 flatFeatureIdx,
+        TConstArrayRef<TIntValue> values,
+        IRawFeaturesOrderDataVisitor* visitor) const
+    {
+        // values are passed as strings so they are hashed the same way as in dsv pools
+        // and hash to string mapping is available for the model output
+        TVector<TString> strValues;
+        strValues.resize(values.size());
+
+        NPar::TLocalExecutor::TExecRangeParams rangeParams(0, SafeIntegerCast<int>(values.size()));
+        rangeParams.SetBlockCount(Args.LocalExecutor->GetThreadCount() + 1);
+        Args.LocalExecutor->ExecRange(
+            [&] (int blockIdx) {
+                const int begin = rangeParams.FirstId + blockIdx * rangeParams.GetBlockSize();
+                const int end = Min(begin + rangeParams.GetBlockSize(), rangeParams.LastId);
+                for (int i = begin; i < end; ++i) {
+                    strValues[i] = ToString(values[i]);
+                }
+            },
+            0,
+            rangeParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        visitor->AddCatFeature(flatFeatureIdx, TConstArrayRef<TString>(strValues));
+    }
+
+    template <class TIntValue>
+    void TColumnarDataLoader::ProcessIntColumn(
+        const TColumn& column,
+        const TColumnarPoolColumnData& columnData,
+        const TMaybe<ui32>& flatFeatureIdx,
+        IRawFeaturesOrderDataVisitor* visitor) const
+    {
+        const auto values = GetValues<TIntValue>(columnData);
+        switch (column.Type) {
+            case EColumn::Categ:
+                AddCatFeature(*flatFeatureIdx, values, visitor);
+                break;
+            case EColumn::GroupId:
+                for (auto objectIdx : xrange(ObjectCount)) {
+                    visitor->AddGroupId(objectIdx, CalcGroupIdFor(ToString(values[objectIdx])));
+                }
+                break;
+            case EColumn::SubgroupId:
+                for (auto objectIdx : xrange(ObjectCount)) {
+                    visitor->AddSubgroupId(objectIdx, CalcSubgroupIdFor(ToString(values[objectIdx])));
+                }
+                break;
+            case EColumn::Timestamp:
+                for (auto objectIdx : xrange(ObjectCount)) {
+                    visitor->AddTimestamp(objectIdx, static_cast<ui64>(values[objectIdx]));
+                }
+                break;
+            default:
+                CB_ENSURE_INTERNAL(false, "Unexpected integer column type " << column.Type);
+        }
+    }
+
+    void TColumnarDataLoader::Do(IRawFeaturesOrderDataVisitor* visitor) {
+        visitor->Start(DataMetaInfo, ObjectCount, Args.ObjectsOrder, {BlobHolder});
+
+        ui32 flatFeatureIdx = 0;
+        ui32 baselineIdx = 0;
+        for (auto columnIdx : xrange(Columns.size())) {
+            const auto& column = Columns[columnIdx];
+            const auto& columnData = ColumnsData[columnIdx];
+
+            TMaybe<ui32> featureIdx;
+            if (IsFactorColumn(column.Type)) {
+                featureIdx = flatFeatureIdx++;
+                if (FeatureIgnored[*featureIdx]) {
+                    continue;
+                }
+            }
+
+            switch (column.Type) {
+                case EColumn::Num:
+                    visitor->AddFloatFeature(
+                        *featureIdx,
+                        TMaybeOwningConstArrayHolder<float>::CreateOwning(GetValues<float>(columnData), BlobHolder)
+                    );
+                    break;
+                case EColumn::Label:
+                    visitor->AddTarget(GetValues<float>(columnData));
+                    break;
+                case EColumn::Weight:
+                    visitor->AddWeights(GetValues<float>(columnData));
+                    break;
+                case EColumn::GroupWeight:
+                    visitor->AddGroupWeights(GetValues<float>(columnData));
+                    break;
+                case EColumn::Baseline:
+                    visitor->AddBaseline(baselineIdx++, GetValues<float>(columnData));
+                    break;
+                case EColumn::Categ:
+                case EColumn::GroupId:
+                case EColumn::SubgroupId:
+                case EColumn::Timestamp:
+                    if (columnData.ValueType == EColumnarValueType::Int32) {
+                        ProcessIntColumn<i32>(column, columnData, featureIdx, visitor);
+                    } else {
+                        ProcessIntColumn<i64>(column, columnData, featureIdx, visitor);
+                    }
+                    break;
+                case EColumn::SampleId:
+                case EColumn::Auxiliary:
+                    // not used in training
+                    break;
+                case EColumn::Sparse:
+                case EColumn::Prediction:
+                    CB_ENSURE_INTERNAL(false, "Unexpected column type " << column.Type);
+            }
+        }
+
+        SetGroupWeights(Args.GroupWeightsFilePath, ObjectCount, visitor);
+        SetPairs(Args.PairsFilePath, ObjectCount, visitor);
+        SetBaseline(Args.BaselineFilePath, ObjectCount, DataMetaInfo.ClassNames, visitor);
+        visitor->Finish();
+    }
+
+    namespace {
+        TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSColumnarExistsCheckerReg("columnar");
+        TDatasetLoaderFactory::TRegistrator<TColumnarDataLoader> ColumnarDataLoaderReg("columnar");
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <catboost/libs/column_description/column.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/string.h>
+#include <util/stream/fwd.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /*
+     * Columnar binary dataset format, loaded with "columnar://" scheme.
+     *
+     * All integers are little-endian.
+     *
+     *  | magic "CatboostColumnarPool\0" | ui32 version | ui64 objectCount | ui32 columnCount |
+     *  | columnCount column descriptions | padding | column data blocks |
+     *
+     * Column description:
+     *
+     *  | ui32 size | column type name (as in column description file: "Num", "Label", ...) |
+     *  | ui32 size | column name (can be empty) |
+     *  | ui8 EColumnarValueType | ui64 data offset from the beginning of the file |
+     *
+     * Column data block is objectCount values of the column value type stored contiguously, data
+     * offset must be a multiple of COLUMNAR_POOL_DATA_ALIGNMENT so the file can be memory mapped and
+     * float columns can be used directly without copying or parsing.
+     *
+     * Supported column value types:
+     *   Num, Label, Weight, GroupWeight, Baseline: Float32
+     *   Categ, GroupId, SubgroupId: Int32 or Int64 (hashed as their decimal string representation,
+     *     so values are compatible with the same values in dsv format)
+     *   Timestamp: Int64
+     *   SampleId, Auxiliary: any, data is not loaded
+     */
+
+    enum class EColumnarValueType : ui8 {
+        Float32 = 1,
+        Int32 = 2,
+        Int64 = 3
+    };
+
+    constexpr ui32 COLUMNAR_POOL_DATA_ALIGNMENT = 16;
+
+    size_t GetValueSize(EColumnarValueType valueType);
+
+    struct TColumnarPoolColumn {
+        EColumn Type = EColumn::Num;
+        TString Name;
+        EColumnarValueType ValueType = EColumnarValueType::Float32;
+        TConstArrayRef<ui8> Data; // objectCount * GetValueSize(ValueType) bytes
+    };
+
+    void SaveColumnarPool(ui64 objectCount, TConstArrayRef<TColumnarPoolColumn> columns, IOutputStream* output);
+}
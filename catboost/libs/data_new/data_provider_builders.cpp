@@ -116,7 +116,15 @@ namespace NCB {
 
         void StartNextBlock(ui32 blockSize) override {
             Cursor = NextCursor;
+            CB_ENSURE(
+                blockSize <= Max<ui32>() - Cursor,
+                "CatBoost does not support datasets with more than " << Max<ui32>() << " objects"
+            );
             NextCursor = Cursor + blockSize;
+            if (NextCursor > ObjectCount) {
+                // objectCount passed to Start was unknown or underestimated - grow geometrically
+                ResizeStorage((ui32)Min<ui64>(Max<ui64>(NextCursor, (ui64)ObjectCount * 3 / 2), Max<ui32>()));
+            }
         }
 
         // TCommonObjectsData
@@ -211,7 +219,7 @@ namespace NCB {
 
         // separate method because they can be loaded from a separate data source
         void SetGroupWeights(TVector<float>&& groupWeights) override {
-            CheckDataSize(groupWeights.size(), (size_t)ObjectCount, "groupWeights");
+            CheckDataSize(groupWeights.size(), (size_t)NextCursor, "groupWeights");
             GroupWeightsBuffer = std::move(groupWeights);
         }
 
@@ -226,15 +234,21 @@ namespace NCB {
 
         // needed for checking groupWeights consistency while loading from separate file
         TMaybeData<TConstArrayRef<TGroupId>> GetGroupIds() const override {
-            return Data.CommonObjectsData.GroupIds;
+            const auto& groupIds = Data.CommonObjectsData.GroupIds;
+            if (!groupIds) {
+                return Nothing();
+            }
+            // storage might be preallocated for more objects than were added
+            return TConstArrayRef<TGroupId>(groupIds->data(), NextCursor);
         }
 
         void Finish() override {
             CB_ENSURE(InProcess, "Attempt to Finish without starting processing");
-            CB_ENSURE(
-                NextCursor >= ObjectCount,
-                "processed object count is less than than specified in metadata"
-            );
+
+            // object count is the number of objects in all added blocks
+            if (NextCursor != ObjectCount) {
+                ResizeStorage(NextCursor);
+            }
 
             if (ObjectCount != 0) {
                 CATBOOST_INFO_LOG << "Object info sizes: " << ObjectCount << " "
@@ -373,6 +387,54 @@ namespace NCB {
         }
 
     private:
+        // keeps already added data
+        void ResizeStorage(ui32 objectCount) {
+            ObjectCount = objectCount;
+
+            auto& targetData = Data.TargetData;
+            if (targetData.Target) {
+                ResizeKeepingData(objectCount, &*targetData.Target);
+            }
+            for (auto& baseline : targetData.Baseline) {
+                ResizeKeepingData(objectCount, &baseline);
+            }
+            // non-trivial weights are set from buffers in GetResult
+            targetData.SetTrivialWeights(objectCount);
+
+            auto& commonObjectsData = Data.CommonObjectsData;
+            if (commonObjectsData.GroupIds) {
+                ResizeKeepingData(objectCount, &*commonObjectsData.GroupIds);
+            }
+            if (commonObjectsData.SubgroupIds) {
+                ResizeKeepingData(objectCount, &*commonObjectsData.SubgroupIds);
+            }
+            if (commonObjectsData.Timestamp) {
+                ResizeKeepingData(objectCount, &*commonObjectsData.Timestamp);
+            }
+
+            FloatFeaturesStorage.Resize(objectCount);
+            CatFeaturesStorage.Resize(objectCount);
+
+            if (Data.MetaInfo.HasWeights) {
+                ResizeKeepingData(objectCount, &WeightsBuffer);
+            }
+            if (Data.MetaInfo.HasGroupWeight) {
+                ResizeKeepingData(objectCount, &GroupWeightsBuffer);
+            }
+        }
+
+        /* allocates exactly objectCount on growth, excess memory is released only if it is large
+         * because shrinking copies data
+         */
+        template <class T>
+        static void ResizeKeepingData(ui32 objectCount, TVector<T>* data) {
+            data->reserve(objectCount);
+            data->yresize(objectCount);
+            if (data->capacity() - objectCount > objectCount / 8) {
+                data->shrink_to_fit();
+            }
+        }
+
         void RollbackNextCursorToLastGroupStart() {
             const auto& groupIds = *Data.CommonObjectsData.GroupIds;
             if (ObjectCount == 0) {
@@ -458,6 +520,16 @@ namespace NCB {
                 }
             }
 
+            // keeps already added data
+            void Resize(ui32 objectCount) {
+                for (auto perTypeFeatureIdx : xrange(Storage.size())) {
+                    if (IsAvailable[perTypeFeatureIdx]) {
+                        ResizeKeepingData(objectCount, &(Storage[perTypeFeatureIdx]->Data));
+                        DstView[perTypeFeatureIdx] = Storage[perTypeFeatureIdx]->Data;
+                    }
+                }
+            }
+
             void Set(TFeatureIdx<FeatureType> perTypeFeatureIdx, ui32 objectIdx, T value) {
                 if (IsAvailable[*perTypeFeatureIdx]) {
                     DstView[*perTypeFeatureIdx][objectIdx] = value;
@@ -622,6 +694,21 @@ namespace NCB {
             );
         }
 
+        void AddCatFeature(
+            ui32 flatFeatureIdx,
+            TMaybeOwningConstArrayHolder<ui32> features,
+            THashMap<ui32, TString>&& hashToString
+        ) override {
+            auto catFeatureIdx = GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx);
+            auto& catFeatureHash = (*Data.CommonObjectsData.CatFeaturesHashToString)[*catFeatureIdx];
+            if (catFeatureHash.empty()) {
+                catFeatureHash = std::move(hashToString);
+            } else {
+                catFeatureHash.insert(hashToString.begin(), hashToString.end());
+            }
+            AddCatFeature(flatFeatureIdx, std::move(features));
+        }
+
 
         // TRawTargetData
 
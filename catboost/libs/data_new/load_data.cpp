@@ -143,6 +143,57 @@ namespace NCB {
         return dataProviderBuilder->GetResult();
     }
 
+    TDataProviderPtr ReadDatasetLinesRange(
+        const TPathWithScheme& poolPath,
+        ui64 beginLineIdx,
+        ui64 endLineIdx,
+        const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
+        const TVector<ui32>& ignoredFeatures,
+        EObjectsOrder objectsOrder,
+        TMaybe<TVector<TString>*> classNames,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        CB_ENSURE(
+            poolPath.Scheme.empty() || (poolPath.Scheme == "dsv") || (poolPath.Scheme == "file"),
+            "Reading range of lines is supported only for dsv format, got scheme [" << poolPath.Scheme << ']'
+        );
+
+        THolder<IDataProviderBuilder> dataProviderBuilder = CreateDataProviderBuilder(
+            EDatasetVisitorType::RawObjectsOrder,
+            TDataProviderBuilderOptions{},
+            localExecutor
+        );
+        CB_ENSURE_INTERNAL(
+            dataProviderBuilder,
+            "Failed to create data provider builder for visitor of type RawObjectsOrder";
+        );
+
+        TCBDsvDataLoader datasetLoader(
+            TLineDataLoaderPushArgs {
+                MakeHolder<TRangeLineDataReader>(
+                    GetLineDataReader(poolPath, dsvPoolFormatParams.Format),
+                    beginLineIdx,
+                    endLineIdx
+                ),
+
+                TDatasetLoaderCommonArgs {
+                    /*PairsFilePath*/ TPathWithScheme(),
+                    /*GroupWeightsFilePath*/ TPathWithScheme(),
+                    /*BaselineFilePath*/ TPathWithScheme(),
+                    classNames ? **classNames : TVector<TString>(),
+                    dsvPoolFormatParams.Format,
+                    MakeCdProviderFromFile(dsvPoolFormatParams.CdFilePath),
+                    ignoredFeatures,
+                    objectsOrder,
+                    10000, // TODO: make it a named constant
+                    localExecutor
+                }
+            }
+        );
+        datasetLoader.DoIfCompatible(dynamic_cast<IDatasetVisitor*>(dataProviderBuilder.Get()));
+        return dataProviderBuilder->GetResult();
+    }
+
     TDataProviders ReadTrainDatasets(
         const NCatboostOptions::TPoolLoadParams& loadOptions,
         EObjectsOrder objectsOrder,
@@ -59,6 +59,20 @@ namespace NCB {
         NPar::TLocalExecutor* localExecutor
     );
 
+    /* read only data lines with indices in [beginLineIdx, endLineIdx)
+     * Only CatBoost dsv format is supported
+     */
+    TDataProviderPtr ReadDatasetLinesRange(
+        const TPathWithScheme& poolPath,
+        ui64 beginLineIdx,
+        ui64 endLineIdx,
+        const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
+        const TVector<ui32>& ignoredFeatures,
+        EObjectsOrder objectsOrder,
+        TMaybe<TVector<TString>*> classNames,
+        NPar::TLocalExecutor* localExecutor
+    );
+
     TDataProviders ReadTrainDatasets(
         const NCatboostOptions::TPoolLoadParams& loadOptions,
         EObjectsOrder objectsOrder,
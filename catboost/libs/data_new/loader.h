@@ -17,6 +17,7 @@
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
 #include <util/generic/vector.h>
+#include <util/generic/ylimits.h>
 
 namespace NCB {
 
@@ -80,7 +81,13 @@ namespace NCB {
 
     struct IRawFeaturesOrderDatasetLoader : public IDatasetLoader {
         virtual EDatasetVisitorType GetVisitorType() const override {
-            return EDatasetVisitorType::RawObjectsOrder;
+            return EDatasetVisitorType::RawFeaturesOrder;
+        }
+
+        void DoIfCompatible(IDatasetVisitor* visitor) override {
+            auto compatibleVisitor = dynamic_cast<IRawFeaturesOrderDataVisitor*>(visitor);
+            CB_ENSURE_INTERNAL(compatibleVisitor, "visitor is incompatible with dataset loader");
+            Do(compatibleVisitor);
         }
 
         // Process all data
@@ -146,9 +153,15 @@ namespace NCB {
      *   Args, FeatureIds and DataMetaInfo are provided as commonly needed
      *   (but not related to async processing)
      *
-     *  Derived classes must implement GetObjectDount, StartBuilder and ProcessBlock
-     *  (and might redefine FinalizeBuilder, but common implementation is provided)
-     *  and then implement IRawObjectsOrderDatasetLoader like this:
+     *  Derived classes must implement StartBuilder and ProcessBlock
+     *  (and might redefine GetEstimatedObjectCount and FinalizeBuilder,
+     *   but common implementations are provided)
+     *
+     *  Data is read in a single pass, so the object count is known only after the last block
+     *  (and stdin and compressed streams can be loaded). The first block is read before the builder
+     *  is started, so GetEstimatedObjectCount can use it to estimate the count for preallocation.
+     *
+     *  Derived classes then implement IRawObjectsOrderDatasetLoader like this:
      *
      * > void Do(IRawObjectsOrderDataVisitor* visitor) override {
      * >      TBase::Do(GetReadFunc(), visitor);
@@ -170,8 +183,9 @@ namespace NCB {
     protected:
         template <class TReadDataFunc, class TReadBaselineFunc>
         void Do(TReadDataFunc readFunc, TReadBaselineFunc readBaselineFunc, IRawObjectsOrderDataVisitor* visitor) {
-            StartBuilder(false, GetObjectCount(), 0, visitor);
-            while (AsyncRowProcessor.ReadBlock(readFunc)) {
+            bool hasBlock = AsyncRowProcessor.ReadBlock(readFunc);
+            StartBuilder(false, GetEstimatedObjectCount(), 0, visitor);
+            for (; hasBlock; hasBlock = AsyncRowProcessor.ReadBlock(readFunc)) {
                 CB_ENSURE(!Args.BaselineFilePath.Inited() || AsyncBaselineRowProcessor.ReadBlock(readBaselineFunc), "Failed to read baseline");
                 ProcessBlock(visitor);
             }
@@ -201,7 +215,23 @@ namespace NCB {
         }
 
 
-        virtual ui32 GetObjectCount() = 0;
+        /* used only to preallocate visitor's storage, 0 if unknown
+         * called when the first block is in AsyncRowProcessor's parse buffer
+         */
+        virtual ui32 GetEstimatedObjectCount() {
+            return 0;
+        }
+
+        // valid after all data has been processed
+        ui32 GetObjectCount() const {
+            const size_t linesProcessed = AsyncRowProcessor.GetLinesProcessed();
+            CB_ENSURE(
+                linesProcessed <= Max<ui32>(), "CatBoost does not support datasets with more than "
+                << Max<ui32>() << " objects"
+            );
+            // cast is safe - was checked above
+            return (ui32)linesProcessed;
+        }
 
         virtual void StartBuilder(bool inBlock,
                                   ui32 objectCount, ui32 offset,
@@ -10,6 +10,7 @@
 #include <catboost/libs/helpers/mem_usage.h>
 #include <catboost/libs/helpers/resource_constrained_executor.h>
 #include <catboost/libs/logging/logging.h>
+#include <catboost/libs/quantization/quantile_sketch.h>
 #include <catboost/libs/quantization/utils.h>
 #include <catboost/libs/quantization_schema/quantize.h>
 
@@ -87,24 +88,57 @@ namespace NCB {
     }
 
 
+    static ui32 GetSampleSizeForBuildBorders(
+        ui32 objectCount,
+        EBorderSelectionType borderSelectionType,
+        const TQuantizationOptions& options
+    ) {
+        if (options.UseQuantileSketchesForBorders) {
+            return Min(objectCount, options.MaxSubsetSizeForSlowBuildBordersAlgorithms);
+        }
+        return GetSampleSizeForBorderSelectionType(
+            objectCount,
+            borderSelectionType,
+            options.MaxSubsetSizeForSlowBuildBordersAlgorithms
+        );
+    }
+
+
+    static ui32 GetQuantileSketchesBlockSize(ui32 objectCount, const NPar::TLocalExecutor& localExecutor) {
+        constexpr ui32 MIN_BLOCK_SIZE = 65536;
+
+        return Max(MIN_BLOCK_SIZE, CeilDiv<ui32>(objectCount, localExecutor.GetThreadCount() + 1));
+    }
+
+
     static ui64 EstimateMaxMemUsageForFloatFeature(
         ui32 objectCount,
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
         const TQuantizationOptions& options,
         bool doQuantization, // if false - only calc borders
-        bool clearSrcData
+        bool clearSrcData,
+        const NPar::TLocalExecutor& localExecutor
     ) {
         ui64 result = 0;
 
         if (NeedToCalcBorders(quantizedFeaturesInfo)) {
             //TODO(kirillovs): iterate through all per feature binarization settings and select smallest sample size
             const auto& floatFeatureBinarizationSettings = quantizedFeaturesInfo.GetFloatFeatureBinarization(Max<ui32>());
-            const ui32 sampleSize = GetSampleSizeForBorderSelectionType(
+            const ui32 sampleSize = GetSampleSizeForBuildBorders(
                 objectCount,
                 floatFeatureBinarizationSettings.BorderSelectionType,
-                options.MaxSubsetSizeForSlowBuildBordersAlgorithms
+                options
             );
 
+            if (options.UseQuantileSketchesForBorders) {
+                const ui32 blockSize = GetQuantileSketchesBlockSize(objectCount, localExecutor);
+                const ui32 blockCount = CeilDiv(Max<ui32>(objectCount, 1), blockSize);
+                result += blockCount * TQuantileSketch::EstimateMemoryUsage(blockSize);
+
+                // for weighted values in TQuantileSketch::GetSortedSample
+                result += (sizeof(float) + sizeof(ui64)) * TQuantileSketch::EstimateMemoryUsage(objectCount) / sizeof(float);
+            }
+
             result += sizeof(float) * sampleSize; // for copying to srcFeatureValuesForBuildBorders
 
             result += CalcMemoryForFindBestSplit(
@@ -124,44 +158,58 @@ namespace NCB {
     }
 
 
-    static void CalcBordersAndNanMode(
-        const TFloatValuesHolder& srcFeature,
-        const TFeaturesArraySubsetIndexing* subsetForBuildBorders,
-        const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
-        ENanMode* nanMode,
-        TVector<float>* borders
+    static TFloatFeatureValuesSummary BuildFloatFeatureValuesSummary(
+        const TMaybeOwningConstArraySubset<float, ui32>& srcData,
+        NPar::TLocalExecutor* localExecutor
     ) {
-        const auto& binarizationOptions = quantizedFeaturesInfo.GetFloatFeatureBinarization(srcFeature.GetId());
+        const auto& srcArray = *srcData.GetSrc();
+        const auto& subsetIndexing = *srcData.GetSubsetIndexing();
 
-        Y_VERIFY(binarizationOptions.BorderCount > 0);
+        const auto parallelUnitRanges = subsetIndexing.GetParallelUnitRanges(
+            GetQuantileSketchesBlockSize(srcData.Size(), *localExecutor)
+        );
 
-        TMaybeOwningConstArraySubset<float, ui32> srcFeatureData = srcFeature.GetArrayData();
+        TVector<TFloatFeatureValuesSummary> blockSummaries(parallelUnitRanges.RangesCount());
 
-        TMaybeOwningConstArraySubset<float, ui32> srcDataForBuildBorders(
-            srcFeatureData.GetSrc(),
-            subsetForBuildBorders
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                auto& blockSummary = blockSummaries[blockIdx];
+                subsetIndexing.ForEachInSubRange(
+                    parallelUnitRanges.GetRange(blockIdx),
+                    [&] (ui32 /*idx*/, ui32 srcIdx) {
+                        blockSummary.Add(srcArray[srcIdx]);
+                    }
+                );
+            },
+            0,
+            SafeIntegerCast<int>(parallelUnitRanges.RangesCount()),
+            NPar::TLocalExecutor::WAIT_COMPLETE
         );
 
-        // does not contain nans
-        TVector<float> srcFeatureValuesForBuildBorders;
-        srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
+        if (blockSummaries.empty()) {
+            return TFloatFeatureValuesSummary();
+        }
+        for (auto blockIdx : xrange<size_t>(1, blockSummaries.size())) {
+            blockSummaries[0].Merge(blockSummaries[blockIdx]);
+        }
+        return std::move(blockSummaries[0]);
+    }
 
-        bool hasNans = false;
-
-        srcDataForBuildBorders.ForEach(
-            [&] (ui32 /*idx*/, float value) {
-                if (IsNan(value)) {
-                    hasNans = true;
-                } else {
-                    srcFeatureValuesForBuildBorders.push_back(value);
-                }
-            }
-        );
 
+    // srcValues must not contain nans
+    static void CalcBordersAndNanModeFromValues(
+        ui32 featureId,
+        const NCatboostOptions::TBinarizationOptions& binarizationOptions,
+        TVector<float>&& srcValues,
+        bool valuesAreSorted,
+        bool hasNans,
+        ENanMode* nanMode,
+        TVector<float>* borders
+    ) {
         CB_ENSURE(
             (binarizationOptions.NanMode != ENanMode::Forbidden) ||
             !hasNans,
-            "Feature #" << srcFeature.GetId() << ": There are nan factors and nan values for "
+            "Feature #" << featureId << ": There are nan factors and nan values for "
             " float features are not allowed. Set nan_mode != Forbidden."
         );
 
@@ -177,9 +225,11 @@ namespace NCB {
 
         if (nonNanValuesBorderCount > 0) {
             borderSet = BestSplit(
-                srcFeatureValuesForBuildBorders,
+                srcValues,
                 nonNanValuesBorderCount,
-                binarizationOptions.BorderSelectionType
+                binarizationOptions.BorderSelectionType,
+                /*nanValueIsInfty*/ false,
+                valuesAreSorted
             );
 
             if (borderSet.contains(-0.0f)) { // BestSplit might add negative zeros
@@ -199,6 +249,73 @@ namespace NCB {
     }
 
 
+    static void CalcBordersAndNanMode(
+        const TFloatValuesHolder& srcFeature,
+        const TFeaturesArraySubsetIndexing* subsetForBuildBorders,
+        const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+        const TQuantizationOptions& options,
+        NPar::TLocalExecutor* localExecutor,
+        ENanMode* nanMode,
+        TVector<float>* borders
+    ) {
+        const auto& binarizationOptions = quantizedFeaturesInfo.GetFloatFeatureBinarization(srcFeature.GetId());
+
+        Y_VERIFY(binarizationOptions.BorderCount > 0);
+
+        TMaybeOwningConstArraySubset<float, ui32> srcFeatureData = srcFeature.GetArrayData();
+
+        TMaybeOwningConstArraySubset<float, ui32> srcDataForBuildBorders(
+            srcFeatureData.GetSrc(),
+            subsetForBuildBorders
+        );
+
+        if (options.UseQuantileSketchesForBorders) {
+            const TFloatFeatureValuesSummary summary = BuildFloatFeatureValuesSummary(
+                srcDataForBuildBorders,
+                localExecutor
+            );
+            CalcBordersAndNanModeFromSummary(
+                srcFeature.GetId(),
+                binarizationOptions,
+                summary,
+                GetSampleSizeForBuildBorders(
+                    SafeIntegerCast<ui32>(summary.Sketch.GetCount()),
+                    binarizationOptions.BorderSelectionType,
+                    options
+                ),
+                nanMode,
+                borders
+            );
+            return;
+        }
+
+        // does not contain nans
+        TVector<float> srcFeatureValuesForBuildBorders;
+        srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
+
+        bool hasNans = false;
+        srcDataForBuildBorders.ForEach(
+            [&] (ui32 /*idx*/, float value) {
+                if (IsNan(value)) {
+                    hasNans = true;
+                } else {
+                    srcFeatureValuesForBuildBorders.push_back(value);
+                }
+            }
+        );
+
+        CalcBordersAndNanModeFromValues(
+            srcFeature.GetId(),
+            binarizationOptions,
+            std::move(srcFeatureValuesForBuildBorders),
+            /*valuesAreSorted*/ false,
+            hasNans,
+            nanMode,
+            borders
+        );
+    }
+
+
     template <class TBase>
     static void SetBinaryFeatureColumn(
         ui32 featureId,
@@ -391,6 +508,8 @@ namespace NCB {
                 srcFeature,
                 subsetForBuildBorders,
                 *quantizedFeaturesInfo,
+                options,
+                localExecutor,
                 &nanMode,
                 &calculatedBorders
             );
@@ -627,13 +746,17 @@ namespace NCB {
             TObjectsGroupingPtr objectsGrouping = rawDataProvider->ObjectsGrouping;
 
             // already composed with rawDataProvider's Subset
-            TMaybe<TArraySubsetIndexing<ui32>> subsetForBuildBorders = GetSubsetForBuildBorders(
-                *(srcObjectsCommonData.SubsetIndexing),
-                *quantizedFeaturesInfo,
-                srcObjectsCommonData.Order,
-                options,
-                rand
-            );
+            // quantile sketches are built over all objects
+            TMaybe<TArraySubsetIndexing<ui32>> subsetForBuildBorders;
+            if (!options.UseQuantileSketchesForBorders) {
+                subsetForBuildBorders = GetSubsetForBuildBorders(
+                    *(srcObjectsCommonData.SubsetIndexing),
+                    *quantizedFeaturesInfo,
+                    srcObjectsCommonData.Order,
+                    options,
+                    rand
+                );
+            }
 
             TMaybe<TQuantizedForCPUBuilderData> data;
             TAtomicSharedPtr<TArraySubsetIndexing<ui32>> subsetIndexing;
@@ -672,7 +795,8 @@ namespace NCB {
                     *quantizedFeaturesInfo,
                     options,
                     !calcBordersAndNanModeOnly,
-                    clearSrcObjectsData
+                    clearSrcObjectsData,
+                    *localExecutor
                 );
 
                 featuresLayout->IterateOverAvailableFeatures<EFeatureType::Float>(
@@ -820,6 +944,54 @@ namespace NCB {
     };
 
 
+    void TFloatFeatureValuesSummary::Add(float value) {
+        Sketch.Add(value);
+        if (!IsNan(value)) {
+            MinValue = Min(MinValue, value);
+            MaxValue = Max(MaxValue, value);
+        }
+    }
+
+    void TFloatFeatureValuesSummary::Merge(const TFloatFeatureValuesSummary& rhs) {
+        Sketch.Merge(rhs.Sketch);
+        MinValue = Min(MinValue, rhs.MinValue);
+        MaxValue = Max(MaxValue, rhs.MaxValue);
+    }
+
+
+    void CalcBordersAndNanModeFromSummary(
+        ui32 featureId,
+        const NCatboostOptions::TBinarizationOptions& binarizationOptions,
+        const TFloatFeatureValuesSummary& summary,
+        ui32 maxSampleSize,
+        ENanMode* nanMode,
+        TVector<float>* borders
+    ) {
+        Y_VERIFY(binarizationOptions.BorderCount > 0);
+
+        TVector<float> sortedSample = summary.Sketch.GetSortedSample(
+            SafeIntegerCast<ui32>(Min<ui64>(summary.Sketch.GetCount(), maxSampleSize))
+        );
+        if (!sortedSample.empty()) {
+            if (sortedSample.front() != summary.MinValue) {
+                sortedSample.insert(sortedSample.begin(), summary.MinValue);
+            }
+            if (sortedSample.back() != summary.MaxValue) {
+                sortedSample.push_back(summary.MaxValue);
+            }
+        }
+        CalcBordersAndNanModeFromValues(
+            featureId,
+            binarizationOptions,
+            std::move(sortedSample),
+            /*valuesAreSorted*/ true,
+            summary.Sketch.GetNanCount() > 0,
+            nanMode,
+            borders
+        );
+    }
+
+
     void CalcBordersAndNanMode(
         const TQuantizationOptions& options,
         TRawDataProviderPtr rawDataProvider,
@@ -4,11 +4,14 @@
 #include "quantized_features_info.h"
 
 #include <catboost/libs/helpers/restorable_rng.h>
+#include <catboost/libs/quantization/quantile_sketch.h>
 
 #include <library/threading/local_executor/local_executor.h>
 
 #include <util/generic/ylimits.h>
 
+#include <limits>
+
 
 namespace NCB {
 
@@ -20,10 +23,44 @@ namespace NCB {
         bool PackBinaryFeaturesForCpu = true;
         bool AllowWriteFiles = true;
 
+        /* calc borders from mergeable quantile sketches of all feature values (built in parallel by
+         * object blocks) instead of a random subset of objects.
+         * Border selection algorithms then get a sorted sample of at most
+         * MaxSubsetSizeForSlowBuildBordersAlgorithms values for any BorderSelectionType.
+         */
+        bool UseQuantileSketchesForBorders = false;
+
         // TODO(akhropov): remove after checking global tests consistency
         bool CpuCompatibilityShuffleOverFullData = true;
     };
 
+    /* all values of a float feature summarized for border selection, summaries of disjoint parts
+     * of data (e.g. blocks of a pool that does not fit in memory) can be merged
+     */
+    struct TFloatFeatureValuesSummary {
+        TQuantileSketch Sketch;
+
+        // exact, sketch sample may lose rare extreme values
+        float MinValue = std::numeric_limits<float>::max();
+        float MaxValue = std::numeric_limits<float>::lowest();
+
+    public:
+        void Add(float value);
+        void Merge(const TFloatFeatureValuesSummary& rhs);
+    };
+
+    /* borders are selected on a sorted sample of at most maxSampleSize values of summary.Sketch
+     * extended with exact min and max values
+     */
+    void CalcBordersAndNanModeFromSummary(
+        ui32 featureId,
+        const NCatboostOptions::TBinarizationOptions& binarizationOptions,
+        const TFloatFeatureValuesSummary& summary,
+        ui32 maxSampleSize,
+        ENanMode* nanMode,
+        TVector<float>* borders
+    );
+
     void CalcBordersAndNanMode(
         const TQuantizationOptions& options,
         TRawDataProviderPtr rawDataProvider,
@@ -214,4 +214,21 @@ namespace NCB {
         );
     }
 
+    void TQuantizedFeaturesInfo::SaveWithFeaturesLayout(IBinSaver* binSaver) const {
+        binSaver->Add(0, FeaturesLayout.Get());
+        SaveNonSharedPart(binSaver);
+    }
+
+    TIntrusivePtr<TQuantizedFeaturesInfo> TQuantizedFeaturesInfo::LoadWithFeaturesLayout(IBinSaver* binSaver) {
+        TFeaturesLayout featuresLayout;
+        binSaver->Add(0, &featuresLayout);
+        auto quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+            featuresLayout,
+            TConstArrayRef<ui32>(),
+            NCatboostOptions::TBinarizationOptions()
+        );
+        quantizedFeaturesInfo->LoadNonSharedPart(binSaver);
+        return quantizedFeaturesInfo;
+    }
+
 }
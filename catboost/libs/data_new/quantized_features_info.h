@@ -155,6 +155,12 @@ namespace NCB {
 
         ui32 CalcCheckSum() const;
 
+        /* serialization with FeaturesLayout
+         * used to pass quantization schema alone, e.g. from master to workers in distributed training
+         */
+        void SaveWithFeaturesLayout(IBinSaver* binSaver) const;
+        static TIntrusivePtr<TQuantizedFeaturesInfo> LoadWithFeaturesLayout(IBinSaver* binSaver);
+
     private:
         void LoadNonSharedPart(IBinSaver* binSaver);
         void SaveNonSharedPart(IBinSaver* binSaver) const;
@@ -0,0 +1,175 @@
+#include <catboost/libs/data_new/ut/lib/for_data_provider.h>
+
+#include <catboost/libs/data_new/columnar_loader.h>
+#include <catboost/libs/data_new/load_data.h>
+
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/data_new/objects_grouping.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/maybe.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/string.h>
+#include <util/generic/ylimits.h>
+#include <util/stream/file.h>
+#include <util/stream/str.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
+
+#include <library/unittest/registar.h>
+
+#include <cstring>
+
+
+using namespace NCB;
+using namespace NCB::NDataNewUT;
+
+
+template <class T>
+static TConstArrayRef<ui8> AsBytes(const TVector<T>& data) {
+    return MakeArrayRef(reinterpret_cast<const ui8*>(data.data()), data.size() * sizeof(T));
+}
+
+
+Y_UNIT_TEST_SUITE(LoadDataFromColumnar) {
+    Y_UNIT_TEST(ReadDataset) {
+        const TVector<float> target = {0.5f, 1.0f, 0.0f, 0.25f, 1.0f, 0.0f};
+        const TVector<i64> groupIds = {10, 10, 11, 12, 12, 12};
+        const TVector<float> weights = {0.12f, 0.18f, 1.0f, 0.45f, 1.0f, 2.0f};
+        const TVector<float> f0 = {0.1f, 0.97f, 0.13f, 0.14f, 0.9f, 0.66f};
+        const TVector<i32> c1 = {1, 2, 1, 1, -3, 2};
+        const TVector<float> f2 = {0.2f, 0.82f, 0.22f, 0.18f, 0.67f, 0.1f};
+        const TVector<i64> sampleIds = {0, 1, 2, 3, 4, 5};
+
+        const TVector<TColumnarPoolColumn> columns = {
+            {EColumn::Label, "", EColumnarValueType::Float32, AsBytes(target)},
+            {EColumn::GroupId, "", EColumnarValueType::Int64, AsBytes(groupIds)},
+            {EColumn::Weight, "", EColumnarValueType::Float32, AsBytes(weights)},
+            {EColumn::Num, "f0", EColumnarValueType::Float32, AsBytes(f0)},
+            {EColumn::Categ, "c1", EColumnarValueType::Int32, AsBytes(c1)},
+            {EColumn::Num, "f2", EColumnarValueType::Float32, AsBytes(f2)},
+            {EColumn::SampleId, "", EColumnarValueType::Int64, AsBytes(sampleIds)}
+        };
+
+        TTempFile poolFile(MakeTempName());
+        {
+            TFileOutput output(poolFile.Name());
+            SaveColumnarPool(target.size(), columns, &output);
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TDataProviderPtr dataProvider = ReadDataset(
+            TPathWithScheme(poolFile.Name(), "columnar"),
+            TPathWithScheme(),
+            TPathWithScheme(),
+            TPathWithScheme(),
+            NCatboostOptions::TDsvPoolFormatParams(),
+            /*ignoredFeatures*/ {},
+            EObjectsOrder::Ordered,
+            /*classNames*/ Nothing(),
+            &localExecutor
+        );
+
+
+        TExpectedRawData expectedData;
+
+        TDataColumnsMetaInfo dataColumnsMetaInfo;
+        dataColumnsMetaInfo.Columns = {
+            {EColumn::Label, ""},
+            {EColumn::GroupId, ""},
+            {EColumn::Weight, ""},
+            {EColumn::Num, "f0"},
+            {EColumn::Categ, "c1"},
+            {EColumn::Num, "f2"},
+            {EColumn::SampleId, ""}
+        };
+
+        TVector<TString> featureId = {"f0", "c1", "f2"};
+
+        expectedData.MetaInfo = TDataMetaInfo(std::move(dataColumnsMetaInfo), false, false, /* additionalBaselineCount */ Nothing(), &featureId);
+        expectedData.Objects.Order = EObjectsOrder::Ordered;
+        expectedData.Objects.GroupIds = TVector<TStringBuf>{"10", "10", "11", "12", "12", "12"};
+        expectedData.Objects.FloatFeatures = {f0, f2};
+        expectedData.Objects.CatFeatures = {
+            TVector<TStringBuf>{"1", "2", "1", "1", "-3", "2"}
+        };
+
+        expectedData.ObjectsGrouping = TObjectsGrouping(
+            TVector<TGroupBounds>{{0, 2}, {2, 3}, {3, 6}}
+        );
+        expectedData.Target.Target = TVector<TString>{"0.5", "1", "0", "0.25", "1", "0"};
+        expectedData.Target.Weights = TWeights<float>(TVector<float>(weights));
+        expectedData.Target.GroupWeights = TWeights<float>(6);
+
+        Compare<TRawObjectsDataProvider>(std::move(dataProvider), expectedData);
+    }
+
+    Y_UNIT_TEST(ColumnDataOffsetOverflow) {
+        const TVector<float> f0 = {0.1f, 0.97f};
+        const TVector<TColumnarPoolColumn> columns = {
+            {EColumn::Num, "f0", EColumnarValueType::Float32, AsBytes(f0)}
+        };
+        TString pool;
+        {
+            TStringOutput output(pool);
+            SaveColumnarPool(f0.size(), columns, &output);
+        }
+
+        // data offset of the only column is the last field of the header, offset + data size overflows ui64
+        const size_t headerSize = sizeof("CatboostColumnarPool") + sizeof(ui32) + sizeof(ui64) + sizeof(ui32)
+            + sizeof(ui32) + TStringBuf("Num").size() + sizeof(ui32) + TStringBuf("f0").size()
+            + sizeof(ui8) + sizeof(ui64);
+        const ui64 dataOffset = Max<ui64>() - COLUMNAR_POOL_DATA_ALIGNMENT + 1;
+        memcpy(pool.begin() + headerSize - sizeof(ui64), &dataOffset, sizeof(ui64));
+
+        TTempFile poolFile(MakeTempName());
+        {
+            TFileOutput output(poolFile.Name());
+            output << pool;
+        }
+
+        NPar::TLocalExecutor localExecutor;
+
+        UNIT_ASSERT_EXCEPTION(
+            ReadDataset(
+                TPathWithScheme(poolFile.Name(), "columnar"),
+                TPathWithScheme(),
+                TPathWithScheme(),
+                TPathWithScheme(),
+                NCatboostOptions::TDsvPoolFormatParams(),
+                /*ignoredFeatures*/ {},
+                EObjectsOrder::Undefined,
+                /*classNames*/ Nothing(),
+                &localExecutor
+            ),
+            TCatBoostException
+        );
+    }
+
+    Y_UNIT_TEST(WrongMagic) {
+        TTempFile poolFile(MakeTempName());
+        {
+            TFileOutput output(poolFile.Name());
+            output << "0\t0.1\t0.2\n";
+        }
+
+        NPar::TLocalExecutor localExecutor;
+
+        UNIT_ASSERT_EXCEPTION(
+            ReadDataset(
+                TPathWithScheme(poolFile.Name(), "columnar"),
+                TPathWithScheme(),
+                TPathWithScheme(),
+                TPathWithScheme(),
+                NCatboostOptions::TDsvPoolFormatParams(),
+                /*ignoredFeatures*/ {},
+                EObjectsOrder::Undefined,
+                /*classNames*/ Nothing(),
+                &localExecutor
+            ),
+            TCatBoostException
+        );
+    }
+}
@@ -11,6 +11,12 @@
 #include <util/generic/fwd.h>
 #include <util/generic/maybe.h>
 #include <util/generic/strbuf.h>
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
+#include <util/stream/zlib.h>
+#include <util/string/cast.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
 
 #include <library/unittest/registar.h>
 
@@ -703,4 +709,89 @@ Y_UNIT_TEST_SUITE(LoadDataFromDsv) {
             Test(testCase);
         }
     }
+
+    // data is read in a single pass, object count is not known until the last block
+    Y_UNIT_TEST(ReadGzippedDatasetInSeveralBlocks) {
+        const ui32 objectCount = 25003;
+
+        TSrcData srcData;
+        srcData.CdFileData = AsStringBuf(
+            "0\tTarget\n"
+            "1\tGroupId\n"
+            "2\tWeight\n"
+            "3\tNum\tf0\n"
+        );
+
+        TVector<TString> groupIdStrings;
+        TExpectedRawData expectedData;
+        TVector<float> weights;
+        TVector<float> f0;
+        TVector<TString> target;
+        TVector<TGroupBounds> groupsBounds;
+
+        TString dsvFileData;
+        for (auto objectIdx : xrange(objectCount)) {
+            const ui32 groupIdx = objectIdx / 4;
+            groupIdStrings.push_back("query" + ToString(groupIdx));
+            weights.push_back(float(objectIdx % 3 + 1));
+            f0.push_back(float(objectIdx));
+            target.push_back(ToString(objectIdx % 2));
+            if (objectIdx % 4 == 0) {
+                groupsBounds.push_back(TGroupBounds{objectIdx, Min(objectIdx + 4, objectCount)});
+            }
+
+            dsvFileData += target.back() + "\t" + groupIdStrings.back() + "\t"
+                + ToString(weights.back()) + "\t" + ToString(f0.back()) + "\n";
+        }
+
+        TReadDatasetMainParams readDatasetMainParams;
+        TVector<THolder<TTempFile>> srcDataFiles;
+        SaveSrcData(srcData, &readDatasetMainParams, &srcDataFiles);
+
+        TTempFile tmpFile(MakeTempName());
+        TTempFile poolFile(tmpFile.Name() + ".gz");
+        {
+            TFileOutput output(poolFile.Name());
+            TZLibCompress compressor(&output, ZLib::GZip);
+            compressor.Write(dsvFileData);
+            compressor.Finish();
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TDataProviderPtr dataProvider = ReadDataset(
+            TPathWithScheme(poolFile.Name()),
+            TPathWithScheme(),
+            TPathWithScheme(),
+            TPathWithScheme(),
+            readDatasetMainParams.DsvPoolFormatParams,
+            /*ignoredFeatures*/ {},
+            EObjectsOrder::Undefined,
+            /*classNames*/ Nothing(),
+            &localExecutor
+        );
+
+        TDataColumnsMetaInfo dataColumnsMetaInfo;
+        dataColumnsMetaInfo.Columns = {
+            {EColumn::Label, ""},
+            {EColumn::GroupId, ""},
+            {EColumn::Weight, ""},
+            {EColumn::Num, "f0"}
+        };
+
+        TVector<TString> featureId = {"f0"};
+
+        expectedData.MetaInfo = TDataMetaInfo(std::move(dataColumnsMetaInfo), false, false, /* additionalBaselineCount */ Nothing(), &featureId);
+        expectedData.Objects.Order = EObjectsOrder::Undefined;
+        expectedData.Objects.GroupIds = TVector<TStringBuf>(groupIdStrings.begin(), groupIdStrings.end());
+        expectedData.Objects.FloatFeatures = {f0};
+
+        expectedData.ObjectsGrouping = TObjectsGrouping(std::move(groupsBounds));
+        expectedData.Target.Target = std::move(target);
+        expectedData.Target.Weights = TWeights<float>(std::move(weights));
+        expectedData.Target.GroupWeights = TWeights<float>(objectCount);
+
+        Compare<TRawObjectsDataProvider>(std::move(dataProvider), expectedData);
+    }
 }
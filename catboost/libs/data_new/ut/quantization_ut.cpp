@@ -388,6 +388,96 @@ Y_UNIT_TEST_SUITE(Quantization) {
         Test(std::move(generateTestCase));
     }
 
+    Y_UNIT_TEST(TestFloatFeaturesBordersWithQuantileSketches) {
+        constexpr auto quiet_NaN = std::numeric_limits<float>::quiet_NaN();
+
+        TVector<TVector<float>> floatFeatures = {
+            {0.12f, 0.33f, 0.0f, 0.11f, 0.9f, 0.67f, 1.2f, 2.1f, 0.56f, 0.31f, 0.0f, 0.21f, 2.0f},
+            {0.88f, 0.0f, 0.12f, quiet_NaN, 0.45f, 0.19f, quiet_NaN, 0.82f, 0.11f, 0.31f, 0.31f, 0.22f, 0.67f}
+        };
+
+        TDataColumnsMetaInfo dataColumnsMetaInfo;
+        dataColumnsMetaInfo.Columns = {
+            {EColumn::Label, ""},
+            {EColumn::Num, ""},
+            {EColumn::Num, ""}
+        };
+
+        TVector<TString> featureId = {"f0", "f1"};
+
+        TDataMetaInfo metaInfo(std::move(dataColumnsMetaInfo), false, false, Nothing(), &featureId);
+
+        NCatboostOptions::TBinarizationOptions binarizationOptions(
+            EBorderSelectionType::GreedyLogSum,
+            4,
+            ENanMode::Min
+        );
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        // sketches are exact for small data so borders must be the same
+        TVector<TQuantizedFeaturesInfoPtr> quantizedFeaturesInfos;
+        for (bool useQuantileSketchesForBorders : {false, true}) {
+            TRawBuilderData srcData;
+            srcData.MetaInfo = metaInfo;
+            srcData.TargetData.Target = {"0", "1", "1", "0", "1", "0", "1", "0", "0", "1", "0", "0", "0"};
+            srcData.TargetData.SetTrivialWeights(13);
+            srcData.CommonObjectsData.FeaturesLayout = srcData.MetaInfo.FeaturesLayout;
+            srcData.CommonObjectsData.SubsetIndexing = MakeAtomicShared<TArraySubsetIndexing<ui32>>(
+                TFullSubset<ui32>(13)
+            );
+
+            ui32 featureIdx = 0;
+            InitFeatures(
+                floatFeatures,
+                *srcData.CommonObjectsData.SubsetIndexing,
+                &featureIdx,
+                &srcData.ObjectsData.FloatFeatures
+            );
+
+            TRawDataProviderPtr rawDataProvider = MakeDataProvider<TRawObjectsDataProvider>(
+                Nothing(),
+                std::move(srcData),
+                false,
+                &localExecutor
+            );
+
+            quantizedFeaturesInfos.push_back(
+                MakeIntrusive<TQuantizedFeaturesInfo>(
+                    *metaInfo.FeaturesLayout,
+                    TConstArrayRef<ui32>(),
+                    binarizationOptions
+                )
+            );
+
+            TQuantizationOptions quantizationOptions;
+            quantizationOptions.UseQuantileSketchesForBorders = useQuantileSketchesForBorders;
+
+            TRestorableFastRng64 rand(0);
+
+            CalcBordersAndNanMode(
+                quantizationOptions,
+                rawDataProvider,
+                quantizedFeaturesInfos.back(),
+                &rand,
+                &localExecutor
+            );
+        }
+
+        for (auto floatFeatureIdx : xrange(floatFeatures.size())) {
+            const TFloatFeatureIdx typedIdx(floatFeatureIdx);
+            UNIT_ASSERT_EQUAL(
+                quantizedFeaturesInfos[0]->GetNanMode(typedIdx),
+                quantizedFeaturesInfos[1]->GetNanMode(typedIdx)
+            );
+            UNIT_ASSERT_VALUES_EQUAL(
+                quantizedFeaturesInfos[0]->GetBorders(typedIdx),
+                quantizedFeaturesInfos[1]->GetBorders(typedIdx)
+            );
+        }
+    }
+
     Y_UNIT_TEST(TestFloatFeaturesWithNanModeMax) {
         auto generateTestCase = [](bool packBinaryFeatures) {
             TTestCase testCase;
@@ -14,6 +14,7 @@
 #include <catboost/libs/quantization_schema/schema.h>
 
 #include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
 #include <util/generic/strbuf.h>
@@ -148,6 +149,13 @@ namespace NCB {
         // shared ownership is passed to IRawFeaturesOrderDataVisitor
         virtual void AddCatFeature(ui32 flatFeatureIdx, TMaybeOwningConstArrayHolder<ui32> features) = 0;
 
+        // same, hashToString must contain string values of all hashes in features
+        virtual void AddCatFeature(
+            ui32 flatFeatureIdx,
+            TMaybeOwningConstArrayHolder<ui32> features,
+            THashMap<ui32, TString>&& hashToString
+        ) = 0;
+
 
         // TRawTargetData
 
@@ -24,7 +24,7 @@ namespace NCB {
 
     struct TFSExistsChecker : public IExistsChecker {
         bool Exists(const TPathWithScheme& pathWithScheme) const override {
-            return NFs::Exists(pathWithScheme.Path);
+            return IsStdInPath(pathWithScheme.Path) || NFs::Exists(pathWithScheme.Path);
         }
     };
 
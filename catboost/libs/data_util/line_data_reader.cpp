@@ -2,8 +2,13 @@
 
 #include <catboost/libs/helpers/exception.h>
 
+#include <util/stream/buffered.h>
 #include <util/stream/file.h>
+#include <util/stream/input.h>
+#include <util/stream/zlib.h>
+#include <util/generic/utility.h>
 #include <util/system/fs.h>
+#include <util/system/fstat.h>
 
 
 namespace NCB {
@@ -17,42 +22,122 @@ namespace NCB {
     }
 
 
+    TRangeLineDataReader::TRangeLineDataReader(
+        THolder<ILineDataReader>&& srcReader,
+        ui64 beginLineIdx,
+        ui64 endLineIdx)
+        : SrcReader(std::move(srcReader))
+        , BeginLineIdx(beginLineIdx)
+        , EndLineIdx(endLineIdx)
+    {
+        CB_ENSURE(BeginLineIdx <= EndLineIdx, "TRangeLineDataReader: begin line index > end line index");
+    }
+
+    ui64 TRangeLineDataReader::GetDataLineCount() {
+        const ui64 srcLineCount = SrcReader->GetDataLineCount();
+        CB_ENSURE(
+            srcLineCount >= EndLineIdx,
+            "TRangeLineDataReader: source has " << srcLineCount << " data lines, less than range end "
+            << EndLineIdx
+        );
+        return EndLineIdx - BeginLineIdx;
+    }
+
+    TMaybe<TString> TRangeLineDataReader::GetHeader() {
+        return SrcReader->GetHeader();
+    }
+
+    bool TRangeLineDataReader::ReadLine(TString* line) {
+        for (; NextLineIdx < BeginLineIdx; ++NextLineIdx) {
+            CB_ENSURE(
+                SrcReader->ReadLine(line),
+                "TRangeLineDataReader: source has " << NextLineIdx << " data lines, less than range begin "
+                << BeginLineIdx
+            );
+        }
+        if (NextLineIdx == EndLineIdx) {
+            return false;
+        }
+        if (!SrcReader->ReadLine(line)) {
+            return false;
+        }
+        ++NextLineIdx;
+        return true;
+    }
+
+
     namespace {
 
-    template <class TStr>
-    inline int CountLines(const TStr& poolFile) {
-        CB_ENSURE(NFs::Exists(TString(poolFile)), "pool file '" << TString(poolFile) << "' is not found");
-        TIFStream reader(poolFile.c_str());
-        size_t count = 0;
-        TString buffer;
-        while (reader.ReadLine(buffer)) {
-            ++count;
+    // TBufferedZLibDecompress does not own its slave stream
+    class TZLibDecompressFileInput : public IInputStream {
+    public:
+        explicit TZLibDecompressFileInput(const TString& path)
+            : FileInput(path)
+            , Decompress(&FileInput, ZLib::GZip)
+        {}
+
+    private:
+        size_t DoRead(void* buf, size_t len) override {
+            return Decompress.Read(buf, len);
+        }
+
+    private:
+        TIFStream FileInput;
+        TBufferedZLibDecompress Decompress;
+    };
+
+    THolder<IInputStream> OpenInput(const TString& path) {
+        if (IsStdInPath(path)) {
+            return MakeHolder<TBufferedInput>(&Cin);
         }
-        return count;
+        CB_ENSURE(NFs::Exists(path), "pool file '" << path << "' is not found");
+        if (path.EndsWith(".gz")) {
+            return MakeHolder<TZLibDecompressFileInput>(path);
+        }
+        return MakeHolder<TIFStream>(path);
     }
 
     class TFileLineDataReader : public ILineDataReader {
     public:
         TFileLineDataReader(const TLineDataReaderArgs& args)
             : Args(args)
-            , IFStream(args.PathWithScheme.Path)
+            , Input(OpenInput(args.PathWithScheme.Path))
             , HeaderProcessed(!Args.Format.HasHeader)
         {}
 
         ui64 GetDataLineCount() override {
-            ui64 nLines = (ui64)CountLines(Args.PathWithScheme.Path);
+            CB_ENSURE(
+                !IsStdInPath(Args.PathWithScheme.Path),
+                "TFileLineDataReader: cannot count lines in stdin without consuming it"
+            );
+            ui64 nLines = 0;
+            THolder<IInputStream> input = OpenInput(Args.PathWithScheme.Path);
+            TString buffer;
+            while (input->ReadLine(buffer)) {
+                ++nLines;
+            }
             if (Args.Format.HasHeader) {
                 --nLines;
             }
             return nLines;
         }
 
+        TMaybe<ui64> GetDataSize() override {
+            const TString& path = Args.PathWithScheme.Path;
+            if (IsStdInPath(path) || path.EndsWith(".gz")) {
+                return Nothing();
+            }
+            const ui64 fileSize = TFileStat(path).Size;
+            return fileSize - Min(fileSize, HeaderSize);
+        }
+
         TMaybe<TString> GetHeader() override {
             if (Args.Format.HasHeader) {
                 CB_ENSURE(!HeaderProcessed, "TFileLineDataReader: multiple calls to GetHeader");
                 TString header;
-                CB_ENSURE(IFStream.ReadLine(header), "TFileLineDataReader: no header in file");
+                CB_ENSURE(Input->ReadLine(header), "TFileLineDataReader: no header in file");
                 HeaderProcessed = true;
+                HeaderSize = header.size() + 1; // with line end
                 return header;
             }
 
@@ -64,13 +149,14 @@ namespace NCB {
             if (!HeaderProcessed) {
                 GetHeader();
             }
-            return IFStream.ReadLine(*line) != 0;
+            return Input->ReadLine(*line) != 0;
         }
 
     private:
         TLineDataReaderArgs Args;
-        TIFStream IFStream;
+        THolder<IInputStream> Input;
         bool HeaderProcessed;
+        ui64 HeaderSize = 0;
     };
 
 
@@ -25,9 +25,17 @@ namespace NCB {
     struct ILineDataReader {
         /* returns number of data lines (w/o header, if present)
            in some cases (e.g. for files, could be expensive)
+           data loaders do not need it - object count is determined when all data has been read
         */
         virtual ui64 GetDataLineCount() = 0;
 
+        /* returns size in bytes of data lines (w/o header, if present) if it is known without reading the data
+           (not known for stdin or compressed files for example)
+        */
+        virtual TMaybe<ui64> GetDataSize() {
+            return Nothing();
+        }
+
         /* call before any calls to NextLine if you need it
            it is an error to call GetHeader after any ReadLine calls
         */
@@ -41,6 +49,26 @@ namespace NCB {
         virtual ~ILineDataReader() = default;
     };
 
+    /* reads only data lines with indices in [beginLineIdx, endLineIdx) of srcReader,
+       header (if present) is returned as is
+    */
+    class TRangeLineDataReader : public ILineDataReader {
+    public:
+        TRangeLineDataReader(THolder<ILineDataReader>&& srcReader, ui64 beginLineIdx, ui64 endLineIdx);
+
+        ui64 GetDataLineCount() override;
+
+        TMaybe<TString> GetHeader() override;
+
+        bool ReadLine(TString* line) override;
+
+    private:
+        THolder<ILineDataReader> SrcReader;
+        ui64 BeginLineIdx;
+        ui64 EndLineIdx;
+        ui64 NextLineIdx = 0;
+    };
+
     using TLineDataReaderFactory =
         NObjectFactory::TParametrizedObjectFactory<ILineDataReader, TString, TLineDataReaderArgs>;
 
@@ -40,6 +40,12 @@ namespace NCB {
     };
 
 
+    // '-' path means standard input
+    inline bool IsStdInPath(TStringBuf path) {
+        return path == AsStringBuf("-");
+    }
+
+
     template <class ISchemeDependentProcessor, class... TArgs>
     THolder<ISchemeDependentProcessor> GetProcessor(TPathWithScheme pathWithScheme, TArgs&&... args) {
         auto res = NObjectFactory::TParametrizedObjectFactory<ISchemeDependentProcessor, TString, TArgs...>::Construct(
@@ -0,0 +1,81 @@
+#include <library/unittest/registar.h>
+
+#include <catboost/libs/data_util/line_data_reader.h>
+
+#include <util/generic/vector.h>
+
+
+using namespace NCB;
+
+
+namespace {
+    class TVectorLineDataReader : public ILineDataReader {
+    public:
+        TVectorLineDataReader(TMaybe<TString> header, TVector<TString> lines)
+            : Header(std::move(header))
+            , Lines(std::move(lines))
+        {}
+
+        ui64 GetDataLineCount() override {
+            return Lines.size();
+        }
+
+        TMaybe<TString> GetHeader() override {
+            return Header;
+        }
+
+        bool ReadLine(TString* line) override {
+            if (NextLine == Lines.size()) {
+                return false;
+            }
+            *line = Lines[NextLine++];
+            return true;
+        }
+
+    private:
+        TMaybe<TString> Header;
+        TVector<TString> Lines;
+        size_t NextLine = 0;
+    };
+
+    TVector<TString> ReadAll(ILineDataReader* reader) {
+        TVector<TString> result;
+        TString line;
+        while (reader->ReadLine(&line)) {
+            result.push_back(line);
+        }
+        return result;
+    }
+}
+
+
+Y_UNIT_TEST_SUITE(TRangeLineDataReader) {
+    Y_UNIT_TEST(ReadsOnlyRange) {
+        const TVector<TString> lines = {"0", "1", "2", "3", "4"};
+
+        TRangeLineDataReader reader(MakeHolder<TVectorLineDataReader>(TString("h"), lines), 1, 4);
+        UNIT_ASSERT_VALUES_EQUAL(reader.GetDataLineCount(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(*reader.GetHeader(), "h");
+        UNIT_ASSERT_VALUES_EQUAL(ReadAll(&reader), TVector<TString>({"1", "2", "3"}));
+    }
+
+    Y_UNIT_TEST(FullAndEmptyRanges) {
+        const TVector<TString> lines = {"0", "1", "2"};
+
+        TRangeLineDataReader fullReader(MakeHolder<TVectorLineDataReader>(Nothing(), lines), 0, 3);
+        UNIT_ASSERT(!fullReader.GetHeader());
+        UNIT_ASSERT_VALUES_EQUAL(ReadAll(&fullReader), lines);
+
+        TRangeLineDataReader emptyReader(MakeHolder<TVectorLineDataReader>(Nothing(), lines), 2, 2);
+        UNIT_ASSERT(ReadAll(&emptyReader).empty());
+    }
+
+    Y_UNIT_TEST(RangeBeyondData) {
+        const TVector<TString> lines = {"0", "1", "2"};
+
+        TRangeLineDataReader reader(MakeHolder<TVectorLineDataReader>(Nothing(), lines), 4, 5);
+        UNIT_ASSERT_EXCEPTION(reader.GetDataLineCount(), TCatBoostException);
+        TString line;
+        UNIT_ASSERT_EXCEPTION(reader.ReadLine(&line), TCatBoostException);
+    }
+}
@@ -3,25 +3,32 @@
 #include <catboost/libs/algo/calc_score_cache.h>
 #include <catboost/libs/algo/fold.h>
 #include <catboost/libs/algo/learn_context.h>
+#include <catboost/libs/algo/online_ctr.h>
 #include <catboost/libs/algo/online_predictor.h>
 #include <catboost/libs/algo/pairwise_scoring.h>
 #include <catboost/libs/algo/score_bin.h>
 #include <catboost/libs/algo/target_classifier.h>
 #include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/data_new/quantized_features_info.h>
+#include <catboost/libs/data_util/path_with_scheme.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/libs/helpers/serialization.h>
 #include <catboost/libs/metrics/metric.h>
 #include <catboost/libs/options/catboost_options.h>
 #include <catboost/libs/options/enums.h>
+#include <catboost/libs/options/load_options.h>
 #include <catboost/libs/options/restrictions.h>
 
 #include <library/binsaver/bin_saver.h>
 #include <library/par/par.h>
 #include <library/par/par_util.h>
 
+#include <util/datetime/base.h>
+#include <util/generic/map.h>
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
 #include <util/generic/singleton.h>
+#include <util/system/spinlock.h>
 
 #define SHARED_ID_TRAIN_DATA                (0xd66d480)
 
@@ -60,8 +67,65 @@ namespace NCatboostDistributed {
 
     using TWorkerPairwiseStats = TVector<TVector<TPairwiseStats>>; // [cand][subCand]
 
+    struct TOnlineCtrProjection {
+        TProjection Projection;
+        TVector<TCtrInfo> CtrInfo;
+
+    public:
+        SAVELOAD(Projection, CtrInfo);
+    };
+
+    // [projection], Nothing if worker already has ctr values of projection
+    using TWorkerOnlineCtrStats = TVector<TMaybe<TOnlineCtrPartStats>>;
+
+    // counts of objects preceding the learn data part of the worker the prefix is sent to
+    struct TOnlineCtrPrefix {
+        TOnlineCtrProjection Ctr;
+        TOnlineCtrPartPrefix Prefix;
+
+    public:
+        SAVELOAD(Ctr, Prefix);
+    };
+
+    // part of learn data that worker loads and quantizes itself, see TSystemOptions::WorkersLoadLearnData
+    struct TLocalLearnDataSource {
+        NCB::TPathWithScheme PoolPath; // uninited if data is sent by master
+        NCatboostOptions::TDsvPoolFormatParams DsvPoolFormatParams;
+        TVector<ui32> IgnoredFeatures;
+        TVector<TString> ClassNames;
+        ui64 BeginLineIdx = 0;
+        ui64 EndLineIdx = 0;
+        NCB::TQuantizedFeaturesInfoPtr QuantizedFeaturesInfo; // borders are computed by master
+        TString MulticlassLabelParams; // empty if label converter is not used
+
+    public:
+        int operator&(IBinSaver& binSaver) {
+            binSaver.AddMulti(
+                PoolPath.Scheme,
+                PoolPath.Path,
+                DsvPoolFormatParams.Format.HasHeader,
+                DsvPoolFormatParams.Format.Delimiter,
+                DsvPoolFormatParams.CdFilePath.Scheme,
+                DsvPoolFormatParams.CdFilePath.Path,
+                IgnoredFeatures,
+                ClassNames,
+                BeginLineIdx,
+                EndLineIdx,
+                MulticlassLabelParams);
+            if (PoolPath.Inited()) {
+                if (binSaver.IsReading()) {
+                    QuantizedFeaturesInfo = NCB::TQuantizedFeaturesInfo::LoadWithFeaturesLayout(&binSaver);
+                } else {
+                    QuantizedFeaturesInfo->SaveWithFeaturesLayout(&binSaver);
+                }
+            }
+            return 0;
+        }
+    };
+
     struct TTrainData : public IObjectBase {
-        NCB::TTrainingForCPUDataProviderPtr TrainData;
+        NCB::TTrainingForCPUDataProviderPtr TrainData; // nullptr if LearnDataSource is used
+        TLocalLearnDataSource LearnDataSource;
         TVector<TTargetClassifier> TargetClassifiers;
         ui64 RandomSeed;
         int ApproxDimension;
@@ -74,6 +138,7 @@ namespace NCatboostDistributed {
     public:
         TTrainData() = default;
         TTrainData(NCB::TTrainingForCPUDataProviderPtr trainData,
+            TLocalLearnDataSource&& learnDataSource,
             const TVector<TTargetClassifier>& targetClassifiers,
             ui64 randomSeed,
             int approxDimension,
@@ -82,6 +147,7 @@ namespace NCatboostDistributed {
             double sumAllWeights,
             EHessianType hessianType)
         : TrainData(trainData)
+        , LearnDataSource(std::move(learnDataSource))
         , TargetClassifiers(targetClassifiers)
         , RandomSeed(randomSeed)
         , ApproxDimension(approxDimension)
@@ -95,6 +161,7 @@ namespace NCatboostDistributed {
         int operator&(IBinSaver& binSaver) {
             NCB::AddWithShared(&binSaver, &TrainData);
             binSaver.AddMulti(
+                LearnDataSource,
                 TargetClassifiers,
                 RandomSeed,
                 ApproxDimension,
@@ -114,6 +181,9 @@ namespace NCatboostDistributed {
         TBucketStatsCache PrevTreeLevelStats;
         THolder<TRestorableFastRng64> Rand;
 
+        // learn data part, received from master or loaded by this worker
+        NCB::TTrainingForCPUDataProviderPtr TrainData;
+
         // data used by CalcScore, SetPermutedIndices, CalcApprox, CalcWeightedDerivatives
         TLearnProgress Progress;
         int Depth;
@@ -132,6 +202,14 @@ namespace NCatboostDistributed {
 
         NCatboostOptions::TCatBoostOptions Params;
 
+        /* wall time of mappers since master got it last time, see TWorkerProfileGetter.
+         * Maps of one request (e.g. per candidate) run concurrently, so time of an operation is counted
+         * while at least one its call is running; fields are guarded by OperationTimesLock
+         */
+        TMap<TString, double> OperationToTime;
+        TMap<TString, std::pair<ui32, TInstant>> RunningOperations; // running call count, start of first call
+        TAdaptiveLock OperationTimesLock;
+
     public:
         TLocalTensorSearchData()
             : Params(ETaskType::CPU)
@@ -3,24 +3,146 @@
 #include <catboost/libs/algo/approx_calcer.h>
 #include <catboost/libs/algo/approx_calcer_multi.h>
 #include <catboost/libs/algo/error_functions.h>
+#include <catboost/libs/algo/greedy_tensor_search.h>
 #include <catboost/libs/algo/score_calcer.h>
 #include <catboost/libs/algo/learn_context.h>
 #include <catboost/libs/algo/online_ctr.h>
+#include <catboost/libs/data_new/load_data.h>
+#include <catboost/libs/data_new/quantization.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/libs/helpers/vector_helpers.h>
+#include <catboost/libs/labels/label_converter.h>
+#include <catboost/libs/options/system_options.h>
+#include <catboost/libs/target/data_providers.h>
+
+#include <util/datetime/base.h>
+#include <util/system/guard.h>
 
 #include <utility>
 
 
 namespace NCatboostDistributed {
 
+    namespace {
+        // adds wall time of mapper calls to worker's operation times, master gets them for profile
+        class TWorkerOperationTimer {
+        public:
+            explicit TWorkerOperationTimer(const char* operation)
+                : Operation(operation)
+            {
+                auto& localData = TLocalTensorSearchData::GetRef();
+                with_lock (localData.OperationTimesLock) {
+                    auto& [runningCount, start] = localData.RunningOperations[Operation];
+                    if (runningCount++ == 0) {
+                        start = Now();
+                    }
+                }
+            }
+
+            ~TWorkerOperationTimer() {
+                auto& localData = TLocalTensorSearchData::GetRef();
+                with_lock (localData.OperationTimesLock) {
+                    auto& [runningCount, start] = localData.RunningOperations[Operation];
+                    if (--runningCount == 0) {
+                        localData.OperationToTime[Operation] += (Now() - start).SecondsFloat();
+                    }
+                }
+            }
+
+        private:
+            const char* Operation;
+        };
+    }
+
+    // load worker's part of learn data and quantize it with borders computed by master
+    static NCB::TTrainingForCPUDataProviderPtr LoadLocalLearnData(
+        const TLocalLearnDataSource& learnDataSource,
+        const NCatboostOptions::TCatBoostOptions& params,
+        int approxDimension,
+        TRestorableFastRng64* rand,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        CB_ENSURE_INTERNAL(learnDataSource.PoolPath.Inited(), "Neither learn data nor its source is specified");
+
+        TVector<TString> classNames = learnDataSource.ClassNames;
+        NCB::TDataProviderPtr rawData = NCB::ReadDatasetLinesRange(
+            learnDataSource.PoolPath,
+            learnDataSource.BeginLineIdx,
+            learnDataSource.EndLineIdx,
+            learnDataSource.DsvPoolFormatParams,
+            learnDataSource.IgnoredFeatures,
+            NCB::EObjectsOrder::Ordered,
+            &classNames,
+            localExecutor);
+        CB_ENSURE(
+            rawData->GetObjectCount() == learnDataSource.EndLineIdx - learnDataSource.BeginLineIdx,
+            "Worker has loaded " << rawData->GetObjectCount() << " objects from lines ["
+            << learnDataSource.BeginLineIdx << ", " << learnDataSource.EndLineIdx << ") of "
+            << learnDataSource.PoolPath.Path);
+
+        NCB::TRawObjectsDataProviderPtr rawObjectsData(
+            dynamic_cast<NCB::TRawObjectsDataProvider*>(rawData->ObjectsData.Get()));
+        Y_VERIFY(rawObjectsData);
+
+        NCB::TQuantizationOptions quantizationOptions;
+        quantizationOptions.GpuCompatibleFormat = false;
+        quantizationOptions.CpuRamLimit = ParseMemorySizeDescription(params.SystemOptions->CpuUsedRamLimit.Get());
+        quantizationOptions.AllowWriteFiles = false;
+        NCB::TQuantizedObjectsDataProviderPtr quantizedObjectsData = NCB::Quantize(
+            quantizationOptions,
+            std::move(rawObjectsData),
+            learnDataSource.QuantizedFeaturesInfo,
+            rand,
+            localExecutor);
+
+        NCB::TDataMetaInfo metaInfo = rawData->MetaInfo;
+        metaInfo.FeaturesLayout = learnDataSource.QuantizedFeaturesInfo->GetFeaturesLayout();
+
+        TLabelConverter labelConverter;
+        if (!learnDataSource.MulticlassLabelParams.empty()) {
+            labelConverter.Initialize(learnDataSource.MulticlassLabelParams);
+        }
+        const auto& dataProcessingOptions = params.DataProcessingOptions.Get();
+        NCatboostOptions::TLossDescription lossDescription = params.LossFunctionDescription.Get();
+        NCB::TTargetDataProviderPtr targetData = NCB::CreateTargetDataProvider(
+            rawData->RawTargetData,
+            quantizedObjectsData->GetSubgroupIds(),
+            /*isForGpu*/ false,
+            /*isLearnData*/ true,
+            "learn",
+            { lossDescription },
+            &lossDescription,
+            dataProcessingOptions.AllowConstLabel.Get(),
+            /*metricsThatRequireTargetCanBeSkipped*/ false,
+            /*needTargetDataForCtrs*/ false,
+            approxDimension,
+            dataProcessingOptions.ClassesCount.Get(),
+            dataProcessingOptions.ClassWeights.Get(),
+            &classNames,
+            &labelConverter,
+            rand,
+            localExecutor,
+            &metaInfo.HasPairs);
+
+        auto* quantizedForCPUObjectsData
+            = dynamic_cast<NCB::TQuantizedForCPUObjectsDataProvider*>(quantizedObjectsData.Get());
+        Y_VERIFY(quantizedForCPUObjectsData);
+
+        return MakeIntrusive<NCB::TTrainingForCPUDataProvider>(
+            std::move(metaInfo),
+            rawData->ObjectsGrouping,
+            TIntrusivePtr<NCB::TQuantizedForCPUObjectsDataProvider>(quantizedForCPUObjectsData),
+            std::move(targetData));
+    }
+
     void TPlainFoldBuilder::DoMap(
         NPar::IUserContext* ctx,
         int hostId,
         TInput* /*unused*/,
         TOutput* /*unused*/
     ) const {
+        TWorkerOperationTimer timer("Build plain fold");
         NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
         auto& localData = TLocalTensorSearchData::GetRef();
         localData.Rand = new TRestorableFastRng64(trainData->RandomSeed + hostId);
@@ -32,12 +154,23 @@ namespace NCatboostDistributed {
         localData.StoreExpApprox = IsStoreExpApprox(
             localData.Params.LossFunctionDescription->GetLossFunction());
 
+        if (trainData->TrainData) {
+            localData.TrainData = trainData->TrainData;
+        } else {
+            localData.TrainData = LoadLocalLearnData(
+                trainData->LearnDataSource,
+                localData.Params,
+                trainData->ApproxDimension,
+                localData.Rand.Get(),
+                &NPar::LocalExecutor());
+        }
+
         localData.Progress.ApproxDimension = trainData->ApproxDimension;
         localData.Progress.AveragingFold = TFold::BuildPlainFold(
-            *trainData->TrainData,
+            *localData.TrainData,
             trainData->TargetClassifiers,
             /*shuffle*/false,
-            trainData->TrainData->GetObjectCount(),
+            localData.TrainData->GetObjectCount(),
             trainData->ApproxDimension,
             localData.StoreExpApprox,
             UsesPairsForCalculation(localData.Params.LossFunctionDescription->GetLossFunction()),
@@ -45,13 +178,13 @@ namespace NCatboostDistributed {
             &NPar::LocalExecutor());
         Y_ASSERT(localData.Progress.AveragingFold.BodyTailArr.ysize() == 1);
 
-        auto maybeBaseline = trainData->TrainData->TargetData->GetBaseline();
+        auto maybeBaseline = localData.TrainData->TargetData->GetBaseline();
         if (maybeBaseline) {
             AssignRank2<float>(*maybeBaseline, &localData.Progress.AvrgApprox);
         } else {
             localData.Progress.AvrgApprox.resize(
                 trainData->ApproxDimension,
-                TVector<double>(trainData->TrainData->GetObjectCount()));
+                TVector<double>(localData.TrainData->GetObjectCount()));
         }
 
         localData.UseTreeLevelCaching = NeedToUseTreeLevelCaching(
@@ -77,7 +210,7 @@ namespace NCatboostDistributed {
             localData.PrevTreeLevelStats.Create(
                 { plainFold },
                 CountNonCtrBuckets(
-                    *(trainData->TrainData->ObjectsData->GetQuantizedFeaturesInfo()),
+                    *(localData.TrainData->ObjectsData->GetQuantizedFeaturesInfo()),
                     localData.Params.CatFeatureParams->OneHotMaxSize.Get()),
                 localData.Params.ObliviousTreeOptions->MaxDepth);
         }
@@ -87,14 +220,11 @@ namespace NCatboostDistributed {
     }
 
     void TApproxReconstructor::DoMap(
-        NPar::IUserContext* ctx,
-        int hostId,
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
         TInput* valuedForest,
         TOutput* /*unused*/
     ) const {
-        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
-        Y_ASSERT(!trainData->TrainData->MetaInfo.FeaturesLayout->GetCatFeatureCount());
-
         auto& localData = TLocalTensorSearchData::GetRef();
         Y_ASSERT(IsPlainMode(localData.Params.BoostingOptions->BoostingType));
 
@@ -102,12 +232,12 @@ namespace NCatboostDistributed {
         const auto& leafValues = valuedForest->Data.second;
         Y_ASSERT(forest.size() == leafValues.size());
 
-        auto maybeBaseline = trainData->TrainData->TargetData->GetBaseline();
+        auto maybeBaseline = localData.TrainData->TargetData->GetBaseline();
         if (maybeBaseline) {
             AssignRank2<float>(*maybeBaseline, &localData.Progress.AvrgApprox);
         }
 
-        const ui32 learnSampleCount = trainData->TrainData->GetObjectCount();
+        const ui32 learnSampleCount = localData.TrainData->GetObjectCount();
         const bool storeExpApprox = IsStoreExpApprox(
             localData.Params.LossFunctionDescription->GetLossFunction());
         const auto& avrgFold = localData.Progress.AveragingFold;
@@ -115,7 +245,7 @@ namespace NCatboostDistributed {
             const auto leafIndices = BuildIndices(
                 avrgFold,
                 forest[treeIdx],
-                trainData->TrainData, /*testData*/
+                localData.TrainData, /*testData*/
                 { },
                 &NPar::LocalExecutor());
             UpdateAvrgApprox(
@@ -138,6 +268,7 @@ namespace NCatboostDistributed {
         auto& localData = TLocalTensorSearchData::GetRef();
         localData.Depth = 0;
         Fill(localData.Indices.begin(), localData.Indices.end(), 0);
+        TrimOnlineCTRcache({&localData.Progress.AveragingFold});
         if (localData.UseTreeLevelCaching) {
             localData.PrevTreeLevelStats.GarbageCollect();
         }
@@ -149,6 +280,7 @@ namespace NCatboostDistributed {
         TInput* /*unused*/,
         TOutput* /*unused*/
     ) const {
+        TWorkerOperationTimer timer("Bootstrap");
         auto& localData = TLocalTensorSearchData::GetRef();
         Bootstrap(
             localData.Params,
@@ -192,13 +324,12 @@ namespace NCatboostDistributed {
     }
 
     static void CalcStats3D(
-        const NPar::TCtxPtr<TTrainData>& trainData,
         const TCandidateInfo& candidate,
         TStats3D* stats3D
     ) {
         auto& localData = TLocalTensorSearchData::GetRef();
         CalcStatsAndScores(
-            *trainData->TrainData->ObjectsData,
+            *localData.TrainData->ObjectsData,
             localData.Progress.AveragingFold.GetAllCtrs(),
             localData.SampledDocs,
             localData.SmallestSplitSideDocs,
@@ -213,16 +344,17 @@ namespace NCatboostDistributed {
             stats3D,
             /*pairwiseStats*/nullptr,
             /*scoreBins*/nullptr);
+        stats3D->SaveStatsAsFloat = localData.Params.SystemOptions->ExchangeStatsInFloat.Get();
     }
 
-    static void CalcPairwiseStats(const NPar::TCtxPtr<TTrainData>& trainData,
+    static void CalcPairwiseStats(
         const TFlatPairsInfo& pairs,
         const TCandidateInfo& candidate,
         TPairwiseStats* pairwiseStats
     ) {
         auto& localData = TLocalTensorSearchData::GetRef();
         CalcStatsAndScores(
-            *trainData->TrainData->ObjectsData,
+            *localData.TrainData->ObjectsData,
             localData.Progress.AveragingFold.GetAllCtrs(),
             localData.SampledDocs,
             localData.SmallestSplitSideDocs,
@@ -240,45 +372,45 @@ namespace NCatboostDistributed {
     }
 
     void TScoreCalcer::DoMap(
-        NPar::IUserContext* ctx,
-        int hostId,
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
         TInput* candidateList,
         TOutput* bucketStats
     ) const {
-        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
+        TWorkerOperationTimer timer("Calc score");
         auto calcStats3D = [&](const TCandidateInfo& candidate, TStats3D* stats3D) {
-            CalcStats3D(trainData, candidate, stats3D);
+            CalcStats3D(candidate, stats3D);
         };
         MapCandidateList(calcStats3D, candidateList->Data, &bucketStats->Data);
     }
 
     void TPairwiseScoreCalcer::DoMap(
-        NPar::IUserContext* ctx,
-        int hostId,
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
         TInput* candidateList,
         TOutput* bucketStats
     ) const {
-        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
+        TWorkerOperationTimer timer("Calc pairwise score");
         auto& localData = TLocalTensorSearchData::GetRef();
         const auto pairs = UnpackPairsFromQueries(localData.Progress.AveragingFold.LearnQueriesInfo);
         auto calcPairwiseStats = [&](const TCandidateInfo& candidate, TPairwiseStats* pairwiseStats) {
-            CalcPairwiseStats(trainData, pairs, candidate, pairwiseStats);
+            CalcPairwiseStats(pairs, candidate, pairwiseStats);
         };
         MapCandidateList(calcPairwiseStats, candidateList->Data, &bucketStats->Data);
     }
 
     // buckets -> workerPairwiseStats
     void TRemotePairwiseBinCalcer::DoMap(
-        NPar::IUserContext* ctx,
-        int hostId,
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
         TInput* candidate,
         TOutput* bucketStats
     ) const {
-        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
+        TWorkerOperationTimer timer("Calc pairwise bucket stats");
         auto& localData = TLocalTensorSearchData::GetRef();
         const auto pairs = UnpackPairsFromQueries(localData.Progress.AveragingFold.LearnQueriesInfo);
         auto calcPairwiseStats = [&](const TCandidateInfo& candidate, TPairwiseStats* pairwiseStats) {
-            CalcPairwiseStats(trainData, pairs, candidate, pairwiseStats);
+            CalcPairwiseStats(pairs, candidate, pairwiseStats);
         };
         MapVector(calcPairwiseStats, candidate->Candidates, bucketStats);
     }
@@ -324,14 +456,14 @@ namespace NCatboostDistributed {
 
     // subcandidates -> TStats4D
     void TRemoteBinCalcer::DoMap(
-        NPar::IUserContext* ctx,
-        int hostId,
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
         TInput* candidatesInfoList,
         TOutput* bucketStats
     ) const {
-        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
+        TWorkerOperationTimer timer("Calc bucket stats");
         auto calcStats3D = [&](const TCandidateInfo& candidate, TStats3D* stats3D) {
-            CalcStats3D(trainData, candidate, stats3D);
+            CalcStats3D(candidate, stats3D);
         };
         MapVector(calcStats3D, candidatesInfoList->Candidates, bucketStats);
     }
@@ -373,18 +505,72 @@ namespace NCatboostDistributed {
         MapVector(getScores, *bucketStats, scores);
     }
 
+    // projections -> stats of worker's learn data part for projections without ctr values on worker
+    void TOnlineCtrStatsCalcer::DoMap(
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
+        TInput* projections,
+        TOutput* stats
+    ) const {
+        const auto& localData = TLocalTensorSearchData::GetRef();
+        const auto& fold = localData.Progress.AveragingFold;
+        stats->Data.resize(projections->Data.size());
+        NPar::ParallelFor(
+            0,
+            projections->Data.ysize(),
+            [&] (int projectionIdx) {
+                const auto& ctr = projections->Data[projectionIdx];
+                const auto& ctrs = fold.GetCtrs(ctr.Projection);
+                if (!ctrs.contains(ctr.Projection) || ctrs.at(ctr.Projection).Feature.empty()) {
+                    stats->Data[projectionIdx] = CalcOnlineCtrPartStats(
+                        *localData.TrainData->ObjectsData,
+                        fold,
+                        ctr.Projection,
+                        ctr.CtrInfo);
+                }
+            });
+    }
+
+    // counts of preceding objects -> ctr values for worker's learn data part
+    void TOnlineCtrCalcer::DoMap(
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
+        TInput* prefixes,
+        TOutput* /*unused*/
+    ) const {
+        TWorkerOperationTimer timer("Calc online ctrs");
+        auto& localData = TLocalTensorSearchData::GetRef();
+        auto& fold = localData.Progress.AveragingFold;
+        for (const auto& ctrPrefix : prefixes->Data) {
+            fold.GetCtrRef(ctrPrefix.Ctr.Projection); // insert before parallel computation
+        }
+        NPar::ParallelFor(
+            0,
+            prefixes->Data.ysize(),
+            [&] (int projectionIdx) {
+                const auto& ctrPrefix = prefixes->Data[projectionIdx];
+                const auto& proj = ctrPrefix.Ctr.Projection;
+                ComputeOnlineCTRsForLearnPart(
+                    *localData.TrainData->ObjectsData,
+                    fold,
+                    proj,
+                    ctrPrefix.Ctr.CtrInfo,
+                    ctrPrefix.Prefix,
+                    &fold.GetCtrRef(proj));
+            });
+    }
+
     void TLeafIndexSetter::DoMap(
-        NPar::IUserContext* ctx,
-        int hostId,
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
         TInput* bestSplit,
-        TOutput* /*unused*/
+        TOutput* isLeafEmpty
     ) const {
-        Y_ASSERT(bestSplit->Data.Type != ESplitType::OnlineCtr);
+        TWorkerOperationTimer timer("Set leaf indices");
         auto& localData = TLocalTensorSearchData::GetRef();
-        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
         SetPermutedIndices(
             bestSplit->Data,
-            *trainData->TrainData->ObjectsData,
+            *localData.TrainData->ObjectsData,
             localData.Depth + 1,
             localData.Progress.AveragingFold,
             &localData.Indices,
@@ -398,15 +584,6 @@ namespace NCatboostDistributed {
                     &NPar::LocalExecutor());
             }
         }
-    }
-
-    void TEmptyLeafFinder::DoMap(
-        NPar::IUserContext* /*ctx*/,
-        int /*hostId*/,
-        TInput* /*unused*/,
-        TOutput* isLeafEmpty
-    ) const {
-        auto& localData = TLocalTensorSearchData::GetRef();
         isLeafEmpty->Data = GetIsLeafEmpty(localData.Depth + 1, localData.Indices);
         ++localData.Depth; // tree level completed
     }
@@ -417,6 +594,7 @@ namespace NCatboostDistributed {
         TInput* /*unused*/,
         TOutput* sums
     ) const {
+        TWorkerOperationTimer timer("Calc leaf buckets");
         auto& localData = TLocalTensorSearchData::GetRef();
         const int approxDimension = localData.Progress.ApproxDimension;
         Y_ASSERT(approxDimension == 1);
@@ -464,7 +642,7 @@ namespace NCatboostDistributed {
         localData.Indices = BuildIndices(
             localData.Progress.AveragingFold,
             splitTree->Data,
-            trainData->TrainData,
+            localData.TrainData,
             /*testDataPtrs*/{ },
             &NPar::LocalExecutor());
         const int approxDimension = localData.Progress.ApproxDimension;
@@ -495,6 +673,7 @@ namespace NCatboostDistributed {
         TInput* leafValues,
         TOutput* /*unused*/
     ) const {
+        TWorkerOperationTimer timer("Update approx deltas");
         auto& localData = TLocalTensorSearchData::GetRef();
         UpdateApproxDeltas(
             localData.StoreExpApprox,
@@ -512,6 +691,7 @@ namespace NCatboostDistributed {
         TInput* averageLeafValues,
         TOutput* /*unused*/
     ) const {
+        TWorkerOperationTimer timer("Update approxes");
         auto& localData = TLocalTensorSearchData::GetRef();
         if (localData.StoreExpApprox) {
             UpdateBodyTailApprox</*StoreExpApprox*/true>(
@@ -545,6 +725,7 @@ namespace NCatboostDistributed {
         TInput* /*unused*/,
         TOutput* /*unused*/
     ) const {
+        TWorkerOperationTimer timer("Calc derivatives");
         auto& localData = TLocalTensorSearchData::GetRef();
         Y_ASSERT(localData.Progress.AveragingFold.BodyTailArr.ysize() == 1);
         const auto error = BuildError(localData.Params, /*custom objective*/Nothing());
@@ -563,6 +744,7 @@ namespace NCatboostDistributed {
         TInput* /*unused*/,
         TOutput* sums
     ) const {
+        TWorkerOperationTimer timer("Calc leaf buckets");
         auto& localData = TLocalTensorSearchData::GetRef();
         const int approxDimension = localData.Progress.ApproxDimension;
         Y_ASSERT(approxDimension > 1);
@@ -607,6 +789,7 @@ namespace NCatboostDistributed {
         TInput* leafValues,
         TOutput* /*unused*/
     ) const {
+        TWorkerOperationTimer timer("Update approx deltas");
         auto& localData = TLocalTensorSearchData::GetRef();
         UpdateApproxDeltasMulti(
             localData.StoreExpApprox,
@@ -618,11 +801,12 @@ namespace NCatboostDistributed {
     }
 
     void TErrorCalcer::DoMap(
-        NPar::IUserContext* ctx,
-        int hostId,
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
         TInput* /*unused*/,
         TOutput* additiveStats
     ) const {
+        TWorkerOperationTimer timer("Calc metrics");
         const auto& localData = TLocalTensorSearchData::GetRef();
         const auto errors = CreateMetrics(
             localData.Params.LossFunctionDescription,
@@ -630,35 +814,50 @@ namespace NCatboostDistributed {
             /*evalMetricDescriptor*/Nothing(),
             localData.Progress.ApproxDimension);
         const auto skipMetricOnTrain = GetSkipMetricOnTrain(errors);
-        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
+        TVector<const IMetric*> metrics;
         for (int errorIdx = 0; errorIdx < errors.ysize(); ++errorIdx) {
             if (!skipMetricOnTrain[errorIdx] && errors[errorIdx]->IsAdditiveMetric()) {
-                const TString metricDescription = errors[errorIdx]->GetDescription();
-                (*additiveStats)[metricDescription] = EvalErrors(
-                    localData.Progress.AvrgApprox,
-                    *trainData->TrainData->TargetData->GetTarget(),
-                    GetWeights(*trainData->TrainData->TargetData),
-                    trainData->TrainData->TargetData->GetGroupInfo().GetOrElse(TConstArrayRef<TQueryInfo>()),
-                    errors[errorIdx],
-                    &NPar::LocalExecutor());
+                metrics.push_back(errors[errorIdx].Get());
             }
         }
+        const auto metricsStats = EvalErrors(
+            localData.Progress.AvrgApprox,
+            *localData.TrainData->TargetData->GetTarget(),
+            GetWeights(*localData.TrainData->TargetData),
+            localData.TrainData->TargetData->GetGroupInfo().GetOrElse(TConstArrayRef<TQueryInfo>()),
+            metrics,
+            &NPar::LocalExecutor());
+        for (auto metricIdx : xrange(metrics.size())) {
+            (*additiveStats)[metrics[metricIdx]->GetDescription()] = metricsStats[metricIdx];
+        }
     }
 
     void TLeafWeightsGetter::DoMap(
-        NPar::IUserContext* ctx,
-        int hostId,
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
         TInput* /*unused*/,
         TOutput* leafWeights
     ) const {
         auto& localData = TLocalTensorSearchData::GetRef();
-        NPar::TCtxPtr<TTrainData> trainData(ctx, SHARED_ID_TRAIN_DATA, hostId);
         const size_t leafCount = localData.Buckets.size();
         *leafWeights = SumLeafWeights(
             leafCount,
             localData.Indices,
             localData.Progress.AveragingFold.GetLearnPermutationArray(),
-            GetWeights(*trainData->TrainData->TargetData));
+            GetWeights(*localData.TrainData->TargetData));
+    }
+
+    void TWorkerProfileGetter::DoMap(
+        NPar::IUserContext* /*ctx*/,
+        int /*hostId*/,
+        TInput* /*unused*/,
+        TOutput* operationToTime
+    ) const {
+        auto& localData = TLocalTensorSearchData::GetRef();
+        with_lock (localData.OperationTimesLock) {
+            *operationToTime = std::move(localData.OperationToTime);
+            localData.OperationToTime.clear();
+        }
     }
 
 } // NCatboostDistributed
@@ -673,7 +872,6 @@ REGISTER_SAVELOAD_NM_CLASS(0xd66d485, NCatboostDistributed, TScoreCalcer);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d585, NCatboostDistributed, TRemoteBinCalcer);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d685, NCatboostDistributed, TRemoteScoreCalcer);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d486, NCatboostDistributed, TLeafIndexSetter);
-REGISTER_SAVELOAD_NM_CLASS(0xd66d487, NCatboostDistributed, TEmptyLeafFinder);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d488, NCatboostDistributed, TCalcApproxStarter);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d489, NCatboostDistributed, TDeltaSimpleUpdater);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d48a, NCatboostDistributed, TApproxUpdater);
@@ -695,3 +893,6 @@ REGISTER_SAVELOAD_NM_CLASS(0xd66d4d4, NCatboostDistributed, TErrorCalcer);
 
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4d6, NCatboostDistributed, TApproxReconstructor);
 REGISTER_SAVELOAD_NM_CLASS(0xd66d4e0, NCatboostDistributed, TLeafWeightsGetter);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4e1, NCatboostDistributed, TOnlineCtrStatsCalcer);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4e2, NCatboostDistributed, TOnlineCtrCalcer);
+REGISTER_SAVELOAD_NM_CLASS(0xd66d4e3, NCatboostDistributed, TWorkerProfileGetter);
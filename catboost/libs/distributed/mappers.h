@@ -84,20 +84,26 @@ namespace NCatboostDistributed {
         OBJECT_NOCOPY_METHODS(TRemoteScoreCalcer);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* bucketStats, TOutput* scores) const final;
     };
-    class TLeafIndexSetter: public NPar::TMapReduceCmd<TEnvelope<TSplit>, TUnusedInitializedParam> {
+    // [projection]
+    class TOnlineCtrStatsCalcer:
+        public NPar::TMapReduceCmd<TEnvelope<TVector<TOnlineCtrProjection>>, TEnvelope<TWorkerOnlineCtrStats>> {
+
+        OBJECT_NOCOPY_METHODS(TOnlineCtrStatsCalcer);
+        void DoMap(NPar::IUserContext* /*ctx*/, int /*hostId*/, TInput* projections, TOutput* stats) const final;
+    };
+    class TOnlineCtrCalcer:
+        public NPar::TMapReduceCmd<TEnvelope<TVector<TOnlineCtrPrefix>>, TUnusedInitializedParam> {
+
+        OBJECT_NOCOPY_METHODS(TOnlineCtrCalcer);
+        void DoMap(NPar::IUserContext* /*ctx*/, int hostId, TInput* prefixes, TOutput* /*unused*/) const final;
+    };
+    // sets leaf indices for best split and reports empty leaves, so that one request completes tree level
+    class TLeafIndexSetter: public NPar::TMapReduceCmd<TEnvelope<TSplit>, TEnvelope<TIsLeafEmpty>> {
         OBJECT_NOCOPY_METHODS(TLeafIndexSetter);
         void DoMap(
             NPar::IUserContext* ctx,
             int hostId,
             TInput* bestSplit,
-            TOutput* /*unused*/) const final;
-    };
-    class TEmptyLeafFinder: public NPar::TMapReduceCmd<TUnusedInitializedParam, TEnvelope<TIsLeafEmpty>> {
-        OBJECT_NOCOPY_METHODS(TEmptyLeafFinder);
-        void DoMap(
-            NPar::IUserContext* /*ctx*/,
-            int /*hostId*/,
-            TInput* /*unused*/,
             TOutput* isLeafEmpty) const final;
     };
     class TBucketSimpleUpdater:
@@ -150,5 +156,10 @@ namespace NCatboostDistributed {
         OBJECT_NOCOPY_METHODS(TLeafWeightsGetter);
         void DoMap(NPar::IUserContext* ctx, int hostId, TInput* /*unused*/, TOutput* leafWeights) const final;
     };
+    // times of worker's operations since previous call, for profile
+    class TWorkerProfileGetter: public NPar::TMapReduceCmd<TUnusedInitializedParam, TMap<TString, double>> {
+        OBJECT_NOCOPY_METHODS(TWorkerProfileGetter);
+        void DoMap(NPar::IUserContext* ctx, int hostId, TInput* /*unused*/, TOutput* operationToTime) const final;
+    };
 
 } // NCatboostDistributed
@@ -6,8 +6,13 @@
 #include <catboost/libs/algo/score_bin.h>
 #include <catboost/libs/algo/score_calcer.h>
 
+#include <catboost/libs/helpers/exception.h>
+
 #include <library/par/par_settings.h>
 
+#include <util/generic/hash_set.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
 #include <util/system/yassert.h>
 
 
@@ -15,6 +20,10 @@ using namespace NCatboostDistributed;
 using namespace NCB;
 
 
+// candidate batches in flight in MapGenericRemoteCalcScore
+static const int CalcScoreBatchCount = 4;
+
+
 void InitializeMaster(TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
     const auto& systemOptions = ctx->Params.SystemOptions;
@@ -31,17 +40,98 @@ void InitializeMaster(TLearnContext* ctx) {
     const int workerCount = ctx->RootEnvironment->GetSlaveCount();
     const auto& workerMapping = ctx->RootEnvironment->MakeHostIdMapping(workerCount);
     ctx->SharedTrainData = ctx->RootEnvironment->CreateEnvironment(SHARED_ID_TRAIN_DATA, workerMapping);
+    ctx->WorkerResponseTimeout = TDuration::Seconds(systemOptions->WorkerResponseTimeout.Get());
 }
 
 void FinalizeMaster(TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
-    if (ctx->RootEnvironment != nullptr) {
+    // stopping would wait for failed workers forever
+    if (ctx->RootEnvironment != nullptr && !ctx->HasUnresponsiveWorkers) {
         ctx->RootEnvironment->Stop();
     }
 }
 
-void MapBuildPlainFold(NCB::TTrainingForCPUDataProviderPtr trainData, TLearnContext* ctx) {
+void WaitForWorkers(TLearnContext* ctx, NPar::TJobExecutor* exec) {
+    if (ctx->WorkerResponseTimeout == TDuration::Zero()) {
+        return;
+    }
+    if (!exec->WaitResult(ctx->WorkerResponseTimeout)) {
+        ctx->HasUnresponsiveWorkers = true;
+        ythrow TCatBoostException()
+            << "Workers didn't respond in " << ctx->WorkerResponseTimeout << ", some of them may have failed. "
+            << "Training can be resumed from snapshot with the same or replaced hosts in file with hosts";
+    }
+}
+
+static void CheckLearnDataCanBeLoadedByWorkers(
+    const NCB::TTrainingForCPUDataProvider& trainData,
+    const NCatboostOptions::TPoolLoadParams* learnDataLoadParams,
+    const NCatboostOptions::TCatBoostOptions& params
+) {
+    CB_ENSURE(
+        learnDataLoadParams && learnDataLoadParams->LearnSetPath.Inited(),
+        "Workers can load learn data only if it is read from file"
+    );
+    CB_ENSURE(
+        learnDataLoadParams->CvParams.FoldCount == 0,
+        "Workers can't load learn data in cross-validation mode"
+    );
+    CB_ENSURE(
+        !learnDataLoadParams->PairsFilePath.Inited()
+            && !learnDataLoadParams->GroupWeightsFilePath.Inited()
+            && !learnDataLoadParams->BaselineFilePath.Inited(),
+        "Workers can't load learn data with pairs, group weights or baseline in separate files"
+    );
+    // object index in learn data must be equal to data line index
+    CB_ENSURE(
+        params.DataProcessingOptions->HasTimeFlag && !trainData.MetaInfo.HasTimestamp,
+        "Workers can load learn data only if it is not shuffled or reordered, use has_time and no timestamp column"
+    );
+}
+
+// master sends quantization schema and line ranges only, workers load and quantize their parts themselves
+static NCatboostDistributed::TLocalLearnDataSource MakeLearnDataSource(
+    const NCatboostOptions::TPoolLoadParams& learnDataLoadParams,
+    const TObjectsGrouping& objectsGrouping,
+    const TArraySubsetIndexing<ui32>& workerPart, // objects or groups subset, as returned by Split
+    TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
+    const TLearnContext& ctx
+) {
+    const auto& workerBlocks = workerPart.Get<TRangesSubset<ui32>>().Blocks;
+    CB_ENSURE_INTERNAL(workerBlocks.size() == 1, "Worker's part of learn data is not a range");
+    const auto& workerBlock = workerBlocks[0];
+
+    NCatboostDistributed::TLocalLearnDataSource learnDataSource;
+    learnDataSource.PoolPath = learnDataLoadParams.LearnSetPath;
+    learnDataSource.DsvPoolFormatParams = learnDataLoadParams.DsvPoolFormatParams;
+    learnDataSource.IgnoredFeatures = learnDataLoadParams.IgnoredFeatures;
+    learnDataSource.ClassNames = ctx.Params.DataProcessingOptions->ClassNames.Get();
+    if (objectsGrouping.IsTrivial()) {
+        learnDataSource.BeginLineIdx = workerBlock.SrcBegin;
+        learnDataSource.EndLineIdx = workerBlock.SrcEnd;
+    } else {
+        learnDataSource.BeginLineIdx = objectsGrouping.GetGroup(workerBlock.SrcBegin).Begin;
+        learnDataSource.EndLineIdx = objectsGrouping.GetGroup(workerBlock.SrcEnd - 1).End;
+    }
+    learnDataSource.QuantizedFeaturesInfo = quantizedFeaturesInfo;
+    if (ctx.LearnProgress.LabelConverter.IsInitialized()) {
+        learnDataSource.MulticlassLabelParams = ctx.LearnProgress.LabelConverter.SerializeMulticlassParams(
+            ctx.Params.DataProcessingOptions->ClassesCount.Get(),
+            ctx.Params.DataProcessingOptions->ClassNames.Get());
+    }
+    return learnDataSource;
+}
+
+void MapBuildPlainFold(
+    NCB::TTrainingForCPUDataProviderPtr trainData,
+    const NCatboostOptions::TPoolLoadParams* learnDataLoadParams,
+    TLearnContext* ctx
+) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
+    const bool workersLoadLearnData = ctx->Params.SystemOptions->WorkersLoadLearnData.Get();
+    if (workersLoadLearnData) {
+        CheckLearnDataCanBeLoadedByWorkers(*trainData, learnDataLoadParams, ctx->Params);
+    }
     const auto& plainFold = ctx->LearnProgress.Folds[0];
     Y_ASSERT(plainFold.PermutationBlockSize == plainFold.GetLearnSampleCount());
     const int workerCount = ctx->RootEnvironment->GetSlaveCount();
@@ -64,15 +154,28 @@ void MapBuildPlainFold(NCB::TTrainingForCPUDataProviderPtr trainData, TLearnCont
     }
     const TString stringParams = ToString(jsonParams);
     for (int workerIdx = 0; workerIdx < workerCount; ++workerIdx) {
+        NCB::TTrainingForCPUDataProviderPtr workerTrainData;
+        NCatboostDistributed::TLocalLearnDataSource workerLearnDataSource;
+        if (workersLoadLearnData) {
+            workerLearnDataSource = MakeLearnDataSource(
+                *learnDataLoadParams,
+                *trainData->ObjectsGrouping,
+                workerParts[workerIdx],
+                trainData->ObjectsData->GetQuantizedFeaturesInfo(),
+                *ctx);
+        } else {
+            workerTrainData = trainData->GetSubset(
+                NCB::GetSubset(
+                    trainData->ObjectsGrouping,
+                    std::move(workerParts[workerIdx]),
+                    EObjectsOrder::Ordered),
+                ctx->LocalExecutor);
+        }
         ctx->SharedTrainData->SetContextData(
             workerIdx,
             new NCatboostDistributed::TTrainData(
-                trainData->GetSubset(
-                    NCB::GetSubset(
-                        trainData->ObjectsGrouping,
-                        std::move(workerParts[workerIdx]),
-                        EObjectsOrder::Ordered),
-                    ctx->LocalExecutor),
+                workerTrainData,
+                std::move(workerLearnDataSource),
                 targetClassifiers,
                 randomSeed,
                 ctx->LearnProgress.ApproxDimension,
@@ -82,25 +185,36 @@ void MapBuildPlainFold(NCB::TTrainingForCPUDataProviderPtr trainData, TLearnCont
                 ctx->LearnProgress.HessianType),
             NPar::DELETE_RAW_DATA); // only workers
     }
-    ApplyMapper<TPlainFoldBuilder>(workerCount, ctx->SharedTrainData);
+    ApplyMapper<TPlainFoldBuilder>(workerCount, ctx);
 }
 
-void MapRestoreApproxFromTreeStruct(TLearnContext* ctx) {
+void MapRestoreApproxFromTreeStruct(const NCB::TTrainingForCPUDataProviders& data, TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
+    // workers are either restarted or replaced, so ctr values of the forest are recomputed from scratch
+    TVector<TProjection> ctrProjections;
+    THashSet<TProjection> seenProjections;
+    for (const auto& tree : ctx->LearnProgress.TreeStruct) {
+        for (const auto& ctr : tree.GetCtrSplits()) {
+            if (seenProjections.insert(ctr.Projection).second) {
+                ctrProjections.push_back(ctr.Projection);
+            }
+        }
+    }
+    MapCalcOnlineCtrs(data, ctrProjections, ctx);
     ApplyMapper<TApproxReconstructor>(
         ctx->RootEnvironment->GetSlaveCount(),
-        ctx->SharedTrainData,
+        ctx,
         MakeEnvelope(std::make_pair(ctx->LearnProgress.TreeStruct, ctx->LearnProgress.LeafValues)));
 }
 
 void MapTensorSearchStart(TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
-    ApplyMapper<TTensorSearchStarter>(ctx->RootEnvironment->GetSlaveCount(), ctx->SharedTrainData);
+    ApplyMapper<TTensorSearchStarter>(ctx->RootEnvironment->GetSlaveCount(), ctx);
 }
 
 void MapBootstrap(TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
-    ApplyMapper<TBootstrapMaker>(ctx->RootEnvironment->GetSlaveCount(), ctx->SharedTrainData);
+    ApplyMapper<TBootstrapMaker>(ctx->RootEnvironment->GetSlaveCount(), ctx);
 }
 
 template <typename TScoreCalcMapper, typename TGetScore>
@@ -115,7 +229,7 @@ void MapGenericCalcScore(
     const int workerCount = ctx->RootEnvironment->GetSlaveCount();
     auto allStatsFromAllWorkers = ApplyMapper<TScoreCalcMapper>(
         workerCount,
-        ctx->SharedTrainData,
+        ctx,
         MakeEnvelope(*candidateList));
     const int candidateCount = candidateList->ysize();
     const ui64 randSeed = ctx->Rand.GenRand();
@@ -173,31 +287,49 @@ void MapGenericRemoteCalcScore(
     TLearnContext* ctx) {
 
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
-    NPar::TJobDescription job;
-    NPar::Map(&job, new TBinCalcMapper(), candidateList);
-    NPar::RemoteMap(&job, new TScoreCalcMapper);
-    NPar::TJobExecutor exec(&job, ctx->SharedTrainData);
-    TVector<typename TScoreCalcMapper::TOutput> allScores;
-    exec.GetRemoteMapResults(&allScores);
-    // set best split for each candidate
     const int candidateCount = candidateList->ysize();
-    Y_ASSERT(candidateCount == allScores.ysize());
+    if (candidateCount == 0) {
+        return;
+    }
+    // candidates are sent in several batches, so that master selects best splits of a batch
+    // while workers compute and reduce stats of the following batches
+    const int batchCount = Min(candidateCount, CalcScoreBatchCount);
+    const int batchSize = CeilDiv(candidateCount, batchCount);
+    TVector<THolder<NPar::TJobExecutor>> batchExecutors;
+    for (int batchBegin = 0; batchBegin < candidateCount; batchBegin += batchSize) {
+        const int batchEnd = Min(batchBegin + batchSize, candidateCount);
+        TCandidateList batch(candidateList->begin() + batchBegin, candidateList->begin() + batchEnd);
+        NPar::TJobDescription job;
+        NPar::Map(&job, new TBinCalcMapper(), &batch);
+        NPar::RemoteMap(&job, new TScoreCalcMapper);
+        batchExecutors.emplace_back(MakeHolder<NPar::TJobExecutor>(&job, ctx->SharedTrainData));
+    }
+    // set best split for each candidate
     const ui64 randSeed = ctx->Rand.GenRand();
-    ctx->LocalExecutor->ExecRange(
-        [&] (int candidateIdx) {
-            auto& candidates = (*candidateList)[candidateIdx].Candidates;
-            Y_VERIFY(candidates.size() > 0);
-
-            SetBestScore(
-                randSeed + candidateIdx,
-                allScores[candidateIdx],
-                scoreStDev,
-                perPackMasks,
-                &candidates);
-        },
-        0,
-        candidateCount,
-        NPar::TLocalExecutor::WAIT_COMPLETE);
+    for (int batchIdx : xrange(batchExecutors.ysize())) {
+        const int batchBegin = batchIdx * batchSize;
+        auto& exec = *batchExecutors[batchIdx];
+        WaitForWorkers(ctx, &exec);
+        TVector<typename TScoreCalcMapper::TOutput> allScores;
+        exec.GetRemoteMapResults(&allScores);
+        Y_ASSERT(batchBegin + allScores.ysize() <= candidateCount);
+        ctx->LocalExecutor->ExecRange(
+            [&] (int batchCandidateIdx) {
+                const int candidateIdx = batchBegin + batchCandidateIdx;
+                auto& candidates = (*candidateList)[candidateIdx].Candidates;
+                Y_VERIFY(candidates.size() > 0);
+
+                SetBestScore(
+                    randSeed + candidateIdx,
+                    allScores[batchCandidateIdx],
+                    scoreStDev,
+                    perPackMasks,
+                    &candidates);
+            },
+            0,
+            allScores.ysize(),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+    }
 }
 
 void MapRemotePairwiseCalcScore(
@@ -226,17 +358,98 @@ void MapRemoteCalcScore(
         ctx);
 }
 
-void MapSetIndices(const TSplit& bestSplit, TLearnContext* ctx) {
-    Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
+static void MapCalcOnlineCtrs(
+    const NCB::TTrainingForCPUDataProviders& data,
+    const TVector<TProjection>& projections,
+    TLearnContext* ctx) {
+
+    if (projections.empty()) {
+        return;
+    }
+    auto& folds = ctx->LearnProgress.Folds;
+    TVector<TOnlineCtrProjection> ctrs;
+    for (const auto& proj : projections) {
+        ctrs.emplace_back(TOnlineCtrProjection{proj, ctx->CtrsHelper.GetCtrInfo(proj)});
+    }
+
     const int workerCount = ctx->RootEnvironment->GetSlaveCount();
-    ApplyMapper<TLeafIndexSetter>(workerCount, ctx->SharedTrainData, MakeEnvelope(bestSplit));
+    const auto statsFromAllWorkers = ApplyMapper<TOnlineCtrStatsCalcer>(
+        workerCount,
+        ctx,
+        MakeEnvelope(ctrs));
+
+    TVector<TVector<TOnlineCtrPrefix>> workerPrefixes(workerCount); // [workerIdx][ctrIdx]
+    for (auto ctrIdx : xrange(ctrs.size())) {
+        const auto& proj = ctrs[ctrIdx].Projection;
+        TVector<TOnlineCtrPartStats> partsStats;
+        for (const auto& workerStats : statsFromAllWorkers) {
+            if (workerStats.Data[ctrIdx].Defined()) {
+                partsStats.push_back(*workerStats.Data[ctrIdx]);
+            }
+        }
+        if (partsStats.empty()) { // all workers have ctr values already
+            CB_ENSURE_INTERNAL(folds[0].GetCtrs(proj).contains(proj), "No unique values count of cached online ctr");
+            continue;
+        }
+        CB_ENSURE_INTERNAL(partsStats.ysize() == workerCount, "Online ctr values are cached on some workers only");
+
+        size_t uniqueValuesCount = 0;
+        size_t counterUniqueValuesCount = 0;
+        auto partPrefixes = MergeOnlineCtrPartStats(
+            data,
+            proj,
+            ctrs[ctrIdx].CtrInfo,
+            folds[0].TargetClassesCount,
+            ctx->Params.CatFeatureParams->CounterCalcMethod.Get(),
+            partsStats,
+            &uniqueValuesCount,
+            &counterUniqueValuesCount);
+        for (auto workerIdx : xrange(workerCount)) {
+            workerPrefixes[workerIdx].push_back(TOnlineCtrPrefix{ctrs[ctrIdx], std::move(partPrefixes[workerIdx])});
+        }
+        // learn folds are not permuted in distributed mode and share ctr cache state with workers,
+        // whichever of them is taken for the next tree
+        for (auto& fold : folds) {
+            auto& ctr = fold.GetCtrRef(proj);
+            ctr.UniqueValuesCount = uniqueValuesCount;
+            ctr.CounterUniqueValuesCount = counterUniqueValuesCount;
+        }
+    }
+    if (!workerPrefixes[0].empty()) {
+        TVector<TEnvelope<TVector<TOnlineCtrPrefix>>> mapperInputs;
+        for (const auto& prefixes : workerPrefixes) {
+            mapperInputs.push_back(MakeEnvelope(prefixes));
+        }
+        ApplyMapperPerWorker<TOnlineCtrCalcer>(ctx, &mapperInputs);
+    }
 }
 
-int MapGetRedundantSplitIdx(TLearnContext* ctx) {
+void MapCalcOnlineCtrs(
+    const NCB::TTrainingForCPUDataProviders& data,
+    const TCandidateList& candidateList,
+    TLearnContext* ctx) {
+
+    Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
+    TVector<TProjection> projections;
+    THashSet<TProjection> seenProjections;
+    for (const auto& candidate : candidateList) {
+        const auto& splitEnsemble = candidate.Candidates[0].SplitEnsemble;
+        if (!splitEnsemble.IsSplitOfType(ESplitType::OnlineCtr)) {
+            continue;
+        }
+        const auto& proj = splitEnsemble.SplitCandidate.Ctr.Projection;
+        if (seenProjections.insert(proj).second) {
+            projections.push_back(proj);
+        }
+    }
+    MapCalcOnlineCtrs(data, projections, ctx);
+}
+
+int MapSetIndicesAndGetRedundantSplitIdx(const TSplit& bestSplit, TLearnContext* ctx) {
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
     const int workerCount = ctx->RootEnvironment->GetSlaveCount();
-    TVector<TEmptyLeafFinder::TOutput> isLeafEmptyFromAllWorkers
-        = ApplyMapper<TEmptyLeafFinder>(workerCount, ctx->SharedTrainData); // poll workers
+    TVector<TLeafIndexSetter::TOutput> isLeafEmptyFromAllWorkers
+        = ApplyMapper<TLeafIndexSetter>(workerCount, ctx, MakeEnvelope(bestSplit));
     for (int workerIdx = 1; workerIdx < workerCount; ++workerIdx) {
         for (int leafIdx = 0; leafIdx < isLeafEmptyFromAllWorkers[0].Data.ysize(); ++leafIdx) {
             isLeafEmptyFromAllWorkers[0].Data[leafIdx] &= isLeafEmptyFromAllWorkers[workerIdx].Data[leafIdx];
@@ -250,7 +463,7 @@ void MapCalcErrors(TLearnContext* ctx) {
     const size_t workerCount = ctx->RootEnvironment->GetSlaveCount();
 
     // poll workers
-    auto additiveStatsFromAllWorkers = ApplyMapper<TErrorCalcer>(workerCount, ctx->SharedTrainData);
+    auto additiveStatsFromAllWorkers = ApplyMapper<TErrorCalcer>(workerCount, ctx);
     Y_ASSERT(additiveStatsFromAllWorkers.size() == workerCount);
 
     auto& additiveStats = additiveStatsFromAllWorkers[0];
@@ -299,7 +512,7 @@ void MapSetApproxes(
 
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
     const int workerCount = ctx->RootEnvironment->GetSlaveCount();
-    ApplyMapper<TCalcApproxStarter>(workerCount, ctx->SharedTrainData, MakeEnvelope(splitTree));
+    ApplyMapper<TCalcApproxStarter>(workerCount, ctx, MakeEnvelope(splitTree));
     const int gradientIterations = ctx->Params.ObliviousTreeOptions->LeavesEstimationIterations;
     const int approxDimension = ctx->LearnProgress.ApproxDimension;
     const int leafCount = splitTree.GetLeafCount();
@@ -312,7 +525,7 @@ void MapSetApproxes(
 
         TPairwiseBuckets pairwiseBuckets;
         TApproxDefs::SetPairwiseBucketsSize(leafCount, &pairwiseBuckets);
-        const auto bucketsFromAllWorkers = ApplyMapper<TBucketUpdater>(workerCount, ctx->SharedTrainData);
+        const auto bucketsFromAllWorkers = ApplyMapper<TBucketUpdater>(workerCount, ctx);
         // reduce across workers
         for (int workerIdx = 0; workerIdx < workerCount; ++workerIdx) {
             const auto& workerBuckets = bucketsFromAllWorkers[workerIdx].Data.first;
@@ -333,11 +546,11 @@ void MapSetApproxes(
         const auto leafValues = TApproxDefs::CalcLeafValues(buckets, pairwiseBuckets, *ctx);
         AddElementwise(leafValues, averageLeafValues);
         // calc model and update approx deltas on workers
-        ApplyMapper<TDeltaUpdater>(workerCount, ctx->SharedTrainData, leafValues);
+        ApplyMapper<TDeltaUpdater>(workerCount, ctx, leafValues);
     }
 
     // [workerIdx][dimIdx][leafIdx]
-    const auto leafWeightsFromAllWorkers = ApplyMapper<TLeafWeightsGetter>(workerCount, ctx->SharedTrainData);
+    const auto leafWeightsFromAllWorkers = ApplyMapper<TLeafWeightsGetter>(workerCount, ctx);
     sumLeafWeights->resize(leafCount);
     for (const auto& workerLeafWeights : leafWeightsFromAllWorkers) {
         AddElementwise(workerLeafWeights, sumLeafWeights);
@@ -350,7 +563,7 @@ void MapSetApproxes(
         averageLeafValues);
 
     // update learn approx and average approx
-    ApplyMapper<TApproxUpdater>(workerCount, ctx->SharedTrainData, *averageLeafValues);
+    ApplyMapper<TApproxUpdater>(workerCount, ctx, *averageLeafValues);
     // update test
     const auto indices = BuildIndices(
         /*unused fold*/{ },
@@ -467,5 +680,17 @@ void MapSetApproxesMulti(
 void MapSetDerivatives(TLearnContext* ctx) {
     using namespace NCatboostDistributed;
     Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
-    ApplyMapper<TDerivativeSetter>(ctx->RootEnvironment->GetSlaveCount(), ctx->SharedTrainData);
+    ApplyMapper<TDerivativeSetter>(ctx->RootEnvironment->GetSlaveCount(), ctx);
+}
+
+void MapAddWorkerProfile(TLearnContext* ctx) {
+    using namespace NCatboostDistributed;
+    Y_ASSERT(ctx->Params.SystemOptions->IsMaster());
+    const int workerCount = ctx->RootEnvironment->GetSlaveCount();
+    const auto operationToTimeFromAllWorkers = ApplyMapper<TWorkerProfileGetter>(workerCount, ctx);
+    for (int workerIdx = 0; workerIdx < workerCount; ++workerIdx) {
+        for (const auto& [operation, time] : operationToTimeFromAllWorkers[workerIdx]) {
+            ctx->Profile.AddParallelOperationTime("Worker " + ToString(workerIdx) + ": " + operation, time);
+        }
+    }
 }
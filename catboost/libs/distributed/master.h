@@ -7,11 +7,22 @@
 #include <catboost/libs/algo/split.h>
 #include <catboost/libs/algo/tensor_search_helpers.h>
 #include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/options/load_options.h>
 
 void InitializeMaster(TLearnContext* ctx);
 void FinalizeMaster(TLearnContext* ctx);
-void MapBuildPlainFold(NCB::TTrainingForCPUDataProviderPtr trainData, TLearnContext* ctx);
-void MapRestoreApproxFromTreeStruct(TLearnContext* ctx);
+
+/* learnDataLoadParams are used if workers load their parts of learn data themselves
+ * (TSystemOptions::WorkersLoadLearnData), can be nullptr otherwise.
+ * trainData is master's own copy of learn data, with WorkersLoadLearnData it is loaded from
+ * quantized pool without raw feature values if pool columns allow it
+ */
+void MapBuildPlainFold(
+    NCB::TTrainingForCPUDataProviderPtr trainData,
+    const NCatboostOptions::TPoolLoadParams* learnDataLoadParams,
+    TLearnContext* ctx);
+// restores state of (possibly restarted or replaced) workers from tree structure loaded from snapshot
+void MapRestoreApproxFromTreeStruct(const NCB::TTrainingForCPUDataProviders& data, TLearnContext* ctx);
 void MapTensorSearchStart(TLearnContext* ctx);
 void MapBootstrap(TLearnContext* ctx);
 void MapCalcScore(
@@ -30,14 +41,22 @@ void MapRemotePairwiseCalcScore(
     TConstArrayRef<NCB::TBinaryFeaturesPack> perPackMasks,
     TCandidateList* candidateList,
     TLearnContext* ctx);
-void MapSetIndices(const TSplit& bestSplit, TLearnContext* ctx);
-int MapGetRedundantSplitIdx(TLearnContext* ctx);
+// computes online ctr values of candidate projections on workers and their unique values counts in master folds
+void MapCalcOnlineCtrs(
+    const NCB::TTrainingForCPUDataProviders& data,
+    const TCandidateList& candidateList,
+    TLearnContext* ctx);
+// updates leaf indices on workers and checks for empty leaves in the same request
+int MapSetIndicesAndGetRedundantSplitIdx(const TSplit& bestSplit, TLearnContext* ctx);
 void MapCalcErrors(TLearnContext* ctx);
 
+// fails if workers don't return results of job in TSystemOptions::WorkerResponseTimeout
+void WaitForWorkers(TLearnContext* ctx, NPar::TJobExecutor* exec);
+
 template <typename TMapper>
 TVector<typename TMapper::TOutput> ApplyMapper(
     int workerCount,
-    TObj<NPar::IEnvironment> environment,
+    TLearnContext* ctx,
     const typename TMapper::TInput& value = typename TMapper::TInput()) {
 
     NPar::TJobDescription job;
@@ -45,7 +64,27 @@ TVector<typename TMapper::TOutput> ApplyMapper(
     mapperInput[0] = value;
     NPar::Map(&job, new TMapper(), &mapperInput);
     job.SeparateResults(workerCount);
-    NPar::TJobExecutor exec(&job, environment);
+    NPar::TJobExecutor exec(&job, ctx->SharedTrainData);
+    WaitForWorkers(ctx, &exec);
+    TVector<typename TMapper::TOutput> mapperOutput;
+    exec.GetResultVec(&mapperOutput);
+    return mapperOutput;
+}
+
+// sends mapperInputs[workerIdx] to worker workerIdx only
+template <typename TMapper>
+TVector<typename TMapper::TOutput> ApplyMapperPerWorker(
+    TLearnContext* ctx,
+    TVector<typename TMapper::TInput>* mapperInputs) {
+
+    NPar::TJobDescription job;
+    job.SetCurrentOperation(new TMapper());
+    for (int workerIdx = 0; workerIdx < mapperInputs->ysize(); ++workerIdx) {
+        job.AddQuery(workerIdx, (*mapperInputs)[workerIdx]);
+    }
+    job.SeparateResults(mapperInputs->ysize());
+    NPar::TJobExecutor exec(&job, ctx->SharedTrainData);
+    WaitForWorkers(ctx, &exec);
     TVector<typename TMapper::TOutput> mapperOutput;
     exec.GetResultVec(&mapperOutput);
     return mapperOutput;
@@ -68,3 +107,5 @@ void MapSetApproxesMulti(
     TLearnContext* ctx);
 
 void MapSetDerivatives(TLearnContext* ctx);
+// adds times of workers' operations since previous call to ctx->Profile, one entry per worker and operation
+void MapAddWorkerProfile(TLearnContext* ctx);
@@ -12,44 +12,177 @@
 #include <util/generic/utility.h>
 #include <util/generic/ymath.h>
 
+#include <functional>
 #include <numeric>
 
 
 using namespace NCB;
 
 
-TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
-    const TProcessedDataProvider& processedData, int logPeriod
+namespace {
+    struct TImportanceCandidate {
+        double Priority;
+        ui32 TrainDocId;
+        double Score;
+    };
+
+    bool IsMoreImportant(const TImportanceCandidate& lhs, const TImportanceCandidate& rhs) {
+        return lhs.Priority > rhs.Priority || (lhs.Priority == rhs.Priority && lhs.TrainDocId < rhs.TrainDocId);
+    }
+
+    // Keeps topSize most important candidates, the least important of them is on the top of the heap.
+    class TTopImportances {
+    public:
+        explicit TTopImportances(ui32 topSize = 0)
+            : TopSize(topSize)
+        {
+        }
+
+        void Add(const TImportanceCandidate& candidate) {
+            if (Heap.size() < TopSize) {
+                Heap.push_back(candidate);
+                PushHeap(Heap.begin(), Heap.end(), IsMoreImportant);
+            } else if (TopSize > 0 && IsMoreImportant(candidate, Heap.front())) {
+                PopHeap(Heap.begin(), Heap.end(), IsMoreImportant);
+                Heap.back() = candidate;
+                PushHeap(Heap.begin(), Heap.end(), IsMoreImportant);
+            }
+        }
+
+        const TVector<TImportanceCandidate>& GetCandidates() const {
+            return Heap;
+        }
+
+    private:
+        ui32 TopSize;
+        TVector<TImportanceCandidate> Heap;
+    };
+}
+
+static std::function<bool(double)> GetImportanceValuesSignPredicate(EImportanceValuesSign importanceValuesSign) {
+    if (importanceValuesSign == EImportanceValuesSign::Positive) {
+        return [](double v){return v > 0;};
+    } else if (importanceValuesSign == EImportanceValuesSign::Negative) {
+        return [](double v){return v < 0;};
+    }
+    Y_ASSERT(importanceValuesSign == EImportanceValuesSign::All);
+    return [](double){return true;};
+}
+
+TDStrResult TDocumentImportancesEvaluator::GetDocumentImportances(
+    const TProcessedDataProvider& processedData,
+    EDocumentStrengthType docImpMethod,
+    int topSize,
+    EImportanceValuesSign importanceValuesSign,
+    int logPeriod
 ) {
+    const ui32 testDocCount = processedData.GetObjectCount();
     TVector<TVector<ui32>> leafIndices(TreeCount);
     const TVector<ui8> binarizedFeatures = GetModelCompatibleQuantizedFeatures(Model, *processedData.ObjectsData.Get());
     LocalExecutor->ExecRange([&] (int treeId) {
         leafIndices[treeId] = BuildIndicesForBinTree(Model, binarizedFeatures, treeId);
     }, NPar::TLocalExecutor::TExecRangeParams(0, TreeCount), NPar::TLocalExecutor::WAIT_COMPLETE);
 
-
     UpdateFinalFirstDerivatives(leafIndices, *processedData.TargetData->GetTarget());
-    TVector<TVector<double>> documentImportances(DocCount, TVector<double>(processedData.GetObjectCount()));
+
+    // Raw importances are returned in train objects order, so only the first topSize train objects are needed.
+    const ui32 trainDocCount = docImpMethod == EDocumentStrengthType::Raw ? Min<ui32>(topSize, DocCount) : DocCount;
+    const ui32 resultSize = docImpMethod == EDocumentStrengthType::Average ? 1 : testDocCount;
+
+    const int workerCount = LocalExecutor->GetThreadCount() + 1;
+    TVector<TTrainDocScratch> scratches(workerCount);
+
+    // When all processed train objects get into the top there is nothing to select: scores are written
+    // to a dense buffer and sorted once, heaps are used only for a real top.
+    const bool keepAllScores = SafeIntegerCast<ui32>(topSize) >= trainDocCount;
+    TVector<TVector<double>> allScores; // [resultIdx][trainDocId]
+    TVector<TVector<TTopImportances>> topImportances; // [workerId][resultIdx]
+    if (keepAllScores) {
+        allScores.resize(resultSize, TVector<double>(trainDocCount));
+    } else {
+        topImportances.resize(workerCount, TVector<TTopImportances>(resultSize, TTopImportances(topSize)));
+    }
+
     const size_t docBlockSize = 1000;
-    TImportanceLogger documentsLogger(DocCount, "documents processed", "Processing documents...", logPeriod);
-    TProfileInfo processDocumentsProfile(DocCount);
+    TImportanceLogger documentsLogger(trainDocCount, "documents processed", "Processing documents...", logPeriod);
+    TProfileInfo processDocumentsProfile(trainDocCount);
 
-    for (size_t start = 0; start < DocCount; start += docBlockSize) {
-        const size_t end = Min<size_t>(start + docBlockSize, DocCount);
+    for (size_t start = 0; start < trainDocCount; start += docBlockSize) {
+        const size_t end = Min<size_t>(start + docBlockSize, trainDocCount);
         processDocumentsProfile.StartIterationBlock();
 
-        LocalExecutor->ExecRange([&] (int docId) {
-            // The derivative of leaf values with respect to train doc weight.
-            TVector<TVector<TVector<double>>> leafDerivatives(TreeCount, TVector<TVector<double>>(LeavesEstimationIterations)); // [treeCount][LeavesEstimationIterationsCount][leafCount]
-            UpdateLeavesDerivatives(docId, &leafDerivatives);
-            GetDocumentImportancesForOneTrainDoc(leafDerivatives, leafIndices, &documentImportances[docId]);
-        }, NPar::TLocalExecutor::TExecRangeParams(start, end), NPar::TLocalExecutor::WAIT_COMPLETE);
+        NPar::TLocalExecutor::TExecRangeParams blockParams(start, end);
+        blockParams.SetBlockCount(workerCount);
+        LocalExecutor->ExecRange([&] (int workerId) {
+            TTrainDocScratch& scratch = scratches[workerId];
+            auto addScore = [&] (ui32 resultIdx, double priority, ui32 trainDocId, double score) {
+                if (keepAllScores) {
+                    allScores[resultIdx][trainDocId] = score;
+                } else {
+                    topImportances[workerId][resultIdx].Add({priority, trainDocId, score});
+                }
+            };
+            const ui32 workerStart = start + workerId * blockParams.GetBlockSize();
+            const ui32 workerEnd = Min<ui32>(workerStart + blockParams.GetBlockSize(), end);
+            for (ui32 trainDocId = workerStart; trainDocId < workerEnd; ++trainDocId) {
+                UpdateLeavesDerivatives(trainDocId, &scratch);
+                GetDocumentImportancesForOneTrainDoc(leafIndices, &scratch);
+                const TVector<double>& documentImportance = scratch.DocumentImportance;
+                if (docImpMethod == EDocumentStrengthType::Average) {
+                    const double score = Accumulate(documentImportance.begin(), documentImportance.end(), 0.0) / testDocCount;
+                    addScore(0, Abs(score), trainDocId, score);
+                } else {
+                    const double rawPriority = -(double)trainDocId;
+                    for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
+                        const double score = documentImportance[testDocId];
+                        const double priority = docImpMethod == EDocumentStrengthType::Raw ? rawPriority : Abs(score);
+                        addScore(testDocId, priority, trainDocId, score);
+                    }
+                }
+            }
+        }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
         documentsLogger.Log(profileResults);
+    }
+
+    const auto predicate = GetImportanceValuesSignPredicate(importanceValuesSign);
+    TDStrResult result(resultSize);
+    LocalExecutor->ExecRange([&] (int resultIdx) {
+        auto addToResult = [&] (double score, ui32 trainDocId) {
+            if (predicate(score)) {
+                result.Scores[resultIdx].push_back(score);
+                result.Indices[resultIdx].push_back(trainDocId);
+            }
+        };
+        if (keepAllScores) {
+            const TVector<double>& scores = allScores[resultIdx];
+            TVector<ui32> trainDocIds(trainDocCount);
+            Iota(trainDocIds.begin(), trainDocIds.end(), 0);
+            if (docImpMethod != EDocumentStrengthType::Raw) {
+                StableSort(trainDocIds.begin(), trainDocIds.end(), [&] (ui32 lhs, ui32 rhs) {
+                    return Abs(scores[lhs]) > Abs(scores[rhs]);
+                });
+            }
+            for (ui32 trainDocId : trainDocIds) {
+                addToResult(scores[trainDocId], trainDocId);
+            }
+            TVector<double>().swap(allScores[resultIdx]);
+        } else {
+            TVector<TImportanceCandidate> candidates;
+            for (int workerId = 0; workerId < workerCount; ++workerId) {
+                const auto& workerCandidates = topImportances[workerId][resultIdx].GetCandidates();
+                candidates.insert(candidates.end(), workerCandidates.begin(), workerCandidates.end());
+            }
+            Sort(candidates.begin(), candidates.end(), IsMoreImportant);
+            candidates.resize(Min<size_t>(candidates.size(), topSize));
+            for (const auto& candidate : candidates) {
+                addToResult(candidate.Score, candidate.TrainDocId);
+            }
         }
-    return documentImportances;
+    }, NPar::TLocalExecutor::TExecRangeParams(0, resultSize), NPar::TLocalExecutor::WAIT_COMPLETE);
+    return result;
 }
 
 void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target) {
@@ -70,42 +203,46 @@ void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TV
     EvaluateDerivatives(LossFunction, LeafEstimationMethod, finalApproxes, target, &FinalFirstDerivatives, nullptr, nullptr);
 }
 
-TVector<ui32> TDocumentImportancesEvaluator::GetLeafIdToUpdate(ui32 treeId, const TVector<double>& jacobian) {
-    TVector<ui32> leafIdToUpdate;
+void TDocumentImportancesEvaluator::GetLeafIdToUpdate(ui32 treeId, TTrainDocScratch* scratch) {
+    TVector<ui32>& leafIdToUpdate = scratch->LeafIdToUpdate;
     const ui32 leafCount = 1 << Model.ObliviousTrees.TreeSizes[treeId];
 
     if (UpdateMethod.UpdateType == EUpdateType::AllPoints) {
-        leafIdToUpdate.resize(leafCount);
+        leafIdToUpdate.yresize(leafCount);
         std::iota(leafIdToUpdate.begin(), leafIdToUpdate.end(), 0);
     } else if (UpdateMethod.UpdateType == EUpdateType::TopKLeaves) {
         const TVector<ui32>& leafIndices = TreesStatistics[treeId].LeafIndices;
-        TVector<double> leafJacobians(leafCount);
+        const TVector<double>& jacobian = scratch->Jacobian;
+        TVector<double>& leafJacobians = scratch->LeafJacobians;
+        leafJacobians.assign(leafCount, 0.0);
         for (ui32 docId = 0; docId < DocCount; ++docId) {
             leafJacobians[leafIndices[docId]] += Abs(jacobian[docId]);
         }
 
-        TVector<ui32> orderedLeafIndices(leafCount);
-        std::iota(orderedLeafIndices.begin(), orderedLeafIndices.end(), 0);
-        Sort(orderedLeafIndices.begin(), orderedLeafIndices.end(), [&](ui32 firstDocId, ui32 secondDocId) {
-            return leafJacobians[firstDocId] > leafJacobians[secondDocId];
+        leafIdToUpdate.yresize(leafCount);
+        std::iota(leafIdToUpdate.begin(), leafIdToUpdate.end(), 0);
+        const ui32 topSize = Min<ui32>(UpdateMethod.TopSize, leafCount);
+        PartialSort(leafIdToUpdate.begin(), leafIdToUpdate.begin() + topSize, leafIdToUpdate.end(), [&](ui32 firstLeafId, ui32 secondLeafId) {
+            return leafJacobians[firstLeafId] > leafJacobians[secondLeafId];
         });
-
-        leafIdToUpdate = TVector<ui32>(
-            orderedLeafIndices.begin(),
-            orderedLeafIndices.begin() + Min<ui32>(UpdateMethod.TopSize, leafCount)
-        );
+        leafIdToUpdate.resize(topSize);
+    } else {
+        leafIdToUpdate.clear();
     }
-
-    return leafIdToUpdate;
 }
 
-void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, TVector<TVector<TVector<double>>>* leafDerivatives) {
-    TVector<double> jacobian(DocCount);
+void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, TTrainDocScratch* scratch) {
+    TVector<double>& jacobian = scratch->Jacobian;
+    jacobian.assign(DocCount, 0.0);
+    auto& leafDerivatives = scratch->LeafDerivatives;
+    leafDerivatives.resize(TreeCount);
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
         auto& treeStatistics = TreesStatistics[treeId];
+        leafDerivatives[treeId].resize(LeavesEstimationIterations);
         for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
-            const TVector<ui32> leafIdToUpdate = GetLeafIdToUpdate(treeId, jacobian);
-            TVector<double>& leafDerivativesRef = (*leafDerivatives)[treeId][it];
+            GetLeafIdToUpdate(treeId, scratch);
+            const TVector<ui32>& leafIdToUpdate = scratch->LeafIdToUpdate;
+            TVector<double>& leafDerivativesRef = leafDerivatives[treeId][it];
 
             // Updating Leaves Derivatives
             UpdateLeavesDerivativesForTree(
@@ -134,25 +271,27 @@ void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, T
 }
 
 void TDocumentImportancesEvaluator::GetDocumentImportancesForOneTrainDoc(
-    const TVector<TVector<TVector<double>>>& leafDerivatives,
     const TVector<TVector<ui32>>& leafIndices,
-    TVector<double>* documentImportance
+    TTrainDocScratch* scratch
 ) {
-    const ui32 docCount = documentImportance->size();
-    TVector<double> predictedDerivatives(docCount);
+    const ui32 docCount = FinalFirstDerivatives.size();
+    TVector<double>& predictedDerivatives = scratch->PredictedDerivatives;
+    predictedDerivatives.assign(docCount, 0.0);
 
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
         const TVector<ui32>& leafIndicesRef = leafIndices[treeId];
         for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
-            const TVector<double>& leafDerivativesRef = leafDerivatives[treeId][it];
+            const TVector<double>& leafDerivativesRef = scratch->LeafDerivatives[treeId][it];
             for (ui32 docId = 0; docId < docCount; ++docId) {
                 predictedDerivatives[docId] += leafDerivativesRef[leafIndicesRef[docId]];
             }
         }
     }
 
+    TVector<double>& documentImportance = scratch->DocumentImportance;
+    documentImportance.yresize(docCount);
     for (ui32 docId = 0; docId < docCount; ++docId) {
-        (*documentImportance)[docId] = FinalFirstDerivatives[docId] * predictedDerivatives[docId];
+        documentImportance[docId] = FinalFirstDerivatives[docId] * predictedDerivatives[docId];
     }
 }
 
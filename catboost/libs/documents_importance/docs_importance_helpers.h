@@ -1,5 +1,6 @@
 #pragma once
 
+#include "docs_importance.h"
 #include "enums.h"
 #include "tree_statistics.h"
 
@@ -70,21 +71,41 @@ public:
         TreesStatistics = treeStatisticsEvaluator->EvaluateTreeStatistics(model, processedData, logPeriod);
     }
 
-    // Getting the importance of all train objects for all objects from pool.
-    TVector<TVector<double>> GetDocumentImportances(const NCB::TProcessedDataProvider& processedData, int logPeriod = 0);
+    /* Getting the top importances of train objects for objects from pool.
+     * Train objects are processed in parallel, each worker keeps only topSize most important train objects
+     * for each object from pool, so the full importances matrix is not stored unless topSize covers all
+     * train objects (then scores are collected densely and sorted once).
+     */
+    TDStrResult GetDocumentImportances(
+        const NCB::TProcessedDataProvider& processedData,
+        EDocumentStrengthType docImpMethod,
+        int topSize,
+        EImportanceValuesSign importanceValuesSign,
+        int logPeriod = 0
+    );
+
+private:
+    // Buffers reused by one worker for all train objects it processes.
+    struct TTrainDocScratch {
+        TVector<TVector<TVector<double>>> LeafDerivatives; // [treeCount][LeavesEstimationIterationsCount][leafCount]
+        TVector<double> Jacobian; // [docCount]
+        TVector<double> LeafJacobians; // [leafCount]
+        TVector<ui32> LeafIdToUpdate;
+        TVector<double> PredictedDerivatives; // [testDocCount]
+        TVector<double> DocumentImportance; // [testDocCount]
+    };
 
 private:
     // Evaluate first derivatives at the final approxes
     void UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target);
     // Leaves derivatives will be updated based on objects from these leaves.
-    TVector<ui32> GetLeafIdToUpdate(ui32 treeId, const TVector<double>& jacobian);
+    void GetLeafIdToUpdate(ui32 treeId, TTrainDocScratch* scratch);
     // Algorithm 4 from paper.
-    void UpdateLeavesDerivatives(ui32 removedDocId, TVector<TVector<TVector<double>>>* leafDerivatives);
-    // Getting the importance of one train object for all objects from pool.
+    void UpdateLeavesDerivatives(ui32 removedDocId, TTrainDocScratch* scratch);
+    // Getting the importance of one train object for all objects from pool (result is in scratch->DocumentImportance).
     void GetDocumentImportancesForOneTrainDoc(
-        const TVector<TVector<TVector<double>>>& leafDerivatives,
         const TVector<TVector<ui32>>& leafIndices,
-        TVector<double>* documentImportance
+        TTrainDocScratch* scratch
     );
     // Evaluate leaf derivatives at a given removedDocId weight (Equation (6) from paper).
     void UpdateLeavesDerivativesForTree(
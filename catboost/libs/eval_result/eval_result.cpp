@@ -341,4 +341,42 @@ namespace NCB {
             docIdOffset);
     }
 
+    void OutputEvalResultToBinaryFile(
+        const TEvalResult& evalResult,
+        NPar::TLocalExecutor* executor,
+        const TVector<TString>& outputColumns,
+        const TExternalLabelsHelper& visibleLabelsHelper,
+        IOutputStream* outputStream) {
+
+        TVector<TVector<double>> columns;
+        for (const auto& columnName : outputColumns) {
+            EPredictionType type;
+            if (!TryFromString<EPredictionType>(columnName, type)) {
+                continue;
+            }
+            for (const auto& raws : evalResult.GetRawValuesConstRef()) {
+                CB_ENSURE(visibleLabelsHelper.IsInitialized() == IsMulticlass(raws),
+                          "Inappropriate usage of visible label helper: it MUST be initialized ONLY for multiclass problem");
+                const auto& approx = visibleLabelsHelper.IsInitialized() ? MakeExternalApprox(raws, visibleLabelsHelper) : raws;
+                auto preparedApprox = PrepareEval(type, approx, executor);
+                for (auto& column : preparedApprox) {
+                    columns.push_back(std::move(column));
+                }
+            }
+        }
+        CB_ENSURE(!columns.empty(), "No prediction type chosen in output columns");
+
+        const size_t docCount = columns[0].size();
+        const size_t columnCount = columns.size();
+        TVector<double> rows;
+        rows.yresize(docCount * columnCount);
+        NPar::ParallelFor(*executor, 0, (ui32)docCount, [&] (ui32 docIdx) {
+            double* row = rows.data() + docIdx * columnCount;
+            for (size_t columnIdx = 0; columnIdx < columnCount; ++columnIdx) {
+                row[columnIdx] = columns[columnIdx][docIdx];
+            }
+        });
+        outputStream->Write(rows.data(), rows.size() * sizeof(double));
+    }
+
 } // namespace NCB
@@ -78,4 +78,18 @@ namespace NCB {
         bool writeHeader = true,
         ui64 docIdOffset = 0);
 
+    /*
+     * Compact output for large batch predictions: no header and no text formatting,
+     * for every object in order values of all prediction columns from outputColumns (as in the
+     * dsv output, each prediction type is expanded to all dimensions and eval periods) are written
+     * as doubles in native byte order. Columns that are not prediction types are skipped.
+     * For EPredictionType::Class the external class index is written.
+     */
+    void OutputEvalResultToBinaryFile(
+        const TEvalResult& evalResult,
+        NPar::TLocalExecutor* executor,
+        const TVector<TString>& outputColumns,
+        const TExternalLabelsHelper& visibleLabelsHelper,
+        IOutputStream* outputStream);
+
 } // namespace NCB
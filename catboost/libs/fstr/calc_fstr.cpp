@@ -287,7 +287,7 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
     scores.back().Add(
             metric->Eval(approx, *targetData->GetTarget(), GetWeights(*targetData), queriesInfo, 0, blockCount, *localExecutor)
     );
-    ui32 blockSize = Min(ui32(10000), ui32(1e6) / (featuresCount * approx.ysize())); // shapValues[blockSize][featuresCount][dim] double
+    ui32 blockSize = Max(ui32(1), Min(ui32(10000), ui32(1e6) / (featuresCount * approx.ysize()))); // shapValues[blockSize][featuresCount][dim] double
 
     TProfileInfo profile(documentCount);
     TImportanceLogger importanceLogger(documentCount, "Process documents", "Started LossFunctionChange calculation", 1);
@@ -314,24 +314,51 @@ static TVector<std::pair<double, TFeature>> CalcFeatureEffectLossChange(
             &shapValues,
             localExecutor);
 
-        for (int featureIdx = 0; featureIdx < featuresCount; ++featureIdx) {
-            NPar::TLocalExecutor::TExecRangeParams blockParams(begin, end);
-            blockParams.SetBlockCountToThreadCount();
-            localExecutor->ExecRange([&](ui32 docIdx) {
-                for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
-                    approx[dimensionIdx][docIdx] -= shapValues[docIdx - begin][featureIdx][dimensionIdx];
-                }
-            }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
-            scores[featureIdx].Add(
-                    metric->Eval(approx, *targetData->GetTarget(), GetWeights(*targetData), queriesInfo, queryBegin, queryEnd,
-                                 *localExecutor)
-            );
-            localExecutor->ExecRange([&](ui32 docIdx) {
+        // block data with indices relative to the block start, to be shared by all features
+        const TConstArrayRef<float> blockTarget(targetData->GetTarget()->data() + begin, end - begin);
+        const TConstArrayRef<float> weights = GetWeights(*targetData);
+        const TConstArrayRef<float> blockWeights = weights.empty() ?
+            TConstArrayRef<float>() : TConstArrayRef<float>(weights.data() + begin, end - begin);
+        TVector<TQueryInfo> blockQueriesInfo;
+        if (!queriesInfo.empty()) {
+            blockQueriesInfo.assign(queriesInfo.begin() + queryBegin, queriesInfo.begin() + queryEnd);
+            for (auto& queryInfo : blockQueriesInfo) {
+                queryInfo.Begin -= begin;
+                queryInfo.End -= begin;
+            }
+        }
+        const ui32 blockDocumentCount = end - begin;
+        const ui32 blockMetricEvalEnd = queriesInfo.empty() ? blockDocumentCount : blockQueriesInfo.size();
+
+        // all features are evaluated in one parallel pass, each worker has its own perturbed approx
+        NPar::TLocalExecutor::TExecRangeParams featureBlockParams(0, featuresCount);
+        featureBlockParams.SetBlockCountToThreadCount();
+        localExecutor->ExecRange([&](int featureBlockIdx) {
+            NPar::TLocalExecutor sequentialExecutor;
+            TVector<TVector<double>> blockApprox(approxDimension, TVector<double>(blockDocumentCount));
+            const int featureBlockBegin = featureBlockIdx * featureBlockParams.GetBlockSize();
+            const int featureBlockEnd = Min(featureBlockBegin + featureBlockParams.GetBlockSize(), featuresCount);
+            for (int featureIdx = featureBlockBegin; featureIdx < featureBlockEnd; ++featureIdx) {
                 for (int dimensionIdx = 0; dimensionIdx < approxDimension; ++dimensionIdx) {
-                    approx[dimensionIdx][docIdx] += shapValues[docIdx - begin][featureIdx][dimensionIdx];
+                    const double* approxData = approx[dimensionIdx].data() + begin;
+                    double* blockApproxData = blockApprox[dimensionIdx].data();
+                    for (ui32 docIdx = 0; docIdx < blockDocumentCount; ++docIdx) {
+                        blockApproxData[docIdx] = approxData[docIdx] - shapValues[docIdx][featureIdx][dimensionIdx];
+                    }
                 }
-            }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
-        }
+                scores[featureIdx].Add(
+                    metric->Eval(
+                        blockApprox,
+                        blockTarget,
+                        blockWeights,
+                        blockQueriesInfo,
+                        0,
+                        blockMetricEvalEnd,
+                        sequentialExecutor
+                    )
+                );
+            }
+        }, 0, featureBlockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
         profile.FinishIterationBlock(end - begin);
         importanceLogger.Log(profile.GetProfileResults());
     }
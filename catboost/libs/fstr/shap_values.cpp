@@ -6,11 +6,16 @@
 #include <catboost/libs/data_new/features_layout.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/loggers/logger.h>
+#include <catboost/libs/model/formula_evaluator.h>
 #include <catboost/libs/logging/profile_info.h>
 #include <catboost/libs/options/restrictions.h>
 
 #include <util/generic/algorithm.h>
 #include <util/generic/utility.h>
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
 #include <util/generic/ymath.h>
 
 
@@ -98,22 +103,6 @@ static TVector<TFeaturePathElement> UnwindFeaturePath(
     return newFeaturePath;
 }
 
-static size_t CalcLeafToFallForDocument(
-    const TObliviousTrees& forest,
-    size_t treeIdx,
-    const TVector<ui8>& binarizedFeaturesForBlock,
-    size_t documentIdx,
-    size_t documentCount
-) {
-    size_t leafIdx = 0;
-    for (int depth = 0; depth < forest.TreeSizes[treeIdx]; ++depth) {
-        const TRepackedBin& split = forest.GetRepackedBins()[forest.TreeStartOffsets[treeIdx] + depth];
-        auto featureValue = binarizedFeaturesForBlock[split.FeatureIndex * documentCount + documentIdx];
-        leafIdx |= ((featureValue ^ split.XorMask) >= split.SplitIdx) << depth;
-    }
-    return leafIdx;
-}
-
 static void CalcInternalShapValuesForLeafRecursive(
     const TObliviousTrees& forest,
     const TVector<int>& binFeatureCombinationClass,
@@ -427,29 +416,71 @@ static void MapBinFeaturesToClasses(
     }
 }
 
-void CalcShapValuesForDocumentMulti(
+void TShapPreparedTrees::AddTree(
+    const TVector<TVector<TShapValue>>& shapValuesByLeaf,
+    const TVector<double>& meanValue
+) {
+    TreeFirstLeafIdx.push_back(LeafShapValueOffsets.size() - 1);
+    for (const auto& shapValuesForLeaf : shapValuesByLeaf) {
+        for (const TShapValue& shapValue : shapValuesForLeaf) {
+            Y_ASSERT(shapValue.Value.ysize() == ApproxDimension);
+            ShapValueFeatures.push_back(shapValue.Feature);
+            ShapValues.insert(ShapValues.end(), shapValue.Value.begin(), shapValue.Value.end());
+        }
+        LeafShapValueOffsets.push_back(ShapValueFeatures.size());
+    }
+    MeanValuesForAllTrees.push_back(meanValue);
+}
+
+void CalcLeafIndicesForDocumentBlock(
     const TObliviousTrees& forest,
-    const TShapPreparedTrees& preparedTrees,
+    size_t treeStart,
+    size_t treeEnd,
     const TVector<ui8>& binarizedFeaturesForBlock,
+    size_t documentCount,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<ui32>* leafIndicesForBlock
+) {
+    leafIndicesForBlock->yresize((treeEnd - treeStart) * documentCount);
+    if (treeStart == treeEnd || documentCount == 0) {
+        return;
+    }
+    const bool needXorMask = !forest.OneHotFeatures.empty();
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(treeStart, treeEnd);
+    blockParams.SetBlockCountToThreadCount();
+    localExecutor->ExecRange([&] (size_t treeIdx) {
+        ui32* leafIndices = leafIndicesForBlock->data() + (treeIdx - treeStart) * documentCount;
+        Fill(leafIndices, leafIndices + documentCount, 0);
+        CalcIndexes(
+            needXorMask,
+            binarizedFeaturesForBlock.data(),
+            documentCount,
+            leafIndices,
+            forest.GetRepackedBins().data() + forest.TreeStartOffsets[treeIdx],
+            forest.TreeSizes[treeIdx]
+        );
+    }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
+static void AddShapValuesForDocument(
+    const TShapPreparedTrees& preparedTrees,
+    TConstArrayRef<ui32> leafIndicesForBlock,
     int flatFeatureCount,
     size_t documentIdx,
     size_t documentCount,
-    TVector<TVector<double>>* shapValues
+    TVector<TVector<double>>* shapValues // [dimension][feature], the last feature is for mean value
 ) {
-    const int approxDimension = forest.ApproxDimension;
-    shapValues->assign(approxDimension, TVector<double>(flatFeatureCount + 1, 0.0));
-    const size_t treeCount = forest.GetTreeCount();
+    const int approxDimension = preparedTrees.ApproxDimension;
+    const size_t treeCount = preparedTrees.GetTreeCount();
+    const int* shapValueFeatures = preparedTrees.ShapValueFeatures.data();
+    const double* shapValuesData = preparedTrees.ShapValues.data();
     for (size_t treeIdx = 0; treeIdx < treeCount; ++treeIdx) {
-        size_t leafIdx = CalcLeafToFallForDocument(
-            forest,
-            treeIdx,
-            binarizedFeaturesForBlock,
-            documentIdx,
-            documentCount
-        );
-        for (const TShapValue& shapValue : preparedTrees.ShapValuesByLeafForAllTrees[treeIdx][leafIdx]) {
+        const size_t leafIdx = leafIndicesForBlock[treeIdx * documentCount + documentIdx];
+        const size_t shapValuesEnd = preparedTrees.GetLeafShapValuesEnd(treeIdx, leafIdx);
+        for (size_t i = preparedTrees.GetLeafShapValuesBegin(treeIdx, leafIdx); i < shapValuesEnd; ++i) {
             for (int dimension = 0; dimension < approxDimension; ++dimension) {
-                (*shapValues)[dimension][shapValue.Feature] += shapValue.Value[dimension];
+                (*shapValues)[dimension][shapValueFeatures[i]] += shapValuesData[i * approxDimension + dimension];
             }
         }
         for (int dimension = 0; dimension < approxDimension; ++dimension) {
@@ -459,6 +490,29 @@ void CalcShapValuesForDocumentMulti(
     }
 }
 
+void CalcShapValuesForDocumentMulti(
+    const TObliviousTrees& forest,
+    const TShapPreparedTrees& preparedTrees,
+    TConstArrayRef<ui32> leafIndicesForBlock,
+    int flatFeatureCount,
+    size_t documentIdx,
+    size_t documentCount,
+    TVector<TVector<double>>* shapValues
+) {
+    shapValues->resize(forest.ApproxDimension);
+    for (auto& shapValuesForDimension : *shapValues) {
+        shapValuesForDimension.assign(flatFeatureCount + 1, 0.0);
+    }
+    AddShapValuesForDocument(
+        preparedTrees,
+        leafIndicesForBlock,
+        flatFeatureCount,
+        documentIdx,
+        documentCount,
+        shapValues
+    );
+}
+
 static void CalcShapValuesForDocumentBlockMulti(
     const TFullModel& model,
     const TObjectsDataProvider& objectsData,
@@ -473,6 +527,17 @@ static void CalcShapValuesForDocumentBlockMulti(
 
     TVector<ui8> binarizedFeaturesForBlock = GetModelCompatibleQuantizedFeatures(model, objectsData, start, end);
 
+    TVector<ui32> leafIndicesForBlock;
+    CalcLeafIndicesForDocumentBlock(
+        forest,
+        preparedTrees.FirstTreeIdx,
+        preparedTrees.FirstTreeIdx + preparedTrees.GetTreeCount(),
+        binarizedFeaturesForBlock,
+        documentCount,
+        localExecutor,
+        &leafIndicesForBlock
+    );
+
     const int flatFeatureCount = objectsData.GetFeaturesLayout()->GetExternalFeatureCount();
 
     const int oldShapValuesSize = shapValuesForAllDocuments->size();
@@ -485,7 +550,7 @@ static void CalcShapValuesForDocumentBlockMulti(
         CalcShapValuesForDocumentMulti(
             forest,
             preparedTrees,
-            binarizedFeaturesForBlock,
+            leafIndicesForBlock,
             flatFeatureCount,
             documentIdx,
             documentCount,
@@ -508,10 +573,13 @@ static void CalcShapValuesByLeafForTreeBlock(
     TVector<TVector<int>> combinationClassFeatures;
     MapBinFeaturesToClasses(forest, &binFeatureCombinationClass, &combinationClassFeatures);
 
+    TVector<TVector<TVector<TShapValue>>> shapValuesByLeafForBlock(end - start); // [treeIdx - start][leafIdx]
+    TVector<TVector<double>> meanValuesForBlock(end - start);
+
     NPar::TLocalExecutor::TExecRangeParams blockParams(start, end);
     localExecutor->ExecRange([&] (size_t treeIdx) {
         const size_t leafCount = (size_t(1) << forest.TreeSizes[treeIdx]);
-        TVector<TVector<TShapValue>>& shapValuesByLeaf = preparedTrees->ShapValuesByLeafForAllTrees[treeIdx];
+        TVector<TVector<TShapValue>>& shapValuesByLeaf = shapValuesByLeafForBlock[treeIdx - start];
         shapValuesByLeaf.resize(leafCount);
 
         TVector<TVector<double>> subtreeWeights
@@ -528,11 +596,13 @@ static void CalcShapValuesByLeafForTreeBlock(
                 calcInternalValues,
                 &shapValuesByLeaf[leafIdx]
             );
-
-            preparedTrees->MeanValuesForAllTrees[treeIdx]
-                = CalcMeanValueForTree(forest, subtreeWeights, treeIdx);
         }
+        meanValuesForBlock[treeIdx - start] = CalcMeanValueForTree(forest, subtreeWeights, treeIdx);
     }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    for (auto blockTreeIdx : xrange(shapValuesByLeafForBlock.size())) {
+        preparedTrees->AddTree(shapValuesByLeafForBlock[blockTreeIdx], meanValuesForBlock[blockTreeIdx]);
+    }
 }
 
 static void WarnForComplexCtrs(const TObliviousTrees& forest) {
@@ -546,41 +616,44 @@ static void WarnForComplexCtrs(const TObliviousTrees& forest) {
     }
 }
 
-TShapPreparedTrees PrepareTrees(
+// returns empty vector if model has LeafWeights
+static TVector<TVector<double>> CollectLeafWeightsIfNeeded(
     const TFullModel& model,
-    const TDataProvider* dataset, // can be nullptr if model has LeafWeights
+    const TDataProvider* dataset,
+    NPar::TLocalExecutor* localExecutor
+) {
+    if (!model.ObliviousTrees.LeafWeights.empty()) {
+        return {};
+    }
+    CB_ENSURE(
+        dataset,
+        "PrepareTrees requires either non-empty LeafWeights in model or provided dataset"
+    );
+    CB_ENSURE(dataset->ObjectsGrouping->GetObjectCount() != 0, "no docs in pool");
+    CB_ENSURE(dataset->MetaInfo.GetFeatureCount() > 0, "no features in pool");
+    return CollectLeavesStatistics(*dataset, model, localExecutor);
+}
+
+static TShapPreparedTrees PrepareTreesRange(
+    const TFullModel& model,
+    const TVector<TVector<double>>& leafWeights, // used only if model.ObliviousTrees.LeafWeights is empty
+    size_t treeStart,
+    size_t treeEnd,
     int logPeriod,
     NPar::TLocalExecutor* localExecutor,
     bool calcInternalValues
 ) {
-    WarnForComplexCtrs(model.ObliviousTrees);
-
-    const size_t treeCount = model.GetTreeCount();
+    const size_t treeCount = treeEnd - treeStart;
     const size_t treeBlockSize = CB_THREAD_LIMIT; // least necessary for threading
 
     TImportanceLogger treesLogger(treeCount, "trees processed", "Processing trees...", logPeriod);
 
-    // use only if model.ObliviousTrees.LeafWeights is empty
-    TVector<TVector<double>> leafWeights;
-    if (model.ObliviousTrees.LeafWeights.empty()) {
-        CB_ENSURE(
-            dataset,
-            "PrepareTrees requires either non-empty LeafWeights in model or provided dataset"
-        );
-        CB_ENSURE(dataset->ObjectsGrouping->GetObjectCount() != 0, "no docs in pool");
-        CB_ENSURE(dataset->MetaInfo.GetFeatureCount() > 0, "no features in pool");
-        leafWeights = CollectLeavesStatistics(*dataset, model, localExecutor);
-    }
-
-    TShapPreparedTrees preparedTrees;
-
-    preparedTrees.ShapValuesByLeafForAllTrees.resize(treeCount);
-    preparedTrees.MeanValuesForAllTrees.resize(treeCount);
+    TShapPreparedTrees preparedTrees(model.ObliviousTrees.ApproxDimension, treeStart);
 
     TProfileInfo processTreesProfile(treeCount);
 
-    for (size_t start = 0; start < treeCount; start += treeBlockSize) {
-        size_t end = Min(start + treeBlockSize, treeCount);
+    for (size_t start = treeStart; start < treeEnd; start += treeBlockSize) {
+        size_t end = Min(start + treeBlockSize, treeEnd);
 
         processTreesProfile.StartIterationBlock();
 
@@ -602,6 +675,28 @@ TShapPreparedTrees PrepareTrees(
     return preparedTrees;
 }
 
+TShapPreparedTrees PrepareTrees(
+    const TFullModel& model,
+    const TDataProvider* dataset, // can be nullptr if model has LeafWeights
+    int logPeriod,
+    NPar::TLocalExecutor* localExecutor,
+    bool calcInternalValues
+) {
+    WarnForComplexCtrs(model.ObliviousTrees);
+
+    const TVector<TVector<double>> leafWeights = CollectLeafWeightsIfNeeded(model, dataset, localExecutor);
+
+    return PrepareTreesRange(
+        model,
+        leafWeights,
+        /*treeStart*/ 0,
+        model.GetTreeCount(),
+        logPeriod,
+        localExecutor,
+        calcInternalValues
+    );
+}
+
 TShapPreparedTrees PrepareTrees(const TFullModel& model, NPar::TLocalExecutor* localExecutor) {
     CB_ENSURE(
         !model.ObliviousTrees.LeafWeights.empty(),
@@ -628,18 +723,32 @@ void CalcShapValuesInternalForFeature(
     shapValues->resize(documentCount);
 
     TVector<ui8> binarizedFeaturesForBlock = GetModelCompatibleQuantizedFeatures(model, objectsData, start, end);
+    TVector<ui32> leafIndicesForBlock;
+    CalcLeafIndicesForDocumentBlock(
+        forest,
+        /*treeStart*/ 0,
+        forest.GetTreeCount(),
+        binarizedFeaturesForBlock,
+        documentCount,
+        localExecutor,
+        &leafIndicesForBlock
+    );
+
+    const int approxDimension = forest.ApproxDimension;
+    const int* shapValueFeatures = preparedTrees.ShapValueFeatures.data();
+    const double* shapValuesData = preparedTrees.ShapValues.data();
     const ui32 documentBlockSize = CB_THREAD_LIMIT;
     for (ui32 startIdx = 0; startIdx < documentCount; startIdx += documentBlockSize) {
         NPar::TLocalExecutor::TExecRangeParams blockParams(startIdx, startIdx + Min(documentBlockSize, documentCount - startIdx));
         localExecutor->ExecRange([&](ui32 documentIdx) {
             TVector<TVector<double>> &docShapValues = (*shapValues)[documentIdx];
-            docShapValues.assign(featuresCount, TVector<double>(forest.ApproxDimension + 1, 0.0));
+            docShapValues.assign(featuresCount, TVector<double>(approxDimension + 1, 0.0));
             for (ui32 treeIdx = 0; treeIdx < forest.GetTreeCount(); ++treeIdx) {
-                ui32 leafIdx = CalcLeafToFallForDocument(forest, treeIdx, binarizedFeaturesForBlock, documentIdx,
-                                                           documentCount);
-                for (const TShapValue &shapValue : preparedTrees.ShapValuesByLeafForAllTrees[treeIdx][leafIdx]) {
-                    for (int dimension = 0; dimension < forest.ApproxDimension; ++dimension) {
-                        docShapValues[shapValue.Feature][dimension] += shapValue.Value[dimension];
+                const ui32 leafIdx = leafIndicesForBlock[(size_t)treeIdx * documentCount + documentIdx];
+                const size_t shapValuesEnd = preparedTrees.GetLeafShapValuesEnd(treeIdx, leafIdx);
+                for (size_t i = preparedTrees.GetLeafShapValuesBegin(treeIdx, leafIdx); i < shapValuesEnd; ++i) {
+                    for (int dimension = 0; dimension < approxDimension; ++dimension) {
+                        docShapValues[shapValueFeatures[i]][dimension] += shapValuesData[i * approxDimension + dimension];
                     }
                 }
             }
@@ -726,13 +835,200 @@ static void OutputShapValuesMulti(const TVector<TVector<TVector<double>>>& shapV
     }
 }
 
+ui64 EstimatePreparedTreeMemoryUsage(int treeDepth, int maxLeafShapValueCount, int approxDimension) {
+    const ui64 leafCount = ui64(1) << treeDepth;
+    const ui64 shapValueSize = sizeof(int) + approxDimension * sizeof(double);
+    const ui64 meanValueSize = sizeof(TVector<double>) + approxDimension * sizeof(double);
+    return leafCount * (maxLeafShapValueCount * shapValueSize + sizeof(size_t)) + sizeof(size_t) + meanValueSize;
+}
+
+/* split trees to chunks with estimated size of prepared trees not greater than maxChunkMemoryUsage,
+ * estimated size of the largest chunk is returned in largestChunkMemoryUsage
+ */
+static TVector<size_t> GetTreeChunkBounds(
+    const TObliviousTrees& forest,
+    ui64 maxChunkMemoryUsage,
+    ui64* largestChunkMemoryUsage
+) {
+    TVector<int> binFeatureCombinationClass;
+    TVector<TVector<int>> combinationClassFeatures;
+    MapBinFeaturesToClasses(forest, &binFeatureCombinationClass, &combinationClassFeatures);
+
+    TVector<size_t> chunkBounds = {0};
+    ui64 chunkMemoryUsage = 0;
+    *largestChunkMemoryUsage = 0;
+    for (size_t treeIdx = 0; treeIdx < forest.GetTreeCount(); ++treeIdx) {
+        // a split by ctr of features combination gives values to each feature of combination
+        int maxLeafShapValueCount = 0;
+        for (int depth = 0; depth < forest.TreeSizes[treeIdx]; ++depth) {
+            const int split = forest.TreeSplits[forest.TreeStartOffsets[treeIdx] + depth];
+            maxLeafShapValueCount += combinationClassFeatures[binFeatureCombinationClass[split]].ysize();
+        }
+        const ui64 treeMemoryUsage = EstimatePreparedTreeMemoryUsage(
+            forest.TreeSizes[treeIdx],
+            maxLeafShapValueCount,
+            forest.ApproxDimension
+        );
+        if ((chunkMemoryUsage > 0) && (chunkMemoryUsage + treeMemoryUsage > maxChunkMemoryUsage)) {
+            chunkBounds.push_back(treeIdx);
+            chunkMemoryUsage = 0;
+        }
+        chunkMemoryUsage += treeMemoryUsage;
+        *largestChunkMemoryUsage = Max(*largestChunkMemoryUsage, chunkMemoryUsage);
+    }
+    chunkBounds.push_back(forest.GetTreeCount());
+    return chunkBounds;
+}
+
+static void CalcAndOutputShapValuesByTreeChunks(
+    const TFullModel& model,
+    const TDataProvider& dataset,
+    const TVector<size_t>& treeChunkBounds,
+    ui64 largestTreeChunkMemoryUsage,
+    ui64 maxMemoryUsage,
+    int logPeriod,
+    NPar::TLocalExecutor* localExecutor,
+    TFileOutput* out
+) {
+    const TObliviousTrees& forest = model.ObliviousTrees;
+    const size_t treeChunkCount = treeChunkBounds.size() - 1;
+    CATBOOST_INFO_LOG << "Prepared trees do not fit into memory limit, SHAP values will be calculated by "
+        << treeChunkCount << " chunks of trees" << Endl;
+
+    // prepare each chunk once and cache it on disk, chunks are reloaded for each chunk of documents
+    const TVector<TVector<double>> leafWeights = CollectLeafWeightsIfNeeded(model, &dataset, localExecutor);
+    TVector<THolder<TTempFile>> preparedTreesFiles;
+    for (size_t chunkIdx = 0; chunkIdx < treeChunkCount; ++chunkIdx) {
+        const TShapPreparedTrees preparedTrees = PrepareTreesRange(
+            model,
+            leafWeights,
+            treeChunkBounds[chunkIdx],
+            treeChunkBounds[chunkIdx + 1],
+            logPeriod,
+            localExecutor,
+            /*calcInternalValues*/ false
+        );
+        preparedTreesFiles.push_back(MakeHolder<TTempFile>(MakeTempName()));
+        TOFStream preparedTreesOutput(preparedTreesFiles.back()->Name());
+        ::Save(&preparedTreesOutput, preparedTrees);
+    }
+
+    const size_t documentCount = dataset.ObjectsGrouping->GetObjectCount();
+    const size_t documentBlockSize = CB_THREAD_LIMIT; // least necessary for threading
+    const int flatFeatureCount = dataset.ObjectsData->GetFeaturesLayout()->GetExternalFeatureCount();
+
+    // memory not used by the loaded chunk of trees is for documents
+    size_t largestTreeChunkSize = 0;
+    for (size_t chunkIdx = 0; chunkIdx < treeChunkCount; ++chunkIdx) {
+        largestTreeChunkSize = Max(largestTreeChunkSize, treeChunkBounds[chunkIdx + 1] - treeChunkBounds[chunkIdx]);
+    }
+    const ui64 leafIndicesMemoryUsage = ui64(documentBlockSize) * largestTreeChunkSize * sizeof(ui32);
+    const ui64 usedMemory = largestTreeChunkMemoryUsage + leafIndicesMemoryUsage;
+    const ui64 documentBudget = maxMemoryUsage > usedMemory ? maxMemoryUsage - usedMemory : 0;
+    // shapValuesForChunk and binarizedFeaturesForBlocks with their vector headers
+    const ui64 documentMemoryUsage = sizeof(TVector<TVector<double>>)
+        + ui64(forest.ApproxDimension) * (sizeof(TVector<double>) + (flatFeatureCount + 1) * sizeof(double))
+        + forest.GetEffectiveBinaryFeaturesBucketsCount();
+    const ui64 blockMemoryUsage = documentBlockSize * documentMemoryUsage + sizeof(TVector<ui8>);
+    const size_t documentChunkSize = Max<size_t>(1, documentBudget / blockMemoryUsage) * documentBlockSize;
+
+    TImportanceLogger documentsLogger(documentCount, "documents processed", "Processing documents...", logPeriod);
+
+    TProfileInfo processDocumentsProfile(documentCount);
+
+    TVector<ui32> leafIndicesForBlock;
+    for (size_t chunkStart = 0; chunkStart < documentCount; chunkStart += documentChunkSize) {
+        const size_t chunkEnd = Min(chunkStart + documentChunkSize, documentCount);
+        processDocumentsProfile.StartIterationBlock();
+
+        TVector<TVector<ui8>> binarizedFeaturesForBlocks;
+        for (size_t start = chunkStart; start < chunkEnd; start += documentBlockSize) {
+            const size_t end = Min(start + documentBlockSize, chunkEnd);
+            binarizedFeaturesForBlocks.push_back(
+                GetModelCompatibleQuantizedFeatures(model, *dataset.ObjectsData, start, end)
+            );
+        }
+
+        TVector<TVector<TVector<double>>> shapValuesForChunk(
+            chunkEnd - chunkStart,
+            TVector<TVector<double>>(forest.ApproxDimension, TVector<double>(flatFeatureCount + 1, 0.0))
+        );
+
+        for (const auto& preparedTreesFile : preparedTreesFiles) {
+            TShapPreparedTrees preparedTrees;
+            {
+                TIFStream preparedTreesInput(preparedTreesFile->Name());
+                ::Load(&preparedTreesInput, preparedTrees);
+            }
+
+            for (size_t blockIdx = 0; blockIdx < binarizedFeaturesForBlocks.size(); ++blockIdx) {
+                const size_t start = chunkStart + blockIdx * documentBlockSize;
+                const size_t blockDocumentCount = Min(start + documentBlockSize, chunkEnd) - start;
+                CalcLeafIndicesForDocumentBlock(
+                    forest,
+                    preparedTrees.FirstTreeIdx,
+                    preparedTrees.FirstTreeIdx + preparedTrees.GetTreeCount(),
+                    binarizedFeaturesForBlocks[blockIdx],
+                    blockDocumentCount,
+                    localExecutor,
+                    &leafIndicesForBlock
+                );
+
+                NPar::TLocalExecutor::TExecRangeParams blockParams(0, blockDocumentCount);
+                localExecutor->ExecRange([&] (size_t documentIdx) {
+                    AddShapValuesForDocument(
+                        preparedTrees,
+                        leafIndicesForBlock,
+                        flatFeatureCount,
+                        documentIdx,
+                        blockDocumentCount,
+                        &shapValuesForChunk[start - chunkStart + documentIdx]
+                    );
+                }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+            }
+        }
+
+        OutputShapValuesMulti(shapValuesForChunk, *out);
+
+        processDocumentsProfile.FinishIterationBlock(chunkEnd - chunkStart);
+        auto profileResults = processDocumentsProfile.GetProfileResults();
+        documentsLogger.Log(profileResults);
+    }
+}
+
 void CalcAndOutputShapValues(
     const TFullModel& model,
     const TDataProvider& dataset,
     const TString& outputPath,
     int logPeriod,
-    NPar::TLocalExecutor* localExecutor
+    NPar::TLocalExecutor* localExecutor,
+    ui64 maxMemoryUsage
 ) {
+    TFileOutput out(outputPath);
+
+    if (maxMemoryUsage != 0) {
+        ui64 largestTreeChunkMemoryUsage = 0;
+        const TVector<size_t> treeChunkBounds = GetTreeChunkBounds(
+            model.ObliviousTrees,
+            maxMemoryUsage / 2,
+            &largestTreeChunkMemoryUsage
+        );
+        if (treeChunkBounds.size() > 2) {
+            WarnForComplexCtrs(model.ObliviousTrees);
+            CalcAndOutputShapValuesByTreeChunks(
+                model,
+                dataset,
+                treeChunkBounds,
+                largestTreeChunkMemoryUsage,
+                maxMemoryUsage,
+                logPeriod,
+                localExecutor,
+                &out
+            );
+            return;
+        }
+    }
+
     TShapPreparedTrees preparedTrees = PrepareTrees(
         model,
         &dataset,
@@ -747,7 +1043,6 @@ void CalcAndOutputShapValues(
 
     TProfileInfo processDocumentsProfile(documentCount);
 
-    TFileOutput out(outputPath);
     for (size_t start = 0; start < documentCount; start += documentBlockSize) {
         size_t end = Min(start + documentBlockSize, documentCount);
         processDocumentsProfile.StartIterationBlock();
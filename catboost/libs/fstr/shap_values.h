@@ -5,6 +5,7 @@
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
 #include <util/stream/input.h>
 #include <util/stream/output.h>
@@ -28,29 +29,70 @@ public:
     Y_SAVELOAD_DEFINE(Feature, Value);
 };
 
+/* SHAP values for all leaves of all trees in flat arrays.
+ * Values for leaf leafIdx of tree treeIdx have indices
+ * [LeafShapValueOffsets[TreeFirstLeafIdx[treeIdx] + leafIdx], LeafShapValueOffsets[TreeFirstLeafIdx[treeIdx] + leafIdx + 1])
+ * in ShapValueFeatures (and these indices multiplied by ApproxDimension in ShapValues).
+ */
 struct TShapPreparedTrees {
-    TVector<TVector<TVector<TShapValue>>> ShapValuesByLeafForAllTrees; // [treeIdx][leafIdx][shapFeature] trees * 2^d * d
+    int ApproxDimension = 1;
+    size_t FirstTreeIdx = 0; // index of the first prepared tree in the model, trees can be prepared by chunks
+    TVector<size_t> TreeFirstLeafIdx; // [treeIdx]
+    TVector<size_t> LeafShapValueOffsets = {0}; // [globalLeafIdx], last element is total shap values count
+    TVector<int> ShapValueFeatures; // [shapValueIdx]
+    TVector<double> ShapValues; // [shapValueIdx * ApproxDimension + dimension]
     TVector<TVector<double>> MeanValuesForAllTrees;
 
 public:
     TShapPreparedTrees() = default;
 
-    TShapPreparedTrees(
-        const TVector<TVector<TVector<TShapValue>>>& shapValuesByLeafForAllTrees,
-        const TVector<TVector<double>>& meanValuesForAllTrees
-    )
-        : ShapValuesByLeafForAllTrees(shapValuesByLeafForAllTrees)
-        , MeanValuesForAllTrees(meanValuesForAllTrees)
+    explicit TShapPreparedTrees(int approxDimension, size_t firstTreeIdx = 0)
+        : ApproxDimension(approxDimension)
+        , FirstTreeIdx(firstTreeIdx)
     {
     }
 
-    Y_SAVELOAD_DEFINE(ShapValuesByLeafForAllTrees, MeanValuesForAllTrees);
+    // trees must be added in order
+    void AddTree(const TVector<TVector<TShapValue>>& shapValuesByLeaf, const TVector<double>& meanValue);
+
+    size_t GetTreeCount() const {
+        return TreeFirstLeafIdx.size();
+    }
+
+    size_t GetLeafShapValuesBegin(size_t treeIdx, size_t leafIdx) const {
+        return LeafShapValueOffsets[TreeFirstLeafIdx[treeIdx] + leafIdx];
+    }
+
+    size_t GetLeafShapValuesEnd(size_t treeIdx, size_t leafIdx) const {
+        return LeafShapValueOffsets[TreeFirstLeafIdx[treeIdx] + leafIdx + 1];
+    }
+
+    Y_SAVELOAD_DEFINE(
+        ApproxDimension,
+        FirstTreeIdx,
+        TreeFirstLeafIdx,
+        LeafShapValueOffsets,
+        ShapValueFeatures,
+        ShapValues,
+        MeanValuesForAllTrees
+    );
 };
 
+// leafIndicesForBlock[(treeIdx - treeStart) * documentCount + documentIdx]
+void CalcLeafIndicesForDocumentBlock(
+    const TObliviousTrees& forest,
+    size_t treeStart,
+    size_t treeEnd,
+    const TVector<ui8>& binarizedFeaturesForBlock,
+    size_t documentCount,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<ui32>* leafIndicesForBlock
+);
+
 void CalcShapValuesForDocumentMulti(
     const TObliviousTrees& forest,
     const TShapPreparedTrees& preparedTrees,
-    const TVector<ui8>& binarizedFeaturesForBlock,
+    TConstArrayRef<ui32> leafIndicesForBlock, // [(treeIdx - preparedTrees.FirstTreeIdx) * documentCount + documentIdx]
     int flatFeatureCount,
     size_t documentIdx,
     size_t documentCount,
@@ -82,13 +124,22 @@ TVector<TVector<double>> CalcShapValues(
     NPar::TLocalExecutor* localExecutor
 );
 
-// outputs for each document in order for each dimension in order an array of feature contributions
+/* upper bound of memory used by TShapPreparedTrees for one tree,
+ * maxLeafShapValueCount is the total count of flat features in combinations of tree splits
+ */
+ui64 EstimatePreparedTreeMemoryUsage(int treeDepth, int maxLeafShapValueCount, int approxDimension);
+
+/* outputs for each document in order for each dimension in order an array of feature contributions
+ * if maxMemoryUsage is not 0 and prepared trees do not fit into half of it, trees are prepared by chunks
+ * (cached in temporary files) and documents are processed by chunks that fit into memory left by a chunk of trees
+ */
 void CalcAndOutputShapValues(
     const TFullModel& model,
     const NCB::TDataProvider& dataset,
     const TString& outputPath,
     int logPeriod,
-    NPar::TLocalExecutor* localExecutor
+    NPar::TLocalExecutor* localExecutor,
+    ui64 maxMemoryUsage = 0
 );
 
 void CalcShapValuesInternalForFeature(
@@ -0,0 +1,64 @@
+#include "cpu_affinity.h"
+
+#include "exception.h"
+
+#include <util/generic/xrange.h>
+#include <util/string/cast.h>
+#include <util/string/split.h>
+#include <util/string/strip.h>
+#include <util/system/error.h>
+
+#if defined(_linux_)
+#include <sched.h>
+#endif
+
+
+namespace NCB {
+
+    TVector<ui32> ParseCpuList(TStringBuf cpuList) {
+        TVector<ui32> cpus;
+        for (const auto rangeItem : StringSplitter(StripString(cpuList)).Split(',').SkipEmpty()) {
+            const TStringBuf range = rangeItem;
+            TStringBuf first;
+            TStringBuf last;
+            if (!range.TrySplit('-', first, last)) {
+                first = last = range;
+            }
+            ui32 firstCpu = 0;
+            ui32 lastCpu = 0;
+            CB_ENSURE(
+                TryFromString(first, firstCpu) && TryFromString(last, lastCpu),
+                "Wrong cpu range '" << range << "' in cpu list '" << cpuList << "'"
+            );
+            CB_ENSURE(
+                firstCpu <= lastCpu,
+                "Cpu range '" << range << "' in cpu list '" << cpuList << "' is empty"
+            );
+            for (auto cpu : xrange(firstCpu, lastCpu + 1)) {
+                cpus.push_back(cpu);
+            }
+        }
+        CB_ENSURE(!cpus.empty(), "Cpu list '" << cpuList << "' is empty");
+        return cpus;
+    }
+
+    void SetProcessCpuAffinity(TStringBuf cpuList) {
+#if defined(_linux_)
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (auto cpu : ParseCpuList(cpuList)) {
+            CB_ENSURE(cpu < CPU_SETSIZE, "CPU index " << cpu << " is too large");
+            CPU_SET(cpu, &cpuSet);
+        }
+        // threads created afterwards inherit affinity of the calling thread
+        CB_ENSURE(
+            sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0,
+            "Can't set CPU affinity to " << cpuList << ": " << LastSystemErrorText()
+        );
+#else
+        Y_UNUSED(cpuList);
+        CB_ENSURE(false, "CPU affinity is supported only on Linux");
+#endif
+    }
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    // cpuList is in the format of /sys/devices/system/node/node*/cpulist, e.g. "0-15,64-79",
+    // returns cpu indices in the order of cpuList
+    TVector<ui32> ParseCpuList(TStringBuf cpuList);
+
+    // threads created afterwards run only on cpus of cpuList, Linux only
+    void SetProcessCpuAffinity(TStringBuf cpuList);
+
+}
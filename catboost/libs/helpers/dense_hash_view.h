@@ -3,6 +3,8 @@
 #include <util/digest/numeric.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/algorithm.h>
+#include <util/generic/vector.h>
+#include <util/system/compiler.h>
 
 namespace NCatboost {
 
@@ -17,6 +19,10 @@ namespace NCatboost {
         }
     };
 #pragma pack(pop)
+
+    // how many hashes ahead buckets are prefetched in batched lookups
+    constexpr size_t DenseIndexHashPrefetchDistance = 16;
+
     // Special optimized classes for building and applying non resizeable indexes [ui64] -> [ui32]
     // It's only use case - to be stored on disk as part of catboost flatbuffer model
     class TDenseIndexHashView {
@@ -44,6 +50,23 @@ namespace NCatboost {
             return NotFoundIndex;
         }
 
+        /* GetIndex for each of hashes, first buckets of hashes are prefetched in advance,
+         * so cache misses of lookups in large tables overlap
+         */
+        void GetIndices(TConstArrayRef<ui64> hashes, TArrayRef<ui32> indices) const {
+            Y_ASSERT(hashes.size() <= indices.size());
+            const size_t count = hashes.size();
+            for (size_t i = 0; i < Min(count, DenseIndexHashPrefetchDistance); ++i) {
+                PrefetchBucket(hashes[i]);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                if (i + DenseIndexHashPrefetchDistance < count) {
+                    PrefetchBucket(hashes[i + DenseIndexHashPrefetchDistance]);
+                }
+                indices[i] = GetIndex(hashes[i]);
+            }
+        }
+
         size_t CountNonEmptyBuckets() const {
             return CountIf(Buckets, [](const TBucket& bucket) { return bucket.Hash != TBucket::InvalidHashValue; });
         }
@@ -51,11 +74,81 @@ namespace NCatboost {
         const TConstArrayRef<TBucket> GetBuckets() const {
             return Buckets;
         }
+
+    private:
+        void PrefetchBucket(ui64 hash) const {
+            // packed buckets can cross cache line boundary
+            const char* bucketPtr = reinterpret_cast<const char*>(Buckets.data() + (hash & HashMask));
+            Y_PREFETCH_READ(bucketPtr, 3);
+            Y_PREFETCH_READ(bucketPtr + sizeof(TBucket) - 1, 3);
+        }
+
     private:
         ui64 HashMask = 0;
         TConstArrayRef<TBucket> Buckets;
     };
 
+    /* Copy of TDenseIndexHashView index with the same probing in 16-byte aligned buckets:
+     * a bucket never crosses a cache line and 4 consecutive buckets share one.
+     * Built in memory from stored TBucket index (e.g. on model load), serialized format is not changed.
+     */
+    class TAlignedDenseIndexHash {
+    public:
+        struct alignas(16) TAlignedBucket {
+            TBucket::THashType Hash;
+            ui32 IndexValue;
+        };
+        static_assert(sizeof(TAlignedBucket) == 16, "Expected sizeof(TAlignedBucket) == 16 bytes");
+
+    public:
+        TAlignedDenseIndexHash() = default;
+
+        explicit TAlignedDenseIndexHash(const TDenseIndexHashView& view)
+            : HashMask(view.GetBucketCount() - 1)
+        {
+            Buckets.yresize(view.GetBucketCount());
+            const auto srcBuckets = view.GetBuckets();
+            for (size_t i = 0; i < srcBuckets.size(); ++i) {
+                Buckets[i].Hash = srcBuckets[i].Hash;
+                Buckets[i].IndexValue = srcBuckets[i].IndexValue;
+            }
+        }
+
+        ui32 GetIndex(ui64 idx) const {
+            const TAlignedBucket* buckets = Buckets.data();
+            for (ui64 zz = idx & HashMask; buckets[zz].Hash != TBucket::InvalidHashValue; zz = (zz + 1) & HashMask) {
+                if (buckets[zz].Hash == idx) {
+                    return buckets[zz].IndexValue;
+                }
+            }
+            return TDenseIndexHashView::NotFoundIndex;
+        }
+
+        // same as TDenseIndexHashView::GetIndices
+        void GetIndices(TConstArrayRef<ui64> hashes, TArrayRef<ui32> indices) const {
+            Y_ASSERT(hashes.size() <= indices.size());
+            const size_t count = hashes.size();
+            const TAlignedBucket* buckets = Buckets.data();
+            for (size_t i = 0; i < Min(count, DenseIndexHashPrefetchDistance); ++i) {
+                Y_PREFETCH_READ(buckets + (hashes[i] & HashMask), 3);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                if (i + DenseIndexHashPrefetchDistance < count) {
+                    Y_PREFETCH_READ(buckets + (hashes[i + DenseIndexHashPrefetchDistance] & HashMask), 3);
+                }
+                indices[i] = GetIndex(hashes[i]);
+            }
+        }
+
+        size_t GetBucketCount() const {
+            return Buckets.size();
+        }
+
+    private:
+        ui64 HashMask = 0;
+        TVector<TAlignedBucket> Buckets;
+    };
+
     class TDenseIndexHashBuilder {
     public:
         static_assert(sizeof(TBucket) == 12, "Expected sizeof(TBucket) == 12 bytes");
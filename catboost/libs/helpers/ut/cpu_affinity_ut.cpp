@@ -0,0 +1,30 @@
+#include <catboost/libs/helpers/cpu_affinity.h>
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(TCpuAffinityTest) {
+    Y_UNIT_TEST(TestParseCpuList) {
+        UNIT_ASSERT_EQUAL(ParseCpuList("3"), (TVector<ui32>{3}));
+        UNIT_ASSERT_EQUAL(ParseCpuList("0-3"), (TVector<ui32>{0, 1, 2, 3}));
+        UNIT_ASSERT_EQUAL(ParseCpuList("0-2,8-9"), (TVector<ui32>{0, 1, 2, 8, 9}));
+        UNIT_ASSERT_EQUAL(ParseCpuList("1,5-6,10"), (TVector<ui32>{1, 5, 6, 10}));
+        UNIT_ASSERT_EQUAL(ParseCpuList("2-2"), (TVector<ui32>{2}));
+
+        // as read from /sys/devices/system/node/node*/cpulist
+        UNIT_ASSERT_EQUAL(ParseCpuList("0-1,64-65\n"), (TVector<ui32>{0, 1, 64, 65}));
+    }
+
+    Y_UNIT_TEST(TestParseWrongCpuList) {
+        UNIT_ASSERT_EXCEPTION(ParseCpuList(""), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(ParseCpuList("a"), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(ParseCpuList("1-"), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(ParseCpuList("-1"), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(ParseCpuList("3-1"), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(ParseCpuList("0-3,x"), TCatBoostException);
+    }
+}
@@ -0,0 +1,50 @@
+#include <catboost/libs/helpers/dense_hash_view.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+#include <library/unittest/registar.h>
+
+
+Y_UNIT_TEST_SUITE(TDenseIndexHashViewTest) {
+    Y_UNIT_TEST(TestGetIndices) {
+        const ui32 uniqueHashCount = 10000;
+
+        TFastRng64 rng(0);
+        TVector<ui64> storedHashes;
+        for (auto i : xrange(uniqueHashCount)) {
+            Y_UNUSED(i);
+            storedHashes.push_back(rng.GenRand());
+        }
+
+        TVector<NCatboost::TBucket> buckets(
+            NCatboost::TDenseIndexHashBuilder::GetProperBucketsCount(uniqueHashCount));
+        NCatboost::TDenseIndexHashBuilder builder(buckets);
+        for (auto hash : storedHashes) {
+            builder.AddIndex(hash);
+        }
+
+        // half of hashes are stored, half are not
+        TVector<ui64> hashes;
+        for (auto i : xrange(uniqueHashCount)) {
+            hashes.push_back(i % 2 ? storedHashes[(i * 7) % uniqueHashCount] : rng.GenRand());
+        }
+
+        const NCatboost::TDenseIndexHashView view(buckets);
+        const NCatboost::TAlignedDenseIndexHash alignedIndex(view);
+        UNIT_ASSERT_VALUES_EQUAL(alignedIndex.GetBucketCount(), view.GetBucketCount());
+
+        TVector<ui32> indices(hashes.size());
+        TVector<ui32> alignedIndices(hashes.size());
+        view.GetIndices(hashes, indices);
+        alignedIndex.GetIndices(hashes, alignedIndices);
+        for (auto i : xrange(hashes.size())) {
+            const ui32 expectedIndex = view.GetIndex(hashes[i]);
+            UNIT_ASSERT_VALUES_EQUAL(indices[i], expectedIndex);
+            UNIT_ASSERT_VALUES_EQUAL(alignedIndices[i], expectedIndex);
+            UNIT_ASSERT_VALUES_EQUAL(alignedIndex.GetIndex(hashes[i]), expectedIndex);
+            UNIT_ASSERT_VALUES_EQUAL(expectedIndex == NCatboost::TDenseIndexHashView::NotFoundIndex, i % 2 == 0);
+        }
+    }
+}
@@ -102,6 +102,12 @@ public:
         OperationToTime[operation] += passedTime; // operations can be repeated in one iteration
     }
 
+    // time of operation done in parallel with this process, e.g. by workers of distributed training,
+    // is reported with operations of current iteration but isn't added to iteration time
+    void AddParallelOperationTime(const TString& operation, double time) {
+        OperationToTime[operation] += time;
+    }
+
     void FinishIterationBlock(int blockSize) {
         CurrentTime += Timer.PassedReset();
         OperationToTime["Iteration time"] = CurrentTime;
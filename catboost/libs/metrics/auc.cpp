@@ -1,8 +1,16 @@
 #include "auc.h"
 
+#include <catboost/libs/helpers/exception.h>
+
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
+#include <util/generic/cast.h>
+#include <util/generic/utility.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+
+#include <algorithm>
+#include <cmath>
 
 using NMetrics::TSample;
 
@@ -78,3 +86,200 @@ double CalcAUC(TVector<TSample>* samples, double* outWeightSum, double* outPairW
     return (optimisticAUC + pessimisticAUC) / 2.0;
 }
 
+
+using NMetrics::TBinClassSample;
+using NMetrics::TBinClassAucHistogram;
+
+static constexpr int MIN_PARALLEL_BLOCK_SIZE = 65536;
+
+static int GetParallelBlockCount(size_t size, const NPar::TLocalExecutor& localExecutor) {
+    return Max<int>(1, Min<int>(localExecutor.GetThreadCount() + 1, size / MIN_PARALLEL_BLOCK_SIZE));
+}
+
+// sort blocks in parallel, then merge adjacent blocks pairwise in parallel
+template <class T, class TCompare>
+static void ParallelSort(
+    TArrayRef<T> data,
+    TVector<T>* aux,
+    TCompare compare,
+    NPar::TLocalExecutor* localExecutor
+) {
+    const int blockCount = GetParallelBlockCount(data.size(), *localExecutor);
+    if (blockCount == 1) {
+        Sort(data.begin(), data.end(), compare);
+        return;
+    }
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(data.size()));
+    blockParams.SetBlockCount(blockCount);
+
+    TVector<size_t> blockBounds;
+    for (int blockIdx : xrange(blockParams.GetBlockCount())) {
+        blockBounds.push_back((size_t)blockIdx * blockParams.GetBlockSize());
+    }
+    blockBounds.push_back(data.size());
+
+    localExecutor->ExecRangeWithThrow(
+        [&] (int blockIdx) {
+            Sort(data.begin() + blockBounds[blockIdx], data.begin() + blockBounds[blockIdx + 1], compare);
+        },
+        0,
+        SafeIntegerCast<int>(blockBounds.size() - 1),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
+    aux->yresize(data.size());
+    T* src = data.data();
+    T* dst = aux->data();
+    while (blockBounds.size() > 2) {
+        const int mergedBlockCount = SafeIntegerCast<int>(blockBounds.size() / 2);
+        localExecutor->ExecRangeWithThrow(
+            [&] (int mergedBlockIdx) {
+                const size_t begin = blockBounds[2 * mergedBlockIdx];
+                const size_t middle = blockBounds[2 * mergedBlockIdx + 1];
+                const size_t end = blockBounds[Min<size_t>(2 * mergedBlockIdx + 2, blockBounds.size() - 1)];
+                std::merge(src + begin, src + middle, src + middle, src + end, dst + begin, compare);
+            },
+            0,
+            mergedBlockCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+        TVector<size_t> mergedBlockBounds;
+        for (size_t i = 0; i < blockBounds.size() - 1; i += 2) {
+            mergedBlockBounds.push_back(blockBounds[i]);
+        }
+        mergedBlockBounds.push_back(data.size());
+        blockBounds = std::move(mergedBlockBounds);
+        DoSwap(src, dst);
+    }
+
+    if (src != data.data()) {
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                std::copy(
+                    src + blockIdx * blockParams.GetBlockSize(),
+                    src + Min<size_t>((size_t)(blockIdx + 1) * blockParams.GetBlockSize(), data.size()),
+                    data.data() + blockIdx * blockParams.GetBlockSize()
+                );
+            },
+            0,
+            blockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+}
+
+double CalcBinClassAUC(
+    TArrayRef<TBinClassSample> samples,
+    TVector<TBinClassSample>* aux,
+    NPar::TLocalExecutor* localExecutor,
+    double* outPairWeightSum
+) {
+    ParallelSort(
+        samples,
+        aux,
+        [](const TBinClassSample& left, const TBinClassSample& right) {
+            return left.Prediction < right.Prediction;
+        },
+        localExecutor
+    );
+
+    // samples with equal predictions are counted as half-ordered pairs
+    double orderedPairWeightSum = 0;
+    double negativeWeightBelow = 0;
+    double positiveWeightSum = 0;
+    for (size_t i = 0; i < samples.size();) {
+        double positiveWeight = 0;
+        double negativeWeight = 0;
+        size_t j = i;
+        for (; (j < samples.size()) && (samples[j].Prediction == samples[i].Prediction); ++j) {
+            (samples[j].IsPositive ? positiveWeight : negativeWeight) += samples[j].Weight;
+        }
+        orderedPairWeightSum += positiveWeight * (negativeWeightBelow + 0.5 * negativeWeight);
+        negativeWeightBelow += negativeWeight;
+        positiveWeightSum += positiveWeight;
+        i = j;
+    }
+
+    const double pairWeightSum = positiveWeightSum * negativeWeightBelow;
+    if (outPairWeightSum != nullptr) {
+        *outPairWeightSum = pairWeightSum;
+    }
+    if (pairWeightSum == 0) {
+        return 0;
+    }
+    return orderedPairWeightSum / pairWeightSum;
+}
+
+
+TBinClassAucHistogram::TBinClassAucHistogram(ui32 binCount)
+    : PositiveWeights(binCount, 0.0)
+    , NegativeWeights(binCount, 0.0)
+{
+    CB_ENSURE(binCount > 0, "AUC histogram must have at least one bin");
+}
+
+void TBinClassAucHistogram::Merge(const TBinClassAucHistogram& rhs) {
+    CB_ENSURE_INTERNAL(GetBinCount() == rhs.GetBinCount(), "AUC histograms have different bin counts");
+    for (auto bin : xrange(GetBinCount())) {
+        PositiveWeights[bin] += rhs.PositiveWeights[bin];
+        NegativeWeights[bin] += rhs.NegativeWeights[bin];
+    }
+}
+
+double TBinClassAucHistogram::CalcAUC(double* outPairWeightSum) const {
+    double orderedPairWeightSum = 0;
+    double negativeWeightBelow = 0;
+    double positiveWeightSum = 0;
+    for (auto bin : xrange(GetBinCount())) {
+        orderedPairWeightSum += PositiveWeights[bin] * (negativeWeightBelow + 0.5 * NegativeWeights[bin]);
+        negativeWeightBelow += NegativeWeights[bin];
+        positiveWeightSum += PositiveWeights[bin];
+    }
+
+    const double pairWeightSum = positiveWeightSum * negativeWeightBelow;
+    if (outPairWeightSum != nullptr) {
+        *outPairWeightSum = pairWeightSum;
+    }
+    if (pairWeightSum == 0) {
+        return 0;
+    }
+    return orderedPairWeightSum / pairWeightSum;
+}
+
+ui32 TBinClassAucHistogram::GetBin(double prediction) const {
+    const double probability = 1.0 / (1.0 + exp(-prediction));
+    return Min<ui32>(GetBinCount() - 1, (ui32)(probability * GetBinCount()));
+}
+
+double CalcBinClassBinnedAUC(
+    TConstArrayRef<TBinClassSample> samples,
+    ui32 binCount,
+    NPar::TLocalExecutor* localExecutor
+) {
+    if (samples.empty()) {
+        return 0;
+    }
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(samples.size()));
+    blockParams.SetBlockCount(GetParallelBlockCount(samples.size(), *localExecutor));
+
+    TVector<TBinClassAucHistogram> histograms(blockParams.GetBlockCount(), TBinClassAucHistogram(binCount));
+    localExecutor->ExecRangeWithThrow(
+        [&] (int blockIdx) {
+            auto& histogram = histograms[blockIdx];
+            const int blockEnd = Min<int>((blockIdx + 1) * blockParams.GetBlockSize(), samples.size());
+            for (int i = blockIdx * blockParams.GetBlockSize(); i < blockEnd; ++i) {
+                histogram.Add(samples[i].Prediction, samples[i].IsPositive, samples[i].Weight);
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+
+    for (auto blockIdx : xrange<size_t>(1, histograms.size())) {
+        histograms[0].Merge(histograms[blockIdx]);
+    }
+    return histograms[0].CalcAUC();
+}
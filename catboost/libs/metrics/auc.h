@@ -2,4 +2,76 @@
 
 #include "sample.h"
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
 double CalcAUC(TVector<NMetrics::TSample>* samples, double* outWeightSum = nullptr, double* outPairWeightSum = nullptr);
+
+namespace NMetrics {
+    // compact sample for binary targets, cheaper to sort than TSample
+    struct TBinClassSample {
+        double Prediction = 0;
+        float Weight = 0;
+        bool IsPositive = false;
+
+        TBinClassSample() = default;
+
+        TBinClassSample(double prediction, bool isPositive, float weight = 1.0f)
+            : Prediction(prediction)
+            , Weight(weight)
+            , IsPositive(isPositive)
+        {}
+    };
+
+    /* Fixed resolution histogram of positive and negative weights by prediction.
+     * Predictions are mapped to bins by sigmoid (AUC depends only on predictions order), samples in
+     * the same bin are treated as having equal predictions, so AUC is approximate.
+     * Histograms for different parts of data (threads, hosts) can be merged.
+     */
+    class TBinClassAucHistogram {
+    public:
+        explicit TBinClassAucHistogram(ui32 binCount);
+
+        void Add(double prediction, bool isPositive, double weight = 1.0) {
+            const ui32 bin = GetBin(prediction);
+            (isPositive ? PositiveWeights : NegativeWeights)[bin] += weight;
+        }
+
+        // rhs must have the same bin count
+        void Merge(const TBinClassAucHistogram& rhs);
+
+        double CalcAUC(double* outPairWeightSum = nullptr) const;
+
+        ui32 GetBinCount() const {
+            return PositiveWeights.size();
+        }
+
+    private:
+        ui32 GetBin(double prediction) const;
+
+    private:
+        TVector<double> PositiveWeights; // [bin]
+        TVector<double> NegativeWeights; // [bin]
+    };
+}
+
+/* Exact AUC for binary targets, equal to CalcAUC for TSample with 0/1 targets.
+ * samples are reordered, aux is a scratch buffer that can be reused between calls.
+ * Samples are sorted in parallel blocks using localExecutor and then merged.
+ */
+double CalcBinClassAUC(
+    TArrayRef<NMetrics::TBinClassSample> samples,
+    TVector<NMetrics::TBinClassSample>* aux,
+    NPar::TLocalExecutor* localExecutor,
+    double* outPairWeightSum = nullptr
+);
+
+// Approximate AUC for binary targets, histograms for parallel blocks are merged
+double CalcBinClassBinnedAUC(
+    TConstArrayRef<NMetrics::TBinClassSample> samples,
+    ui32 binCount,
+    NPar::TLocalExecutor* localExecutor
+);
@@ -94,3 +94,79 @@ double CalcNdcg(TConstArrayRef<TSample> samples, ENdcgMetricType type, ui32 topS
     double idcg = CalcIDcg(samples, type, Nothing(), topSize);
     return idcg > 0 ? dcg / idcg : 0;
 }
+
+namespace NMetrics {
+
+    TDcgCalcer::TDcgCalcer(ENdcgMetricType type, TMaybe<double> expDecay, ui32 topSize)
+        : Type(type)
+        , ExpDecay(expDecay)
+        , TopSize(topSize)
+    {
+    }
+
+    template <class TCompare>
+    void TDcgCalcer::SelectTop(ui32 size, TCompare&& compare) {
+        const ui32 topSize = Min<ui32>(TopSize, size);
+        Indices.yresize(size);
+        Iota(Indices.begin(), Indices.end(), static_cast<ui32>(0));
+        if (topSize < size) {
+            NthElement(Indices.begin(), Indices.begin() + topSize, Indices.end(), compare);
+        }
+        Sort(Indices.begin(), Indices.begin() + topSize, compare);
+        Indices.resize(topSize);
+    }
+
+    double TDcgCalcer::CalcDcgForTop(TConstArrayRef<float> target) {
+        const size_t size = Indices.size();
+        if (size == 0) {
+            return 0;
+        }
+
+        // same values as in CalcDcgSorted
+        if (Decay.size() < size) {
+            size_t i = Decay.size();
+            Decay.yresize(size);
+            if (i == 0) {
+                Decay[0] = 1.;
+                i = 1;
+            }
+            for (; i < size; ++i) {
+                Decay[i] = ExpDecay.Defined() ? Decay[i - 1] * *ExpDecay : 1. / Log2(static_cast<double>(i + 2));
+            }
+        }
+
+        TopTargets.yresize(size);
+        for (size_t i = 0; i < size; ++i) {
+            TopTargets[i] = target[Indices[i]];
+        }
+        if (ENdcgMetricType::Exp == Type) {
+            for (size_t i = 0; i < size; ++i) {
+                TopTargets[i] = pow(2, TopTargets[i]) - 1.;
+            }
+        }
+
+        return DotProduct(TopTargets.data(), Decay.data(), size);
+    }
+
+    double TDcgCalcer::CalcDcg(TConstArrayRef<double> approx, TConstArrayRef<float> target) {
+        Y_ASSERT(approx.size() == target.size());
+        SelectTop(target.size(), [approx, target] (ui32 lhs, ui32 rhs) {
+            return CompareDocs(approx[lhs], target[lhs], approx[rhs], target[rhs]);
+        });
+        return CalcDcgForTop(target);
+    }
+
+    double TDcgCalcer::CalcIDcg(TConstArrayRef<float> target) {
+        SelectTop(target.size(), [target] (ui32 lhs, ui32 rhs) {
+            return target[lhs] > target[rhs];
+        });
+        return CalcDcgForTop(target);
+    }
+
+    double TDcgCalcer::CalcNdcg(TConstArrayRef<double> approx, TConstArrayRef<float> target, TMaybe<double> idcg) {
+        const double dcg = CalcDcg(approx, target);
+        const double idcgValue = idcg.Defined() ? *idcg : CalcIDcg(target);
+        return idcgValue > 0 ? dcg / idcgValue : 0;
+    }
+
+}
@@ -2,9 +2,11 @@
 
 #include <catboost/libs/options/enums.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 #include <util/generic/maybe.h>
 #include <util/generic/utility.h>
+#include <util/generic/vector.h>
 
 // TODO(yazevnul): add fwd header for NMetrics
 namespace NMetrics {
@@ -27,3 +29,40 @@ double CalcIDcg(
     ENdcgMetricType type = ENdcgMetricType::Base,
     TMaybe<double> expDecay = Nothing(),
     ui32 topSize = Max<ui32>());
+
+namespace NMetrics {
+    /* DCG, ideal DCG and NDCG for many queries in a row (e.g. all queries of a thread's block).
+     * Buffers are reused between queries, so there are no allocations per query, only indices of
+     * documents are sorted and only top documents are ordered (nth element + sort of the top).
+     * Results are equal to CalcDcg, CalcIDcg and CalcNdcg.
+     */
+    class TDcgCalcer {
+    public:
+        explicit TDcgCalcer(
+            ENdcgMetricType type = ENdcgMetricType::Base,
+            TMaybe<double> expDecay = Nothing(),
+            ui32 topSize = Max<ui32>());
+
+        double CalcDcg(TConstArrayRef<double> approx, TConstArrayRef<float> target);
+        double CalcIDcg(TConstArrayRef<float> target);
+
+        // idcg can be precomputed by CalcIDcg, it doesn't depend on approx
+        double CalcNdcg(TConstArrayRef<double> approx, TConstArrayRef<float> target, TMaybe<double> idcg = Nothing());
+
+    private:
+        template <class TCompare>
+        void SelectTop(ui32 size, TCompare&& compare);
+
+        // DCG for targets of TopIndices
+        double CalcDcgForTop(TConstArrayRef<float> target);
+
+    private:
+        ENdcgMetricType Type;
+        TMaybe<double> ExpDecay;
+        ui32 TopSize;
+
+        TVector<ui32> Indices;
+        TVector<double> TopTargets;
+        TVector<double> Decay; // grows when needed
+    };
+}
@@ -0,0 +1,190 @@
+#include "fused_metrics.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+
+#include <cmath>
+
+
+using namespace NMetrics;
+
+
+namespace {
+    // small enough for approx, target and shared transformations of a chunk to stay in L1/L2 cache
+    constexpr int FusedChunkSize = 1024;
+
+    struct TFusedChunk {
+        const double* Approx = nullptr;
+        const double* ExpApprox = nullptr; // only if some kernel needs it
+        const ui8* ApproxClass = nullptr; // only if some kernel needs it
+        const float* Target = nullptr;
+        const float* Weight = nullptr;
+        int Size = 0;
+    };
+}
+
+static bool NeedExpApprox(EFusedMetricKernel kernel) {
+    return kernel == EFusedMetricKernel::CrossEntropy;
+}
+
+static bool NeedApproxClass(EFusedMetricKernel kernel) {
+    return kernel == EFusedMetricKernel::Accuracy
+        || kernel == EFusedMetricKernel::Precision
+        || kernel == EFusedMetricKernel::Recall;
+}
+
+// updates stats in place, so summation order is the same as in a single loop over the whole block
+template <bool HasWeight>
+static void EvalKernelOnChunk(const TFusedMetricKernel& kernel, const TFusedChunk& chunk, double* stats) {
+    const auto getWeight = [&] (int i) -> float {
+        return HasWeight ? chunk.Weight[i] : 1;
+    };
+    double stat0 = stats[0];
+    double stat1 = stats[1];
+    switch (kernel.Kernel) {
+        case EFusedMetricKernel::CrossEntropy:
+            for (int i = 0; i < chunk.Size; ++i) {
+                const float w = getWeight(i);
+                const float prob = kernel.BinarizeTarget ? chunk.Target[i] > kernel.Border : chunk.Target[i];
+                const double nonExpApprox = chunk.Approx[i];
+                const double expApprox = chunk.ExpApprox[i];
+                stat0 += w * (IsFinite(expApprox) ? log(1 + expApprox) - prob * nonExpApprox : (1 - prob) * nonExpApprox);
+                stat1 += w;
+            }
+            break;
+        case EFusedMetricKernel::RMSE:
+            for (int i = 0; i < chunk.Size; ++i) {
+                const double targetMismatch = chunk.Approx[i] - chunk.Target[i];
+                const float w = getWeight(i);
+                stat0 += Sqr(targetMismatch) * w;
+                stat1 += w;
+            }
+            break;
+        case EFusedMetricKernel::Quantile:
+            for (int i = 0; i < chunk.Size; ++i) {
+                const double val = chunk.Target[i] - chunk.Approx[i];
+                const double multiplier = (val > 0) ? kernel.Alpha : -(1 - kernel.Alpha);
+                const float w = getWeight(i);
+                stat0 += (multiplier * val) * w;
+                stat1 += w;
+            }
+            break;
+        case EFusedMetricKernel::Accuracy:
+            for (int i = 0; i < chunk.Size; ++i) {
+                const int targetClass = static_cast<int>(static_cast<float>(chunk.Target[i] > kernel.Border));
+                const float w = getWeight(i);
+                stat0 += chunk.ApproxClass[i] == targetClass ? w : 0.0;
+                stat1 += w;
+            }
+            break;
+        case EFusedMetricKernel::Precision:
+        case EFusedMetricKernel::Recall: {
+            // stat0 is true positive, stat1 is approx positive for Precision and target positive for Recall
+            const bool isPrecision = kernel.Kernel == EFusedMetricKernel::Precision;
+            for (int i = 0; i < chunk.Size; ++i) {
+                const bool isTargetPositive = chunk.Target[i] > kernel.Border;
+                const bool isApproxPositive = chunk.ApproxClass[i] == 1;
+                const float w = getWeight(i);
+                if (isTargetPositive && isApproxPositive) {
+                    stat0 += w;
+                }
+                if (isPrecision ? isApproxPositive : isTargetPositive) {
+                    stat1 += w;
+                }
+            }
+            break;
+        }
+        default:
+            Y_VERIFY(false);
+    }
+    stats[0] = stat0;
+    stats[1] = stat1;
+}
+
+namespace NMetrics {
+
+    TVector<TMetricHolder> EvalFusedMetricKernels(
+        TConstArrayRef<TFusedMetricKernel> kernels,
+        TConstArrayRef<double> approx,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        int begin,
+        int end,
+        NPar::TLocalExecutor& executor
+    ) {
+        CB_ENSURE_INTERNAL(begin < end, "EvalFusedMetricKernels: empty range of objects");
+
+        bool needExpApprox = false;
+        bool needApproxClass = false;
+        for (const auto& kernel : kernels) {
+            needExpApprox |= NeedExpApprox(kernel.Kernel);
+            needApproxClass |= NeedApproxClass(kernel.Kernel);
+        }
+
+        // same blocks as in TAdditiveMetric::Eval
+        NPar::TLocalExecutor::TExecRangeParams blockParams(begin, end);
+        const int threadCount = executor.GetThreadCount() + 1;
+        const int MinBlockSize = 10000;
+        const int effectiveBlockCount = Min(threadCount, (int)ceil((end - begin) * 1.0 / MinBlockSize));
+        blockParams.SetBlockCount(effectiveBlockCount);
+        const int blockSize = blockParams.GetBlockSize();
+        const ui32 blockCount = blockParams.GetBlockCount();
+
+        TVector<TVector<TMetricHolder>> blockResults(blockCount); // [blockId][kernelIdx]
+        NPar::ParallelFor(executor, 0, blockCount, [&](int blockId) {
+            const int from = begin + blockId * blockSize;
+            const int to = Min<int>(begin + (blockId + 1) * blockSize, end);
+            Y_ASSERT(from < to);
+
+            auto& results = blockResults[blockId];
+            results.resize(kernels.size(), TMetricHolder(2));
+
+            TVector<double> expApprox(needExpApprox ? FusedChunkSize : 0);
+            TVector<ui8> approxClass(needApproxClass ? FusedChunkSize : 0);
+            for (int chunkBegin = from; chunkBegin < to; chunkBegin += FusedChunkSize) {
+                TFusedChunk chunk;
+                chunk.Approx = approx.data() + chunkBegin;
+                chunk.Target = target.data() + chunkBegin;
+                chunk.Weight = weight.empty() ? nullptr : weight.data() + chunkBegin;
+                chunk.Size = Min(FusedChunkSize, to - chunkBegin);
+                if (needExpApprox) {
+                    for (int i = 0; i < chunk.Size; ++i) {
+                        expApprox[i] = exp(chunk.Approx[i]);
+                    }
+                    chunk.ExpApprox = expApprox.data();
+                }
+                if (needApproxClass) {
+                    for (int i = 0; i < chunk.Size; ++i) {
+                        approxClass[i] = chunk.Approx[i] > 0.0;
+                    }
+                    chunk.ApproxClass = approxClass.data();
+                }
+                for (auto kernelIdx : xrange(kernels.size())) {
+                    double* stats = results[kernelIdx].Stats.data();
+                    if (kernels[kernelIdx].UseWeights && chunk.Weight) {
+                        EvalKernelOnChunk</*HasWeight*/true>(kernels[kernelIdx], chunk, stats);
+                    } else {
+                        EvalKernelOnChunk</*HasWeight*/false>(kernels[kernelIdx], chunk, stats);
+                    }
+                }
+            }
+            for (auto kernelIdx : xrange(kernels.size())) {
+                if (kernels[kernelIdx].IsMAE) {
+                    results[kernelIdx].Stats[0] *= 2;
+                }
+            }
+        });
+
+        TVector<TMetricHolder> result(kernels.size());
+        for (const auto& results : blockResults) {
+            for (auto kernelIdx : xrange(kernels.size())) {
+                result[kernelIdx].Add(results[kernelIdx]);
+            }
+        }
+        return result;
+    }
+
+}
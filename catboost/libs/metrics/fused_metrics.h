@@ -0,0 +1,47 @@
+#pragma once
+
+#include "metric_holder.h"
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+
+
+namespace NMetrics {
+    enum class EFusedMetricKernel {
+        CrossEntropy, // Logloss if target is binarized by Border
+        RMSE,
+        Quantile, // MAE if IsMAE
+        Accuracy,
+        Precision,
+        Recall
+    };
+
+    // per-object additive metric for single-dimensional approx, see IMetric::GetFusedKernel
+    struct TFusedMetricKernel {
+        EFusedMetricKernel Kernel = EFusedMetricKernel::RMSE;
+        bool BinarizeTarget = false; // target > Border for CrossEntropy
+        double Border = 0.5;
+        double Alpha = 0.5;
+        bool IsMAE = false;
+        bool UseWeights = true;
+    };
+
+    /* Evaluates stats of all kernels in one pass over approx, target and weight.
+     * Objects are processed in small chunks, transformations of approx shared by several metrics
+     * (exponent, predicted class) are computed once per chunk and all kernels then run over the
+     * chunk while it is in cache.
+     * Objects are split into the same parallel blocks as in TAdditiveMetric::Eval and summation order
+     * is the same, so results are equal to results of Eval of the corresponding metrics.
+     */
+    TVector<TMetricHolder> EvalFusedMetricKernels(
+        TConstArrayRef<TFusedMetricKernel> kernels,
+        TConstArrayRef<double> approx,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        int begin,
+        int end,
+        NPar::TLocalExecutor& executor
+    );
+}
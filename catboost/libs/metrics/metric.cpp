@@ -27,6 +27,8 @@
 #include <util/string/cast.h>
 #include <util/string/iterator.h>
 #include <util/string/printf.h>
+#include <util/system/guard.h>
+#include <util/system/spinlock.h>
 #include <util/system/yassert.h>
 
 #include <limits>
@@ -122,6 +124,17 @@ bool TMetric::NeedTarget() const {
     return GetErrorType() != EErrorType::PairwiseError;
 }
 
+TMaybe<NMetrics::TFusedMetricKernel> TMetric::GetFusedKernel() const {
+    return Nothing();
+}
+
+static NMetrics::TFusedMetricKernel MakeFusedKernel(const IMetric& metric, NMetrics::EFusedMetricKernel kernelType) {
+    NMetrics::TFusedMetricKernel kernel;
+    kernel.Kernel = kernelType;
+    kernel.UseWeights = metric.UseWeights.IsIgnored() || metric.UseWeights.Get();
+    return kernel;
+}
+
 static inline TConstArrayRef<double> GetRowRef(const TVector<TVector<double>>& matrix, size_t rowIdx) {
     if (matrix.empty()) {
         return TArrayRef<double>();
@@ -151,6 +164,7 @@ namespace {
         ) const;
         TString GetDescription() const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        TMaybe<NMetrics::TFusedMetricKernel> GetFusedKernel() const override;
 
     private:
         ELossFunction LossFunction;
@@ -262,6 +276,13 @@ void TCrossEntropyMetric::GetBestValue(EMetricBestValue* valueType, float*) cons
     *valueType = EMetricBestValue::Min;
 }
 
+TMaybe<NMetrics::TFusedMetricKernel> TCrossEntropyMetric::GetFusedKernel() const {
+    auto kernel = MakeFusedKernel(*this, NMetrics::EFusedMetricKernel::CrossEntropy);
+    kernel.BinarizeTarget = LossFunction == ELossFunction::Logloss;
+    kernel.Border = Border;
+    return kernel;
+}
+
 /* CtrFactor */
 
 namespace {
@@ -349,6 +370,7 @@ namespace {
         TString GetDescription() const override;
         double GetFinalError(const TMetricHolder& error) const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        TMaybe<NMetrics::TFusedMetricKernel> GetFusedKernel() const override;
     };
 }
 
@@ -408,6 +430,10 @@ void TRMSEMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
     *valueType = EMetricBestValue::Min;
 }
 
+TMaybe<NMetrics::TFusedMetricKernel> TRMSEMetric::GetFusedKernel() const {
+    return MakeFusedKernel(*this, NMetrics::EFusedMetricKernel::RMSE);
+}
+
 /* Lq */
 
 namespace {
@@ -506,6 +532,7 @@ namespace {
         ) const;
         TString GetDescription() const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        TMaybe<NMetrics::TFusedMetricKernel> GetFusedKernel() const override;
 
     private:
         ELossFunction LossFunction;
@@ -582,6 +609,13 @@ void TQuantileMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
     *valueType = EMetricBestValue::Min;
 }
 
+TMaybe<NMetrics::TFusedMetricKernel> TQuantileMetric::GetFusedKernel() const {
+    auto kernel = MakeFusedKernel(*this, NMetrics::EFusedMetricKernel::Quantile);
+    kernel.Alpha = Alpha;
+    kernel.IsMAE = LossFunction == ELossFunction::MAE;
+    return kernel;
+}
+
 /* LogLinQuantile */
 
 namespace {
@@ -1666,9 +1700,24 @@ namespace {
         TString GetDescription() const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
 
+        // not thread-safe, call before evaluations
+        void AddIdealDcgCache(const TTargetDependentCacheData& dataset, NPar::TLocalExecutor* localExecutor);
+
+    private:
+        // ideal DCG of all queries, nullptr if they are not cached for these arrays
+        const TVector<double>* GetIdealDcgs(TConstArrayRef<float> target, TConstArrayRef<TQueryInfo> queriesInfo) const;
+
     private:
         int TopSize;
         ENdcgMetricType MetricType;
+
+        struct TIdealDcgCacheEntry {
+            TTargetDependentCacheData Dataset;
+            TVector<double> IdealDcgs; // [queryIdx]
+        };
+
+        // only datasets passed to EnableTargetDependentCaches, read-only during evaluations
+        TVector<TIdealDcgCacheEntry> IdealDcgCache; // [dataset]
     };
 }
 
@@ -1694,22 +1743,62 @@ TMetricHolder TNdcgMetric::EvalSingleThread(
     Y_ASSERT(approxDelta.empty());
     Y_ASSERT(!isExpApprox);
     TMetricHolder error(2);
-    TVector<NMetrics::TSample> samples;
+    const TVector<double>* idealDcgs = GetIdealDcgs(target, queriesInfo);
+    NMetrics::TDcgCalcer calcer(MetricType, /*expDecay*/ Nothing(), TopSize);
     for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
         const auto queryBegin = queriesInfo[queryIndex].Begin;
         const auto queryEnd = queriesInfo[queryIndex].End;
         const auto querySize = queryEnd - queryBegin;
         const float queryWeight = UseWeights ? queriesInfo[queryIndex].Weight : 1.f;
-        NMetrics::TSample::FromVectors(
-            MakeArrayRef(target.data() + queryBegin, querySize),
+        const double ndcg = calcer.CalcNdcg(
             MakeArrayRef(approx.front().data() + queryBegin, querySize),
-            &samples);
-        error.Stats[0] += queryWeight * CalcNdcg(samples, MetricType, TopSize);
+            MakeArrayRef(target.data() + queryBegin, querySize),
+            idealDcgs ? MakeMaybe((*idealDcgs)[queryIndex]) : Nothing());
+        error.Stats[0] += queryWeight * ndcg;
         error.Stats[1] += queryWeight;
     }
     return error;
 }
 
+void TNdcgMetric::AddIdealDcgCache(const TTargetDependentCacheData& dataset, NPar::TLocalExecutor* localExecutor) {
+    if (dataset.QueriesInfo.empty() || GetIdealDcgs(dataset.Target, dataset.QueriesInfo)) {
+        return;
+    }
+    const auto& queriesInfo = dataset.QueriesInfo;
+    TVector<double> idealDcgs;
+    idealDcgs.yresize(queriesInfo.size());
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, queriesInfo.ysize());
+    blockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+    localExecutor->ExecRangeWithThrow(
+        [&](int blockIdx) {
+            NMetrics::TDcgCalcer calcer(MetricType, /*expDecay*/ Nothing(), TopSize);
+            const int blockStart = blockIdx * blockParams.GetBlockSize();
+            const int blockEnd = Min(blockStart + blockParams.GetBlockSize(), queriesInfo.ysize());
+            for (int queryIndex = blockStart; queryIndex < blockEnd; ++queryIndex) {
+                const auto queryBegin = queriesInfo[queryIndex].Begin;
+                const auto querySize = queriesInfo[queryIndex].End - queryBegin;
+                idealDcgs[queryIndex] = calcer.CalcIDcg(MakeArrayRef(dataset.Target.data() + queryBegin, querySize));
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+    IdealDcgCache.push_back({dataset, std::move(idealDcgs)});
+}
+
+const TVector<double>* TNdcgMetric::GetIdealDcgs(TConstArrayRef<float> target, TConstArrayRef<TQueryInfo> queriesInfo) const {
+    for (const auto& entry : IdealDcgCache) {
+        const auto& dataset = entry.Dataset;
+        if (dataset.Target.data() == target.data() && dataset.Target.size() == target.size()
+            && dataset.QueriesInfo.data() == queriesInfo.data() && dataset.QueriesInfo.size() == queriesInfo.size())
+        {
+            return &entry.IdealDcgs;
+        }
+    }
+    return nullptr;
+}
+
 TString TNdcgMetric::GetDescription() const {
     const TMetricParam<int> topSize("top", TopSize, TopSize != -1);
     const TMetricParam<ENdcgMetricType> type("type", MetricType, true);
@@ -1944,14 +2033,16 @@ void TR2Metric::GetBestValue(EMetricBestValue* valueType, float*) const {
 
 namespace {
     struct TAUCMetric: public TNonAdditiveMetric {
-        explicit TAUCMetric(double border = GetDefaultClassificationBorder())
-                : Border(border) {
+        explicit TAUCMetric(double border = GetDefaultClassificationBorder(), ui32 binCount = 0)
+                : Border(border)
+                , BinCount("bins", binCount, binCount != 0) {
             UseWeights.SetDefaultValue(false);
         }
 
-        explicit TAUCMetric(int positiveClass)
+        explicit TAUCMetric(int positiveClass, ui32 binCount = 0)
             : PositiveClass(positiveClass)
-            , IsMultiClass(true) {
+            , IsMultiClass(true)
+            , BinCount("bins", binCount, binCount != 0) {
         }
 
         TMetricHolder Eval(
@@ -1981,15 +2072,23 @@ namespace {
         int PositiveClass = 1;
         bool IsMultiClass = false;
         double Border = GetDefaultClassificationBorder();
+
+        // if not 0 AUC is approximated by histogram with this number of bins
+        TMetricParam<ui32> BinCount;
+
+        // reused between evaluations to avoid allocations, guarded by ScratchLock
+        mutable TVector<NMetrics::TBinClassSample> Samples;
+        mutable TVector<NMetrics::TBinClassSample> SortAux;
+        mutable TAdaptiveLock ScratchLock;
     };
 }
 
-THolder<IMetric> MakeBinClassAucMetric(double border) {
-    return MakeHolder<TAUCMetric>(border);
+THolder<IMetric> MakeBinClassAucMetric(double border, ui32 binCount) {
+    return MakeHolder<TAUCMetric>(border, binCount);
 }
 
-THolder<IMetric> MakeMultiClassAucMetric(int positiveClass) {
-    return MakeHolder<TAUCMetric>(positiveClass);
+THolder<IMetric> MakeMultiClassAucMetric(int positiveClass, ui32 binCount) {
+    return MakeHolder<TAUCMetric>(positiveClass, binCount);
 }
 
 TMetricHolder TAUCMetric::Eval(
@@ -2001,45 +2100,53 @@ TMetricHolder TAUCMetric::Eval(
     TConstArrayRef<TQueryInfo> /*queriesInfo*/,
     int begin,
     int end,
-    NPar::TLocalExecutor& /* executor */
+    NPar::TLocalExecutor& executor
 ) const {
     Y_ASSERT(!isExpApprox);
     Y_ASSERT((approx.size() > 1) == IsMultiClass);
-    const auto& approxVec = approx.ysize() == 1 ? approx.front() : approx[PositiveClass];
+    const int approxIdx = approx.ysize() == 1 ? 0 : PositiveClass;
+    const auto& approxVec = approx[approxIdx];
     Y_ASSERT(approxVec.size() == target.size());
+    const TConstArrayRef<double> approxDeltaVec = approxDelta.empty() ?
+        TConstArrayRef<double>() : approxDelta[approxIdx];
     auto weight = UseWeights ? weightIn : TConstArrayRef<float>{};
 
-    TVector<double> approxCopy(approxVec.begin() + begin, approxVec.begin() + end);
-    if (!approxDelta.empty()) {
-        for (int idx : xrange(begin, end)) {
-            approxCopy[idx - begin] += approxDelta[0][idx];
-        }
-    }
-    TVector<double> targetCopy(target.begin() + begin, target.begin() + end);
-
-    if (!IsMultiClass) {
-        for (ui32 i = 0; i < targetCopy.size(); ++i) {
-            targetCopy[i] = targetCopy[i] > Border;
+    // used only if scratch buffers are busy with concurrent evaluation
+    TVector<NMetrics::TBinClassSample> localSamples;
+    TVector<NMetrics::TBinClassSample> localSortAux;
+
+    TTryGuard<TAdaptiveLock> scratchGuard(ScratchLock);
+    auto& samples = scratchGuard ? Samples : localSamples;
+    auto& sortAux = scratchGuard ? SortAux : localSortAux;
+
+    samples.yresize(end - begin);
+
+    const bool isMultiClass = IsMultiClass;
+    const double border = Border;
+    const int positiveClass = PositiveClass;
+    NPar::ParallelFor(
+        executor,
+        begin,
+        end,
+        [&] (int idx) {
+            const double prediction = approxVec[idx] + (approxDeltaVec.empty() ? 0.0 : approxDeltaVec[idx]);
+            const bool isPositive = isMultiClass ?
+                (target[idx] == static_cast<float>(positiveClass))
+                : (target[idx] > border);
+            samples[idx - begin] = NMetrics::TBinClassSample(
+                prediction,
+                isPositive,
+                weight.empty() ? 1.0f : weight[idx]
+            );
         }
-    }
-
-    if (approx.ysize() > 1) {
-        int positiveClass = PositiveClass;
-        ForEach(targetCopy.begin(), targetCopy.end(), [positiveClass](double& x) {
-            x = (x == static_cast<double>(positiveClass));
-        });
-    }
+    );
 
-    TVector<NMetrics::TSample> samples;
-    if (weight.empty()) {
-        samples = NMetrics::TSample::FromVectors(targetCopy, approxCopy);
+    TMetricHolder error(2);
+    if (BinCount.Get()) {
+        error.Stats[0] = CalcBinClassBinnedAUC(samples, BinCount.Get(), &executor);
     } else {
-        TVector<double> weightCopy(weight.begin() + begin, weight.begin() + end);
-        samples = NMetrics::TSample::FromVectors(targetCopy, approxCopy, weightCopy);
+        error.Stats[0] = CalcBinClassAUC(samples, &sortAux, &executor);
     }
-
-    TMetricHolder error(2);
-    error.Stats[0] = CalcAUC(&samples);
     error.Stats[1] = 1.0;
     return error;
 }
@@ -2047,9 +2154,9 @@ TMetricHolder TAUCMetric::Eval(
 TString TAUCMetric::GetDescription() const {
     if (IsMultiClass) {
         const TMetricParam<int> positiveClass("class", PositiveClass, /*userDefined*/true);
-        return BuildDescription(ELossFunction::AUC, UseWeights, positiveClass);
+        return BuildDescription(ELossFunction::AUC, UseWeights, positiveClass, BinCount);
     } else {
-        return BuildDescription(ELossFunction::AUC, UseWeights, "%.3g", MakeBorderParam(Border));
+        return BuildDescription(ELossFunction::AUC, UseWeights, "%.3g", MakeBorderParam(Border), BinCount);
     }
 }
 
@@ -2077,6 +2184,7 @@ namespace {
         ) const;
         TString GetDescription() const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        TMaybe<NMetrics::TFusedMetricKernel> GetFusedKernel() const override;
 
     private:
         double Border = GetDefaultClassificationBorder();
@@ -2111,6 +2219,12 @@ void TAccuracyMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
     *valueType = EMetricBestValue::Max;
 }
 
+TMaybe<NMetrics::TFusedMetricKernel> TAccuracyMetric::GetFusedKernel() const {
+    auto kernel = MakeFusedKernel(*this, NMetrics::EFusedMetricKernel::Accuracy);
+    kernel.Border = Border;
+    return kernel;
+}
+
 /* Precision */
 
 namespace {
@@ -2137,6 +2251,7 @@ namespace {
         TString GetDescription() const override;
         double GetFinalError(const TMetricHolder& error) const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        TMaybe<NMetrics::TFusedMetricKernel> GetFusedKernel() const override;
 
     private:
         int PositiveClass = 1;
@@ -2193,6 +2308,15 @@ double TPrecisionMetric::GetFinalError(const TMetricHolder& error) const {
     return error.Stats[1] != 0 ? error.Stats[0] / error.Stats[1] : 1;
 }
 
+TMaybe<NMetrics::TFusedMetricKernel> TPrecisionMetric::GetFusedKernel() const {
+    if (IsMultiClass) {
+        return Nothing();
+    }
+    auto kernel = MakeFusedKernel(*this, NMetrics::EFusedMetricKernel::Precision);
+    kernel.Border = Border;
+    return kernel;
+}
+
 /* Recall */
 
 namespace {
@@ -2220,6 +2344,7 @@ namespace {
         TString GetDescription() const override;
         double GetFinalError(const TMetricHolder& error) const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        TMaybe<NMetrics::TFusedMetricKernel> GetFusedKernel() const override;
 
     private:
         int PositiveClass = 1;
@@ -2286,6 +2411,15 @@ void TRecallMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
     *valueType = EMetricBestValue::Max;
 }
 
+TMaybe<NMetrics::TFusedMetricKernel> TRecallMetric::GetFusedKernel() const {
+    if (IsMultiClass) {
+        return Nothing();
+    }
+    auto kernel = MakeFusedKernel(*this, NMetrics::EFusedMetricKernel::Recall);
+    kernel.Border = Border;
+    return kernel;
+}
+
 /* Balanced Accuracy */
 
 namespace {
@@ -3442,6 +3576,9 @@ namespace {
         bool NeedTarget() const override {
             return true;
         }
+        TMaybe<NMetrics::TFusedMetricKernel> GetFusedKernel() const override {
+            return Nothing();
+        }
     private:
         TCustomMetricDescriptor Descriptor;
         TMap<TString, TString> Hints;
@@ -4094,13 +4231,15 @@ static TVector<THolder<IMetric>> CreateMetric(ELossFunction metric, TMap<TString
             break;
         }
         case ELossFunction::AUC: {
+            const ui32 binCount = params.contains("bins") ? FromString<ui32>(params.at("bins")) : 0;
             if (approxDimension == 1) {
-                result.push_back(MakeBinClassAucMetric(border));
-                validParams = {"border"};
+                result.push_back(MakeBinClassAucMetric(border, binCount));
+                validParams = {"border", "bins"};
             } else {
                 for (int i = 0; i < approxDimension; ++i) {
-                    result.push_back(MakeMultiClassAucMetric(i));
+                    result.push_back(MakeMultiClassAucMetric(i, binCount));
                 }
+                validParams = {"bins"};
             }
             break;
         }
@@ -4402,6 +4541,20 @@ TVector<TString> GetMetricsDescription(const TVector<THolder<IMetric>>& metrics)
     return GetMetricsDescription(GetConstPointers(metrics));
 }
 
+void EnableTargetDependentCaches(
+    const TVector<THolder<IMetric>>& metrics,
+    TConstArrayRef<TTargetDependentCacheData> datasets,
+    NPar::TLocalExecutor* localExecutor
+) {
+    for (const auto& metric : metrics) {
+        if (auto* ndcgMetric = dynamic_cast<TNdcgMetric*>(metric.Get())) {
+            for (const auto& dataset : datasets) {
+                ndcgMetric->AddIdealDcgCache(dataset, localExecutor);
+            }
+        }
+    }
+}
+
 TVector<bool> GetSkipMetricOnTrain(const TVector<const IMetric*>& metrics) {
     TVector<bool> result;
     result.reserve(metrics.size());
@@ -4426,23 +4579,77 @@ TVector<bool> GetSkipMetricOnTest(bool testHasTarget, const TVector<const IMetri
 }
 
 
-TMetricHolder EvalErrors(
+static TMetricHolder EvalErrors(
         const TVector<TVector<double>>& approx,
         TConstArrayRef<float> target,
         TConstArrayRef<float> weight,
         TConstArrayRef<TQueryInfo> queriesInfo,
-        const THolder<IMetric>& error,
+        const IMetric& error,
         NPar::TLocalExecutor* localExecutor
 ) {
-    if (error->GetErrorType() == EErrorType::PerObjectError) {
+    if (error.GetErrorType() == EErrorType::PerObjectError) {
         int begin = 0, end = target.size();
         Y_VERIFY(approx[0].ysize() == end - begin);
-        return error->Eval(approx, target, weight, queriesInfo, begin, end, *localExecutor);
+        return error.Eval(approx, target, weight, queriesInfo, begin, end, *localExecutor);
     } else {
-        Y_VERIFY(error->GetErrorType() == EErrorType::QuerywiseError || error->GetErrorType() == EErrorType::PairwiseError);
+        Y_VERIFY(error.GetErrorType() == EErrorType::QuerywiseError || error.GetErrorType() == EErrorType::PairwiseError);
         int queryStartIndex = 0, queryEndIndex = queriesInfo.size();
-        return error->Eval(approx, target, weight, queriesInfo, queryStartIndex, queryEndIndex, *localExecutor);
+        return error.Eval(approx, target, weight, queriesInfo, queryStartIndex, queryEndIndex, *localExecutor);
+    }
+}
+
+
+TMetricHolder EvalErrors(
+        const TVector<TVector<double>>& approx,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        const THolder<IMetric>& error,
+        NPar::TLocalExecutor* localExecutor
+) {
+    return EvalErrors(approx, target, weight, queriesInfo, *error, localExecutor);
+}
+
+
+TVector<TMetricHolder> EvalErrors(
+        const TVector<TVector<double>>& approx,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        TConstArrayRef<const IMetric*> metrics,
+        NPar::TLocalExecutor* localExecutor
+) {
+    TVector<TMetricHolder> result(metrics.size());
+
+    const bool canFuse = approx.size() == 1 && !target.empty();
+    TVector<NMetrics::TFusedMetricKernel> fusedKernels;
+    TVector<size_t> fusedMetricIndices;
+    for (auto metricIdx : xrange(metrics.size())) {
+        const auto fusedKernel = canFuse ? metrics[metricIdx]->GetFusedKernel() : Nothing();
+        if (fusedKernel) {
+            fusedKernels.push_back(*fusedKernel);
+            fusedMetricIndices.push_back(metricIdx);
+        } else {
+            result[metricIdx] = EvalErrors(approx, target, weight, queriesInfo, *metrics[metricIdx], localExecutor);
+        }
     }
+
+    if (!fusedKernels.empty()) {
+        Y_VERIFY(approx[0].size() == target.size());
+        auto fusedResults = NMetrics::EvalFusedMetricKernels(
+            fusedKernels,
+            approx[0],
+            target,
+            weight,
+            /*begin*/ 0,
+            /*end*/ target.size(),
+            *localExecutor
+        );
+        for (auto fusedIdx : xrange(fusedMetricIndices.size())) {
+            result[fusedMetricIndices[fusedIdx]] = std::move(fusedResults[fusedIdx]);
+        }
+    }
+    return result;
 }
 
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "fused_metrics.h"
 #include "metric_holder.h"
 #include "pfound.h"
 
@@ -13,7 +14,10 @@
 #include <library/threading/local_executor/local_executor.h>
 #include <library/containers/2d_array/2d_array.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
+#include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
 
 #include <cmath>
 
@@ -124,6 +128,8 @@ struct IMetric {
     virtual const TMap<TString, TString>& GetHints() const = 0;
     virtual void AddHint(const TString& key, const TString& value) = 0;
     virtual bool NeedTarget() const = 0;
+    // defined for additive per-object metrics which can be evaluated together with others in one pass
+    virtual TMaybe<NMetrics::TFusedMetricKernel> GetFusedKernel() const = 0;
     virtual ~IMetric() = default;
 
 public:
@@ -137,6 +143,7 @@ struct TMetric: public IMetric {
     virtual const TMap<TString, TString>& GetHints() const override;
     virtual void AddHint(const TString& key, const TString& value) override;
     virtual bool NeedTarget() const override;
+    virtual TMaybe<NMetrics::TFusedMetricKernel> GetFusedKernel() const override;
 private:
     TMap<TString, TString> Hints;
 };
@@ -258,8 +265,9 @@ THolder<IMetric> MakeQuerySoftMaxMetric();
 
 THolder<IMetric> MakeStochasticFilterMetric();
 
-THolder<IMetric> MakeBinClassAucMetric(double border = GetDefaultClassificationBorder());
-THolder<IMetric> MakeMultiClassAucMetric(int positiveClass);
+// binCount > 0 - approximate AUC with histogram of predictions, linear-time
+THolder<IMetric> MakeBinClassAucMetric(double border = GetDefaultClassificationBorder(), ui32 binCount = 0);
+THolder<IMetric> MakeMultiClassAucMetric(int positiveClass, ui32 binCount = 0);
 
 THolder<IMetric> MakeAccuracyMetric(double border = GetDefaultClassificationBorder());
 
@@ -337,6 +345,23 @@ TVector<THolder<IMetric>> CreateMetrics(
 TVector<TString> GetMetricsDescription(const TVector<const IMetric*>& metrics);
 TVector<TString> GetMetricsDescription(const TVector<THolder<IMetric>>& metrics);
 
+/* Target and queries of a dataset that don't change while metrics are evaluated on it (as during training).
+ * Owner (if not null) keeps the arrays alive, so their addresses can't be reused by other data.
+ */
+struct TTargetDependentCacheData {
+    TConstArrayRef<float> Target;
+    TConstArrayRef<TQueryInfo> QueriesInfo;
+    TIntrusivePtr<TThrRefBase> Owner;
+};
+
+/* Metrics compute values that depend only on target and queries of datasets (NDCG computes ideal DCG of queries)
+ * once and reuse them when they are evaluated on the same arrays.
+ */
+void EnableTargetDependentCaches(
+    const TVector<THolder<IMetric>>& metrics,
+    TConstArrayRef<TTargetDependentCacheData> datasets,
+    NPar::TLocalExecutor* localExecutor);
+
 TVector<bool> GetSkipMetricOnTrain(const TVector<const IMetric*>& metrics);
 TVector<bool> GetSkipMetricOnTrain(const TVector<THolder<IMetric>>& metrics);
 
@@ -351,6 +376,18 @@ TMetricHolder EvalErrors(
     NPar::TLocalExecutor* localExecutor
 );
 
+/* Same as EvalErrors for each metric, results are in the same order.
+ * For single-dimensional approx metrics with GetFusedKernel() are evaluated in one shared pass over data.
+ */
+TVector<TMetricHolder> EvalErrors(
+    const TVector<TVector<double>>& approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    TConstArrayRef<const IMetric*> metrics,
+    NPar::TLocalExecutor* localExecutor
+);
+
 TMetricHolder EvalErrors(
     const TVector<TVector<double>>& approx,
     const TVector<TVector<double>>& approxDelta,
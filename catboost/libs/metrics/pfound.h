@@ -21,24 +21,36 @@ public:
 
     template <bool isExpApprox, bool hasDelta, class TRelevsType, class TApproxType>
     void AddQuery(const TRelevsType* relevs, const TApproxType* approxes, const TApproxType* approxDelta, float queryWeight, const ui32* subgroupData, ui32 querySize) {
-        TVector<int> qurls(querySize);
-        std::iota(qurls.begin(), qurls.end(), 0);
-        Sort(qurls.begin(), qurls.end(), [&](int left, int right) -> bool {
+        const auto compare = [&](int left, int right) -> bool {
             if (hasDelta) {
                 if (isExpApprox) {
                     return CompareDocs(approxes[left] * approxDelta[left], relevs[left], approxes[right] * approxDelta[right], relevs[right]);
-            } else {
+                } else {
                     return CompareDocs(approxes[left] + approxDelta[left], relevs[left], approxes[right] + approxDelta[right], relevs[right]);
                 }
             } else {
                 return CompareDocs(approxes[left], relevs[left], approxes[right], relevs[right]);
             }
-        });
+        };
 
-        double pLook = 1, pFound = 0;
+        // buffers are reused between queries
+        auto& qurls = Qurls;
+        qurls.yresize(querySize);
+        std::iota(qurls.begin(), qurls.end(), 0);
         const ui32 depth = Min<ui32>(querySize, Depth);
+        if (subgroupData == nullptr && depth < querySize) {
+            // documents equal by compare have equal relevs, so only top positions have to be ordered
+            NthElement(qurls.begin(), qurls.begin() + depth, qurls.end(), compare);
+            Sort(qurls.begin(), qurls.begin() + depth, compare);
+        } else {
+            // order of documents with equal relevs and different subgroups matters
+            Sort(qurls.begin(), qurls.end(), compare);
+        }
+
+        double pLook = 1, pFound = 0;
 
-        TSet<ui32> subgroupIds;
+        auto& subgroupIds = SubgroupIds;
+        subgroupIds.clear();
         for (ui32 position = 0; position < depth; position++) {
             const int docId = qurls[position];
             if (subgroupData != nullptr) {
@@ -70,4 +82,7 @@ private:
     const ui32 Depth = -1;
     const double Decay = 0.85f;
     TMetricHolder Statistic;
+
+    TVector<int> Qurls;
+    TSet<ui32> SubgroupIds;
 };
@@ -0,0 +1,90 @@
+#include <library/unittest/registar.h>
+
+#include <catboost/libs/metrics/auc.h>
+#include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/metrics/metric_holder.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+#include <cmath>
+
+
+Y_UNIT_TEST_SUITE(AUCMetricTest) {
+    static void GenerateSamples(
+        ui32 sampleCount,
+        ui32 distinctPredictionCount,
+        TVector<NMetrics::TBinClassSample>* binClassSamples,
+        TVector<NMetrics::TSample>* samples
+    ) {
+        TFastRng64 rng(0);
+        binClassSamples->clear();
+        samples->clear();
+        for (auto i : xrange(sampleCount)) {
+            Y_UNUSED(i);
+            const double prediction = rng.Uniform(distinctPredictionCount) / 10.0 - 3.0;
+            const bool isPositive = rng.GenRandReal1() < 1.0 / (1.0 + exp(-prediction));
+            const float weight = 0.5f + (float)rng.GenRandReal1();
+            binClassSamples->emplace_back(prediction, isPositive, weight);
+            samples->emplace_back(isPositive ? 1.0 : 0.0, prediction, weight);
+        }
+    }
+
+    Y_UNIT_TEST(TestExactEqualsGeneric) {
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+
+        for (ui32 sampleCount : {1u, 10u, 1000u, 300000u}) {
+            TVector<NMetrics::TBinClassSample> binClassSamples;
+            TVector<NMetrics::TSample> samples;
+            GenerateSamples(sampleCount, 60, &binClassSamples, &samples);
+
+            double expectedPairWeightSum = 0;
+            const double expected = CalcAUC(&samples, nullptr, &expectedPairWeightSum);
+
+            TVector<NMetrics::TBinClassSample> aux;
+            double pairWeightSum = 0;
+            const double auc = CalcBinClassAUC(binClassSamples, &aux, &executor, &pairWeightSum);
+
+            UNIT_ASSERT_DOUBLES_EQUAL(auc, expected, 1e-9);
+            UNIT_ASSERT_DOUBLES_EQUAL(pairWeightSum, expectedPairWeightSum, 1e-6 * Max(1.0, expectedPairWeightSum));
+        }
+    }
+
+    Y_UNIT_TEST(TestBinnedIsCloseToExact) {
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+
+        TVector<NMetrics::TBinClassSample> binClassSamples;
+        TVector<NMetrics::TSample> samples;
+        GenerateSamples(200000, 100000, &binClassSamples, &samples);
+
+        const double binned = CalcBinClassBinnedAUC(binClassSamples, 4096, &executor);
+
+        TVector<NMetrics::TBinClassSample> aux;
+        const double exact = CalcBinClassAUC(binClassSamples, &aux, &executor);
+
+        UNIT_ASSERT_DOUBLES_EQUAL(binned, exact, 1e-3);
+    }
+
+    Y_UNIT_TEST(TestMetricBins) {
+        TVector<TVector<double>> approx{{0.1, 0.4, 0.35, 0.8}};
+        TVector<float> target{0, 0, 1, 1};
+        TVector<float> weight{1, 1, 1, 1};
+
+        NPar::TLocalExecutor executor;
+        {
+            const auto metric = MakeBinClassAucMetric();
+            TMetricHolder score = metric->Eval(approx, target, weight, {}, 0, target.size(), executor);
+            UNIT_ASSERT_DOUBLES_EQUAL(metric->GetFinalError(score), 0.75, 1e-9);
+            UNIT_ASSERT_VALUES_EQUAL(metric->GetDescription(), "AUC");
+        }
+        {
+            const auto metric = MakeBinClassAucMetric(GetDefaultClassificationBorder(), 1 << 16);
+            TMetricHolder score = metric->Eval(approx, target, weight, {}, 0, target.size(), executor);
+            UNIT_ASSERT_DOUBLES_EQUAL(metric->GetFinalError(score), 0.75, 1e-9);
+            UNIT_ASSERT_VALUES_EQUAL(metric->GetDescription(), "AUC:bins=65536");
+        }
+    }
+}
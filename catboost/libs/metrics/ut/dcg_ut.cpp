@@ -8,6 +8,7 @@
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 #include <util/random/fast.h>
 
 Y_UNIT_TEST_SUITE(NdcgTests) {
@@ -188,4 +189,66 @@ Y_UNIT_TEST_SUITE(NdcgTests) {
         expected.Stats[1] = 181600;
         TestNdcg("NDCG:top=15;type=Exp;use_weights=false", 1000000, 10, 5, 1, 20181129, 1e-6, expected);
     }
+
+    Y_UNIT_TEST(TestDcgCalcerEqualsSampleFunctions) {
+        TFastRng<ui64> prng(20190101);
+        for (ui32 topSize : {1u, 3u, 10u, Max<ui32>()}) {
+            for (auto type : {ENdcgMetricType::Base, ENdcgMetricType::Exp}) {
+                for (TMaybe<double> expDecay : {TMaybe<double>(), MakeMaybe(0.85)}) {
+                    NMetrics::TDcgCalcer calcer(type, expDecay, topSize);
+                    for (ui32 querySize : {1u, 2u, 7u, 30u}) {
+                        TVector<float> target(querySize);
+                        TVector<double> approx(querySize);
+                        for (auto i : xrange(querySize)) {
+                            // few distinct values to have ties
+                            target[i] = prng.Uniform(4);
+                            approx[i] = prng.Uniform(5);
+                        }
+                        const auto samples = NMetrics::TSample::FromVectors(target, approx);
+                        UNIT_ASSERT_VALUES_EQUAL(calcer.CalcDcg(approx, target), CalcDcg(samples, type, expDecay, topSize));
+                        UNIT_ASSERT_VALUES_EQUAL(calcer.CalcIDcg(target), CalcIDcg(samples, type, expDecay, topSize));
+                        if (!expDecay) {
+                            UNIT_ASSERT_VALUES_EQUAL(calcer.CalcNdcg(approx, target), CalcNdcg(samples, type, topSize));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestNdcgWithIdealDcgCache) {
+        TVector<TQueryInfo> queryInfos;
+        TVector<float> targets;
+        TVector<TVector<double>> approxes(1);
+        TFastRng<ui64> prng(20190102);
+        for (ui32 begin = 0; begin < 100000;) {
+            const ui32 size = prng.Uniform(20) + 1;
+            queryInfos.emplace_back(begin, begin + size);
+            queryInfos.back().Weight = prng.GenRandReal1();
+            for (auto i : xrange(size)) {
+                Y_UNUSED(i);
+                targets.push_back(prng.Uniform(5));
+                approxes[0].push_back(prng.GenRandReal1());
+            }
+            begin += size;
+        }
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        for (const auto& description : {"NDCG:top=5;type=Base", "NDCG:type=Exp"}) {
+            const auto metrics = CreateMetricsFromDescription({description}, 1);
+            const auto cachingMetrics = CreateMetricsFromDescription({description}, 1);
+            EnableTargetDependentCaches(cachingMetrics, {{targets, queryInfos, /*owner*/ nullptr}}, &executor);
+            // ideal DCG is cached at the first iteration and approxes are changed after it
+            for (auto iteration : xrange(2)) {
+                Y_UNUSED(iteration);
+                const auto expected = metrics[0]->Eval(approxes, targets, {}, queryInfos, 0, queryInfos.size(), executor);
+                const auto cached = cachingMetrics[0]->Eval(approxes, targets, {}, queryInfos, 0, queryInfos.size(), executor);
+                UNIT_ASSERT_VALUES_EQUAL(cached.Stats, expected.Stats);
+                for (auto& approx : approxes[0]) {
+                    approx = -approx;
+                }
+            }
+        }
+    }
 }
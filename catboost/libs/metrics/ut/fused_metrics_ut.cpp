@@ -0,0 +1,61 @@
+#include <library/unittest/registar.h>
+
+#include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/metrics/metric_holder.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+Y_UNIT_TEST_SUITE(FusedMetricsTest) {
+    Y_UNIT_TEST(TestFusedEqualsSeparate) {
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+
+        TVector<THolder<IMetric>> metrics;
+        metrics.push_back(MakeCrossEntropyMetric(ELossFunction::Logloss));
+        metrics.push_back(MakeCrossEntropyMetric(ELossFunction::Logloss, 0.3));
+        metrics.push_back(MakeCrossEntropyMetric(ELossFunction::CrossEntropy));
+        metrics.push_back(MakeRMSEMetric());
+        metrics.push_back(MakeQuantileMetric(ELossFunction::MAE));
+        metrics.push_back(MakeQuantileMetric(ELossFunction::Quantile, 0.2));
+        metrics.push_back(MakeAccuracyMetric());
+        metrics.push_back(MakeBinClassPrecisionMetric());
+        metrics.push_back(MakeBinClassRecallMetric(0.7));
+        metrics.push_back(MakeBinClassAucMetric()); // not fused
+        metrics.push_back(MakeRMSEMetric());
+        metrics.back()->UseWeights = false;
+
+        const size_t aucMetricIdx = 9;
+
+        TVector<const IMetric*> metricPtrs;
+        for (auto metricIdx : xrange(metrics.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(metrics[metricIdx]->GetFusedKernel().Defined(), metricIdx != aucMetricIdx);
+            metricPtrs.push_back(metrics[metricIdx].Get());
+        }
+
+        for (ui32 objectCount : {1u, 1500u, 100000u}) {
+            TFastRng64 rng(objectCount);
+            TVector<TVector<double>> approx(1);
+            TVector<float> target;
+            TVector<float> weight;
+            for (auto i : xrange(objectCount)) {
+                Y_UNUSED(i);
+                approx[0].push_back(4.0 * rng.GenRandReal1() - 2.0);
+                target.push_back((float)rng.GenRandReal1());
+                weight.push_back(0.5f + (float)rng.GenRandReal1());
+            }
+
+            for (bool hasWeights : {false, true}) {
+                const TConstArrayRef<float> weightRef = hasWeights ? TConstArrayRef<float>(weight) : TConstArrayRef<float>();
+                const auto fusedStats = EvalErrors(approx, target, weightRef, {}, metricPtrs, &executor);
+                UNIT_ASSERT_VALUES_EQUAL(fusedStats.size(), metrics.size());
+                for (auto metricIdx : xrange(metrics.size())) {
+                    const auto stats = EvalErrors(approx, target, weightRef, {}, metrics[metricIdx], &executor);
+                    UNIT_ASSERT_VALUES_EQUAL(fusedStats[metricIdx].Stats, stats.Stats);
+                }
+            }
+        }
+    }
+}
@@ -38,6 +38,30 @@ public:
         const TVector<TOneHotFeature>& oheFeatures,
         const TVector<TCatFeature>& catFeatures) = 0;
 
+    /* Called after SetupBinFeatureIndexes, ctrFeatures are in the same order as used model ctrs.
+     * Providers can prepare evaluation of these ctrs here.
+     */
+    virtual void SetupCtrFeatures(const TVector<TCtrFeature>& /*ctrFeatures*/) {
+    }
+
+    virtual bool HasBinarizedCtrs(const TVector<TCtrFeature>& /*ctrFeatures*/) const {
+        return false;
+    }
+
+    /* Writes bins of ctr values with respect to ctr features borders without calculating the values,
+     * layout is the same as of binarized float features: for each ctr feature
+     * ceil(borders count / MAX_VALUES_PER_BIN) columns of docCount values.
+     * Can be used only if HasBinarizedCtrs(ctrFeatures).
+     */
+    virtual void CalcBinarizedCtrs(
+        const TVector<TCtrFeature>& /*ctrFeatures*/,
+        const TConstArrayRef<ui8>& /*binarizedFeatures*/, // vector of binarized float & one hot features
+        const TConstArrayRef<ui32>& /*hashedCatFeatures*/,
+        size_t /*docCount*/,
+        TArrayRef<ui8> /*result*/) {
+        Y_FAIL("Binarized ctrs calculation is not supported");
+    }
+
     virtual void AddCtrCalcerData(TCtrValueTable&& valueTable) = 0;
     virtual bool IsSerializable() const {
         return false;
@@ -2,10 +2,12 @@
 
 #include "model.h"
 
+#include <catboost/libs/cat_feature/cat_feature.h>
 #include <catboost/libs/helpers/exception.h>
 
 #include <util/generic/array_ref.h>
 #include <util/generic/hash.h>
+#include <util/generic/strbuf.h>
 #include <util/generic/utility.h>
 #include <util/generic/vector.h>
 #include <util/generic/ymath.h>
@@ -17,6 +19,7 @@
 #include <algorithm>
 #include <functional>
 #include <limits>
+#include <type_traits>
 
 #ifdef _sse2_
 #include <emmintrin.h>
@@ -290,11 +293,24 @@ inline void BinarizeFeatures(
                 continue;
             }
             catFeaturePackedIndexes[catFeature.FeatureIndex] = usedFeatureIdx;
-            for (size_t docId = 0, writeIdx = usedFeatureIdx * docCount;
-                 docId < docCount;
-                 ++docId, ++writeIdx)
-            {
-                transposedHash[writeIdx] = catFeatureAccessor(catFeature, start + docId);
+            if constexpr (std::is_convertible_v<decltype(catFeatureAccessor(catFeature, start)), TStringBuf>) {
+                // string values are hashed in one batch per block, see CalcCatFeatureHashes
+                Y_ASSERT(docCount <= FORMULA_EVALUATION_BLOCK_SIZE);
+                TStringBuf featureValues[FORMULA_EVALUATION_BLOCK_SIZE];
+                for (size_t docId = 0; docId < docCount; ++docId) {
+                    featureValues[docId] = catFeatureAccessor(catFeature, start + docId);
+                }
+                CalcCatFeatureHashes(
+                    MakeArrayRef(featureValues, docCount),
+                    MakeArrayRef(transposedHash.data() + usedFeatureIdx * docCount, docCount)
+                );
+            } else {
+                for (size_t docId = 0, writeIdx = usedFeatureIdx * docCount;
+                     docId < docCount;
+                     ++docId, ++writeIdx)
+                {
+                    transposedHash[writeIdx] = catFeatureAccessor(catFeature, start + docId);
+                }
             }
             ++usedFeatureIdx;
         }
@@ -306,6 +322,18 @@ inline void BinarizeFeatures(
             resultPtr,
             transposedHash
         );
+        const auto& ctrFeatures = model.ObliviousTrees.CtrFeatures;
+        if (!ctrFeatures.empty() && model.CtrProvider->HasBinarizedCtrs(ctrFeatures)) {
+            // bins of ctr values are precomputed in provider, no need to calc float ctrs
+            model.CtrProvider->CalcBinarizedCtrs(
+                ctrFeatures,
+                result,
+                transposedHash,
+                docCount,
+                MakeArrayRef(resultPtr, result.data() + result.size())
+            );
+            return;
+        }
         if (!model.ObliviousTrees.GetUsedModelCtrs().empty()) {
             model.CtrProvider->CalcCtrs(
                 model.ObliviousTrees.GetUsedModelCtrs(),
@@ -315,8 +343,8 @@ inline void BinarizeFeatures(
                 ctrs
             );
         }
-        for (size_t i = 0; i < model.ObliviousTrees.CtrFeatures.size(); ++i) {
-            const auto& ctr = model.ObliviousTrees.CtrFeatures[i];
+        for (size_t i = 0; i < ctrFeatures.size(); ++i) {
+            const auto& ctr = ctrFeatures[i];
             auto ctrFloatsPtr = &ctrs[i * docCount];
             BinarizeFloats<false>(
                 docCount,
@@ -621,8 +621,8 @@ void TFullModel::Calc(
         [&floatFeatures](const TFloatFeature& floatFeature, size_t index) -> float {
             return floatFeatures[index][floatFeature.FeatureIndex];
         },
-        [&catFeatures](const TCatFeature& catFeature, size_t index) -> int {
-            return CalcCatFeatureHash(catFeatures[index][catFeature.FeatureIndex]);
+        [&catFeatures](const TCatFeature& catFeature, size_t index) -> TStringBuf {
+            return catFeatures[index][catFeature.FeatureIndex];
         },
         docCount,
         treeStart,
@@ -750,6 +750,7 @@ public:
                 ObliviousTrees.FloatFeatures,
                 ObliviousTrees.OneHotFeatures,
                 ObliviousTrees.CatFeatures);
+            CtrProvider->SetupCtrFeatures(ObliviousTrees.CtrFeatures);
         }
     }
 };
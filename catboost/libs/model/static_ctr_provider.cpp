@@ -4,6 +4,9 @@
 
 #include <catboost/libs/model/model_export/export_helpers.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/hash.h>
+#include <util/generic/hash_set.h>
 #include <util/generic/xrange.h>
 #include <util/generic/set.h>
 #include <util/string/cast.h>
@@ -66,6 +69,230 @@ NJson::TJsonValue TStaticCtrProvider::ConvertCtrsToJson(const TVector<TModelCtr>
     return jsonValue;
 }
 
+static void CalcCtrValues(
+    const TModelCtr& ctr,
+    const TCtrValueTable& learnCtr,
+    TConstArrayRef<ui32> buckets,
+    float* resultPtr) {
+
+    const size_t samplesCount = buckets.size();
+    const ui32* ptrBuckets = buckets.data();
+    const ECtrType ctrType = ctr.Base.CtrType;
+    if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
+        const auto emptyVal = ctr.Calc(0.f, 0.f);
+        auto ctrMean = learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>();
+        for (size_t doc = 0; doc < samplesCount; ++doc) {
+            if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                const TCtrMeanHistory& ctrMeanHistory = ctrMean[ptrBuckets[doc]];
+                resultPtr[doc] = ctr.Calc(ctrMeanHistory.Sum, ctrMeanHistory.Count);
+            } else {
+                resultPtr[doc] = emptyVal;
+            }
+        }
+    } else if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+        TConstArrayRef<int> ctrTotal = learnCtr.GetTypedArrayRefForBlobData<int>();
+        const int denominator = learnCtr.CounterDenominator;
+        auto emptyVal = ctr.Calc(0, denominator);
+        for (size_t doc = 0; doc < samplesCount; ++doc) {
+            if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                resultPtr[doc] = ctr.Calc(ctrTotal[ptrBuckets[doc]], denominator);
+            } else {
+                resultPtr[doc] = emptyVal;
+            }
+        }
+    } else if (ctrType == ECtrType::Buckets) {
+        auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
+        const int targetClassesCount = learnCtr.TargetClassesCount;
+        auto emptyVal = ctr.Calc(0, 0);
+        for (size_t doc = 0; doc < samplesCount; ++doc) {
+            if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                int goodCount = 0;
+                int totalCount = 0;
+                auto ctrHistory = MakeArrayRef(ctrIntArray.data() + ptrBuckets[doc] * targetClassesCount, targetClassesCount);
+                goodCount = ctrHistory[ctr.TargetBorderIdx];
+                for (int classId = 0; classId < targetClassesCount; ++classId) {
+                    totalCount += ctrHistory[classId];
+                }
+                resultPtr[doc] = ctr.Calc(goodCount, totalCount);
+            } else {
+                resultPtr[doc] = emptyVal;
+            }
+        }
+    } else {
+        auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
+        const int targetClassesCount = learnCtr.TargetClassesCount;
+
+        auto emptyVal = ctr.Calc(0, 0);
+        if (targetClassesCount > 2) {
+            for (size_t doc = 0; doc < samplesCount; ++doc) {
+                int goodCount = 0;
+                int totalCount = 0;
+                if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                    auto ctrHistory = MakeArrayRef(ctrIntArray.data() + ptrBuckets[doc] * targetClassesCount, targetClassesCount);
+                    for (int classId = 0; classId < ctr.TargetBorderIdx + 1; ++classId) {
+                        totalCount += ctrHistory[classId];
+                    }
+                    for (int classId = ctr.TargetBorderIdx + 1; classId < targetClassesCount; ++classId) {
+                        goodCount += ctrHistory[classId];
+                    }
+                    totalCount += goodCount;
+                }
+                resultPtr[doc] = ctr.Calc(goodCount, totalCount);
+            }
+        } else {
+            for (size_t doc = 0; doc < samplesCount; ++doc) {
+                if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                    const int* ctrHistory = &ctrIntArray[ptrBuckets[doc] * 2];
+                    resultPtr[doc] = ctr.Calc(ctrHistory[1], ctrHistory[0] + ctrHistory[1]);
+                } else {
+                    resultPtr[doc] = emptyVal;
+                }
+            }
+        }
+    }
+}
+
+// 12-byte buckets, so smaller indexes take less than 768 KB
+constexpr size_t MinBucketCountForAlignedIndex = 1 << 16;
+
+// number of different ctr values (bucket indexes) stored in the table
+static size_t GetCtrValueCount(const TModelCtr& ctr, const TCtrValueTable& learnCtr) {
+    const ECtrType ctrType = ctr.Base.CtrType;
+    if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
+        return learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>().size();
+    } else if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+        return learnCtr.GetTypedArrayRefForBlobData<int>().size();
+    } else if (learnCtr.TargetClassesCount > 0) {
+        return learnCtr.GetTypedArrayRefForBlobData<int>().size() / learnCtr.TargetClassesCount;
+    }
+    return 0;
+}
+
+// same bins as BinarizeFloats produces for value
+static void CalcBins(float value, TConstArrayRef<float> borders, ui8* bins) {
+    for (size_t blockStart = 0; blockStart < borders.size(); blockStart += MAX_VALUES_PER_BIN) {
+        const size_t blockEnd = Min(blockStart + MAX_VALUES_PER_BIN, borders.size());
+        ui8 bin = 0;
+        for (size_t borderId = blockStart; borderId < blockEnd; ++borderId) {
+            bin += (ui8)(value > borders[borderId]);
+        }
+        *bins++ = bin;
+    }
+}
+
+TStaticCtrProvider::TEvaluationPlan TStaticCtrProvider::BuildEvaluationPlan(const TVector<TModelCtr>& neededCtrs) const {
+    TEvaluationPlan plan;
+    plan.ModelCtrs = neededCtrs;
+    if (neededCtrs.empty()) {
+        return plan;
+    }
+    auto compressedModelCtrs = NCatboostModelExportHelpers::CompressModelCtrs(plan.ModelCtrs);
+    size_t ctrIdx = 0;
+    for (const auto& compressedModelCtr : compressedModelCtrs) {
+        auto& proj = *compressedModelCtr.Projection;
+        auto& projection = plan.Projections.emplace_back();
+        for (const auto feature : proj.CatFeatures) {
+            projection.TransposedCatFeatureIndexes.push_back(CatFeatureIndex.at(feature));
+        }
+        for (const auto feature : proj.BinFeatures ) {
+            projection.BinarizedIndexes.push_back(FloatFeatureIndexes.at(feature));
+        }
+        for (const auto feature : proj.OneHotFeatures ) {
+            projection.BinarizedIndexes.push_back(OneHotFeatureIndexes.at(feature));
+        }
+        for (const auto& ctr : compressedModelCtr.ModelCtrs) {
+            auto& ctrPlan = projection.Ctrs.emplace_back();
+            ctrPlan.CtrIdx = ctrIdx++;
+            ctrPlan.ValueTable = &CtrData.LearnCtrs.at(ctr->Base);
+        }
+    }
+    return plan;
+}
+
+void TStaticCtrProvider::SetupCtrFeatures(const TVector<TCtrFeature>& ctrFeatures) {
+    EvaluationPlan = TEvaluationPlan();
+
+    TVector<TModelCtr> neededCtrs;
+    for (const auto& ctrFeature : ctrFeatures) {
+        neededCtrs.push_back(ctrFeature.Ctr);
+    }
+    if (neededCtrs.empty() || !HasNeededCtrs(neededCtrs)) {
+        // ctr tables can be added later, CalcCtrs will build a plan for each call then
+        return;
+    }
+    EvaluationPlan = BuildEvaluationPlan(neededCtrs);
+
+    // aligned copies pay off only for indexes that do not fit in cache, small ones are used as is
+    THashMap<const TCtrValueTable*, int> alignedIndexIdxs;
+    for (auto& projection : EvaluationPlan.Projections) {
+        for (auto& ctr : projection.Ctrs) {
+            if (ctr.ValueTable->GetIndexHashViewer().GetBucketCount() < MinBucketCountForAlignedIndex) {
+                continue;
+            }
+            auto [it, isNew] = alignedIndexIdxs.emplace(ctr.ValueTable, EvaluationPlan.AlignedIndexes.ysize());
+            if (isNew) {
+                EvaluationPlan.AlignedIndexes.emplace_back(ctr.ValueTable->GetIndexHashViewer());
+            }
+            ctr.AlignedIndexIdx = it->second;
+        }
+    }
+
+    // tables of bins are optional, build them only if they take less memory than used value tables
+    size_t binsSize = 0;
+    size_t valueTablesSize = 0;
+    THashSet<const TCtrValueTable*> valueTables;
+    for (auto& projection : EvaluationPlan.Projections) {
+        for (auto& ctr : projection.Ctrs) {
+            ctr.BinColumnCount = (ctrFeatures[ctr.CtrIdx].Borders.size() + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN;
+            const size_t valueCount = GetCtrValueCount(EvaluationPlan.ModelCtrs[ctr.CtrIdx], *ctr.ValueTable);
+            binsSize += (valueCount + 1) * ctr.BinColumnCount;
+            if (valueTables.insert(ctr.ValueTable).second) {
+                valueTablesSize += ctr.ValueTable->GetTypedArrayRefForBlobData<ui8>().size();
+            }
+        }
+    }
+    if (binsSize > valueTablesSize) {
+        return;
+    }
+
+    TVector<ui32> binColumnOffsets(ctrFeatures.size() + 1, 0);
+    for (auto& projection : EvaluationPlan.Projections) {
+        for (auto& ctr : projection.Ctrs) {
+            binColumnOffsets[ctr.CtrIdx + 1] = ctr.BinColumnCount;
+        }
+    }
+    for (auto ctrIdx : xrange(ctrFeatures.size())) {
+        binColumnOffsets[ctrIdx + 1] += binColumnOffsets[ctrIdx];
+    }
+
+    TVector<ui32> buckets;
+    TVector<float> values;
+    for (auto& projection : EvaluationPlan.Projections) {
+        for (auto& ctr : projection.Ctrs) {
+            ctr.BinColumnOffset = binColumnOffsets[ctr.CtrIdx];
+            if (ctr.BinColumnCount == 0) {
+                continue;
+            }
+            const size_t valueCount = GetCtrValueCount(EvaluationPlan.ModelCtrs[ctr.CtrIdx], *ctr.ValueTable);
+            buckets.yresize(valueCount + 1);
+            Iota(buckets.begin(), buckets.begin() + valueCount, 0);
+            buckets.back() = NCatboost::TDenseIndexHashView::NotFoundIndex;
+            values.yresize(buckets.size());
+            CalcCtrValues(EvaluationPlan.ModelCtrs[ctr.CtrIdx], *ctr.ValueTable, buckets, values.data());
+
+            const auto& borders = ctrFeatures[ctr.CtrIdx].Borders;
+            ctr.BucketBins.yresize(buckets.size() * ctr.BinColumnCount);
+            for (auto bucketIdx : xrange(buckets.size())) {
+                CalcBins(values[bucketIdx], borders, ctr.BucketBins.data() + bucketIdx * ctr.BinColumnCount);
+            }
+        }
+    }
+    for (const auto& ctrFeature : ctrFeatures) {
+        EvaluationPlan.CtrBorders.push_back(ctrFeature.Borders);
+    }
+    EvaluationPlan.HasBinarizedCtrs = true;
+}
+
 void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
                                   const TConstArrayRef<ui8>& binarizedFeatures,
                                   const TConstArrayRef<ui32>& hashedCatFeatures,
@@ -74,109 +301,79 @@ void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
     if (neededCtrs.empty()) {
         return;
     }
-    auto compressedModelCtrs = NCatboostModelExportHelpers::CompressModelCtrs(neededCtrs);
-    size_t samplesCount = docCount;
-    TVector<ui64> ctrHashes(samplesCount);
-    TVector<ui64> buckets(samplesCount);
-    size_t resultIdx = 0;
-    float* resultPtr = result.data();
-    TVector<int> transposedCatFeatureIndexes;
-    TVector<TBinFeatureIndexValue> binarizedIndexes;
-    for (size_t idx = 0; idx < compressedModelCtrs.size(); ++idx) {
-        auto& proj = *compressedModelCtrs[idx].Projection;
-        binarizedIndexes.clear();
-        transposedCatFeatureIndexes.clear();
-        for (const auto feature : proj.CatFeatures) {
-            transposedCatFeatureIndexes.push_back(CatFeatureIndex.at(feature));
-        }
-        for (const auto feature : proj.BinFeatures ) {
-            binarizedIndexes.push_back(FloatFeatureIndexes.at(feature));
+    TEvaluationPlan localPlan;
+    const TEvaluationPlan* plan = &EvaluationPlan;
+    if (EvaluationPlan.ModelCtrs != neededCtrs) {
+        localPlan = BuildEvaluationPlan(neededCtrs);
+        plan = &localPlan;
+    }
+    TVector<ui64> ctrHashes(docCount);
+    TVector<ui32> buckets(docCount);
+    for (const auto& projection : plan->Projections) {
+        CalcHashes(
+            binarizedFeatures,
+            hashedCatFeatures,
+            projection.TransposedCatFeatureIndexes,
+            projection.BinarizedIndexes,
+            docCount,
+            &ctrHashes);
+        for (const auto& ctr : projection.Ctrs) {
+            plan->GetBuckets(ctr, ctrHashes, buckets);
+            CalcCtrValues(plan->ModelCtrs[ctr.CtrIdx], *ctr.ValueTable, buckets, result.data() + ctr.CtrIdx * docCount);
         }
-        for (const auto feature : proj.OneHotFeatures ) {
-            binarizedIndexes.push_back(OneHotFeatureIndexes.at(feature));
+    }
+}
+
+bool TStaticCtrProvider::HasBinarizedCtrs(const TVector<TCtrFeature>& ctrFeatures) const {
+    if (!EvaluationPlan.HasBinarizedCtrs || ctrFeatures.size() != EvaluationPlan.ModelCtrs.size()) {
+        return false;
+    }
+    for (auto ctrIdx : xrange(ctrFeatures.size())) {
+        if (ctrFeatures[ctrIdx].Ctr != EvaluationPlan.ModelCtrs[ctrIdx]
+            || ctrFeatures[ctrIdx].Borders != EvaluationPlan.CtrBorders[ctrIdx])
+        {
+            return false;
         }
-        CalcHashes(binarizedFeatures, hashedCatFeatures, transposedCatFeatureIndexes, binarizedIndexes, docCount, &ctrHashes);
-        for (const auto& ctr: compressedModelCtrs[idx].ModelCtrs) {
-            auto& learnCtr = CtrData.LearnCtrs.at(ctr->Base);
-            auto hashIndexResolver = learnCtr.GetIndexHashViewer();
-            const ECtrType ctrType = ctr->Base.CtrType;
-            auto ptrBuckets = buckets.data();
-            for (size_t docId = 0; docId < samplesCount; ++docId) {
-                ptrBuckets[docId] = hashIndexResolver.GetIndex(ctrHashes[docId]);
+    }
+    return true;
+}
+
+void TStaticCtrProvider::CalcBinarizedCtrs(const TVector<TCtrFeature>& ctrFeatures,
+                                           const TConstArrayRef<ui8>& binarizedFeatures,
+                                           const TConstArrayRef<ui32>& hashedCatFeatures,
+                                           size_t docCount,
+                                           TArrayRef<ui8> result) {
+    Y_ASSERT(HasBinarizedCtrs(ctrFeatures));
+    Y_UNUSED(ctrFeatures);
+    TVector<ui64> ctrHashes(docCount);
+    TVector<ui32> buckets(docCount);
+    for (const auto& projection : EvaluationPlan.Projections) {
+        CalcHashes(
+            binarizedFeatures,
+            hashedCatFeatures,
+            projection.TransposedCatFeatureIndexes,
+            projection.BinarizedIndexes,
+            docCount,
+            &ctrHashes);
+        for (const auto& ctr : projection.Ctrs) {
+            const ui32 columnCount = ctr.BinColumnCount;
+            if (columnCount == 0) {
+                continue;
             }
-            if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
-                const auto emptyVal = ctr->Calc(0.f, 0.f);
-                auto ctrMean = learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>();
-                for (size_t doc = 0; doc < samplesCount; ++doc) {
-                    if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                        const TCtrMeanHistory& ctrMeanHistory = ctrMean[ptrBuckets[doc]];
-                        resultPtr[doc + resultIdx] = ctr->Calc(ctrMeanHistory.Sum, ctrMeanHistory.Count);
-                    } else {
-                        resultPtr[doc + resultIdx] = emptyVal;
-                    }
-                }
-            } else if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
-                TConstArrayRef<int> ctrTotal = learnCtr.GetTypedArrayRefForBlobData<int>();
-                const int denominator = learnCtr.CounterDenominator;
-                auto emptyVal = ctr->Calc(0, denominator);
-                for (size_t doc = 0; doc < samplesCount; ++doc) {
-                    if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                        resultPtr[doc + resultIdx] = ctr->Calc(ctrTotal[ptrBuckets[doc]], denominator);
-                    } else {
-                        resultPtr[doc + resultIdx] = emptyVal;
-                    }
+            const ui32 unknownValueBucket = ctr.BucketBins.size() / columnCount - 1;
+            EvaluationPlan.GetBuckets(ctr, ctrHashes, buckets);
+            const ui8* bucketBins = ctr.BucketBins.data();
+            ui8* resultPtr = result.data() + ctr.BinColumnOffset * docCount;
+            for (size_t docId = 0; docId < docCount; ++docId) {
+                ui32 bucket = buckets[docId];
+                if (bucket == NCatboost::TDenseIndexHashView::NotFoundIndex) {
+                    bucket = unknownValueBucket;
                 }
-            } else if (ctrType == ECtrType::Buckets) {
-                auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
-                const int targetClassesCount = learnCtr.TargetClassesCount;
-                auto emptyVal = ctr->Calc(0, 0);
-                for (size_t doc = 0; doc < samplesCount; ++doc) {
-                    if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                        int goodCount = 0;
-                        int totalCount = 0;
-                        auto ctrHistory = MakeArrayRef(ctrIntArray.data() + ptrBuckets[doc] * targetClassesCount, targetClassesCount);
-                        goodCount = ctrHistory[ctr->TargetBorderIdx];
-                        for (int classId = 0; classId < targetClassesCount; ++classId) {
-                            totalCount += ctrHistory[classId];
-                        }
-                        resultPtr[doc + resultIdx] = ctr->Calc(goodCount, totalCount);
-                    } else {
-                        resultPtr[doc + resultIdx] = emptyVal;
-                    }
-                }
-            } else {
-                auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
-                const int targetClassesCount = learnCtr.TargetClassesCount;
-
-                auto emptyVal = ctr->Calc(0, 0);
-                if (targetClassesCount > 2) {
-                    for (size_t doc = 0; doc < samplesCount; ++doc) {
-                        int goodCount = 0;
-                        int totalCount = 0;
-                        if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                            auto ctrHistory = MakeArrayRef(ctrIntArray.data() + ptrBuckets[doc] * targetClassesCount, targetClassesCount);
-                            for (int classId = 0; classId < ctr->TargetBorderIdx + 1; ++classId) {
-                                totalCount += ctrHistory[classId];
-                            }
-                            for (int classId = ctr->TargetBorderIdx + 1; classId < targetClassesCount; ++classId) {
-                                goodCount += ctrHistory[classId];
-                            }
-                            totalCount += goodCount;
-                        }
-                        resultPtr[doc + resultIdx] = ctr->Calc(goodCount, totalCount);
-                    }
-                } else {
-                    for (size_t doc = 0; doc < samplesCount; ++doc) {
-                        if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
-                            const int* ctrHistory = &ctrIntArray[ptrBuckets[doc] * 2];
-                            resultPtr[doc + resultIdx] = ctr->Calc(ctrHistory[1], ctrHistory[0] + ctrHistory[1]);
-                        } else {
-                            resultPtr[doc + resultIdx] = emptyVal;
-                        }
-                    }
+                const ui8* bins = bucketBins + bucket * columnCount;
+                for (ui32 column = 0; column < columnCount; ++column) {
+                    resultPtr[column * docCount + docId] = bins[column];
                 }
             }
-            resultIdx += docCount;
         }
     }
 }
@@ -34,16 +34,30 @@ public:
         const TVector<TFloatFeature>& floatFeatures,
         const TVector<TOneHotFeature>& oheFeatures,
         const TVector<TCatFeature>& catFeatures) override;
+
+    void SetupCtrFeatures(const TVector<TCtrFeature>& ctrFeatures) override;
+
+    bool HasBinarizedCtrs(const TVector<TCtrFeature>& ctrFeatures) const override;
+
+    void CalcBinarizedCtrs(
+        const TVector<TCtrFeature>& ctrFeatures,
+        const TConstArrayRef<ui8>& binarizedFeatures,
+        const TConstArrayRef<ui32>& hashedCatFeatures,
+        size_t docCount,
+        TArrayRef<ui8> result) override;
+
     bool IsSerializable() const override {
         return true;
     }
 
     void AddCtrCalcerData(TCtrValueTable&& valueTable) override {
+        EvaluationPlan = TEvaluationPlan();
         auto ctrBase = valueTable.ModelCtrBase;
         CtrData.LearnCtrs[ctrBase] = std::move(valueTable);
     }
 
     void DropUnusedTables(TConstArrayRef<TModelCtrBase> usedModelCtrBase) override {
+        EvaluationPlan = TEvaluationPlan();
         TCtrData ctrData;
         for (auto& base: usedModelCtrBase) {
             ctrData.LearnCtrs[base] = std::move(CtrData.LearnCtrs[base]);
@@ -56,6 +70,7 @@ public:
     }
 
     void Load(IInputStream* inp) override {
+        EvaluationPlan = TEvaluationPlan();
         ::Load(inp, CtrData);
     }
 
@@ -75,10 +90,58 @@ public:
 
 public:
     TCtrData CtrData;
+private:
+    /* Everything needed to evaluate a fixed list of ctrs that does not depend on data:
+     * ctrs grouped by projections, resolved feature indexes and value tables.
+     * Built once in SetupCtrFeatures, so CtrData must not be modified directly after that
+     * (model modifications end with TFullModel::UpdateDynamicData that rebuilds it).
+     */
+    struct TEvaluationPlan {
+        struct TCtr {
+            size_t CtrIdx = 0; // index in ModelCtrs and in results
+            const TCtrValueTable* ValueTable = nullptr; // points to CtrData
+            int AlignedIndexIdx = -1; // in AlignedIndexes, -1 if not built
+
+            // filled only if HasBinarizedCtrs
+            ui32 BinColumnOffset = 0;
+            ui32 BinColumnCount = 0;
+            TVector<ui8> BucketBins; // [bucketIdx * BinColumnCount + columnIdx], last bucket is for unknown values
+        };
+
+        struct TProjection {
+            TVector<int> TransposedCatFeatureIndexes;
+            TVector<TBinFeatureIndexValue> BinarizedIndexes;
+            TVector<TCtr> Ctrs;
+        };
+
+    public:
+        void GetBuckets(const TCtr& ctr, TConstArrayRef<ui64> hashes, TArrayRef<ui32> buckets) const {
+            if (ctr.AlignedIndexIdx >= 0) {
+                AlignedIndexes[ctr.AlignedIndexIdx].GetIndices(hashes, buckets);
+            } else {
+                ctr.ValueTable->GetIndexHashViewer().GetIndices(hashes, buckets);
+            }
+        }
+
+    public:
+        TVector<TModelCtr> ModelCtrs;
+        TVector<TProjection> Projections;
+
+        // cache friendly copies of large value tables indexes, built only in SetupCtrFeatures
+        TVector<NCatboost::TAlignedDenseIndexHash> AlignedIndexes;
+
+        bool HasBinarizedCtrs = false;
+        TVector<TVector<float>> CtrBorders; // [ctrIdx], only if HasBinarizedCtrs
+    };
+
+private:
+    TEvaluationPlan BuildEvaluationPlan(const TVector<TModelCtr>& neededCtrs) const;
+
 private:
     THashMap<TFloatSplit, TBinFeatureIndexValue> FloatFeatureIndexes;
     THashMap<int, int> CatFeatureIndex;
     THashMap<TOneHotSplit, TBinFeatureIndexValue> OneHotFeatureIndexes;
+    TEvaluationPlan EvaluationPlan;
 };
 
 class TStaticCtrOnFlightSerializationProvider: public ICtrProvider {
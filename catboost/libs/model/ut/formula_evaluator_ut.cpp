@@ -1,5 +1,6 @@
 #include "model_test_helpers.h"
 
+#include <catboost/libs/cat_feature/cat_feature.h>
 #include <catboost/libs/data_new/data_provider_builders.h>
 #include <catboost/libs/model/formula_evaluator.h>
 #include <catboost/libs/model/model.h>
@@ -7,6 +8,8 @@
 
 #include <library/unittest/registar.h>
 
+#include <util/generic/xrange.h>
+
 
 using namespace NCB;
 
@@ -84,6 +87,51 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         };
         UNIT_ASSERT_NO_EXCEPTION(applyBatch());
     }
+
+    Y_UNIT_TEST(TestStringCatFeaturesAreSameAsHashes) {
+        const auto model = TrainCatOnlyModel();
+
+        const TVector<TStringBuf> f[] = {{"a", "b", "c"}, {"d", "e", "f"}, {"g", "h", "k"}, {"a", "e", "z"}, {"x", "y", "z"}};
+        TVector<TVector<int>> hashes;
+        for (const auto& docFeatures : f) {
+            TVector<ui32> docHashes(docFeatures.size());
+            CalcCatFeatureHashes(docFeatures, docHashes);
+            hashes.emplace_back();
+            for (auto idx : xrange(docFeatures.size())) {
+                UNIT_ASSERT_VALUES_EQUAL(docHashes[idx], CalcCatFeatureHash(docFeatures[idx]));
+                hashes.back().push_back(CalcCatFeatureHashInt(docFeatures[idx]));
+            }
+        }
+        const TVector<TConstArrayRef<int>> hashRefs(hashes.begin(), hashes.end());
+
+        double results[5];
+        double hashResults[5];
+        model.Calc({}, f, results);
+        model.Calc({}, hashRefs, hashResults);
+        for (auto i : xrange(5)) {
+            UNIT_ASSERT_VALUES_EQUAL(results[i], hashResults[i]);
+        }
+    }
+
+    Y_UNIT_TEST(TestBinarizedCtrsAreSameAsFloatCtrs) {
+        const auto model = TrainCatOnlyModel();
+        UNIT_ASSERT(!model.ObliviousTrees.CtrFeatures.empty());
+        UNIT_ASSERT(model.CtrProvider->HasBinarizedCtrs(model.ObliviousTrees.CtrFeatures));
+
+        // provider without evaluation plan calculates float ctrs and binarizes them
+        auto floatCtrsModel = model.CopyTreeRange(0, model.GetTreeCount());
+        floatCtrsModel.CtrProvider->DropUnusedTables(floatCtrsModel.ObliviousTrees.GetUsedModelCtrBases());
+        UNIT_ASSERT(!floatCtrsModel.CtrProvider->HasBinarizedCtrs(floatCtrsModel.ObliviousTrees.CtrFeatures));
+
+        const TVector<TStringBuf> f[] = {{"a", "b", "c"}, {"d", "e", "f"}, {"g", "h", "k"}, {"a", "e", "z"}, {"x", "y", "z"}};
+        double results[5];
+        double floatCtrsResults[5];
+        model.Calc({}, f, results);
+        floatCtrsModel.Calc({}, f, floatCtrsResults);
+        for (auto i : xrange(5)) {
+            UNIT_ASSERT_VALUES_EQUAL(results[i], floatCtrsResults[i]);
+        }
+    }
 }
 
 Y_UNIT_TEST_SUITE(TNonSymmetricTreeModel) {
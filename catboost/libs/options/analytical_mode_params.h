@@ -26,6 +26,7 @@ namespace NCB {
         TVector<EPredictionType> PredictionTypes = {EPredictionType::RawFormulaVal};
         TVector<TString> OutputColumnsIds = {"DocId", "RawFormulaVal"};
         EFstrType FstrType = EFstrType::FeatureImportance;
+        ui64 ShapUsedRamLimit = 0; // 0 - unlimited
         TVector<TString> ClassNames;
         int ThreadCount = NSystemInfo::CachedNumberOfCpus();
 
@@ -13,6 +13,7 @@ NCatboostOptions::TDataProcessingOptions::TDataProcessingOptions(ETaskType type)
           type
       ))
       , PerFloatFeatureBinarization("per_float_feature_binarization", TMap<ui32, TBinarizationOptions>())
+      , UseQuantileSketchesForBorders("use_quantile_sketches_for_borders", false)
       , ClassesCount("classes_count", 0)
       , ClassWeights("class_weights", TVector<float>())
       , ClassNames("class_names", TVector<TString>())
@@ -22,20 +23,21 @@ NCatboostOptions::TDataProcessingOptions::TDataProcessingOptions(ETaskType type)
 }
 
 void NCatboostOptions::TDataProcessingOptions::Load(const NJson::TJsonValue& options) {
-    CheckedLoad(options, &IgnoredFeatures, &HasTimeFlag, &AllowConstLabel, &FloatFeaturesBinarization, &PerFloatFeatureBinarization, &ClassesCount, &ClassWeights, &ClassNames, &GpuCatFeaturesStorage);
+    CheckedLoad(options, &IgnoredFeatures, &HasTimeFlag, &AllowConstLabel, &FloatFeaturesBinarization, &PerFloatFeatureBinarization, &UseQuantileSketchesForBorders, &ClassesCount, &ClassWeights, &ClassNames, &GpuCatFeaturesStorage);
     SetPerFeatureMissingSettingToCommonValues();
 
 }
 
 void NCatboostOptions::TDataProcessingOptions::Save(NJson::TJsonValue* options) const {
-    SaveFields(options, IgnoredFeatures, HasTimeFlag, AllowConstLabel, FloatFeaturesBinarization, ClassesCount, ClassWeights, ClassNames, GpuCatFeaturesStorage);
+    SaveFields(options, IgnoredFeatures, HasTimeFlag, AllowConstLabel, FloatFeaturesBinarization, UseQuantileSketchesForBorders, ClassesCount, ClassWeights, ClassNames, GpuCatFeaturesStorage);
 }
 
 bool NCatboostOptions::TDataProcessingOptions::operator==(const TDataProcessingOptions& rhs) const {
-    return std::tie(IgnoredFeatures, HasTimeFlag, AllowConstLabel, FloatFeaturesBinarization, ClassesCount, ClassWeights,
-            ClassNames, GpuCatFeaturesStorage) ==
-        std::tie(rhs.IgnoredFeatures, rhs.HasTimeFlag, rhs.AllowConstLabel, rhs.FloatFeaturesBinarization, rhs.ClassesCount,
-                rhs.ClassWeights, rhs.ClassNames, rhs.GpuCatFeaturesStorage);
+    return std::tie(IgnoredFeatures, HasTimeFlag, AllowConstLabel, FloatFeaturesBinarization,
+            UseQuantileSketchesForBorders, ClassesCount, ClassWeights, ClassNames, GpuCatFeaturesStorage) ==
+        std::tie(rhs.IgnoredFeatures, rhs.HasTimeFlag, rhs.AllowConstLabel, rhs.FloatFeaturesBinarization,
+                rhs.UseQuantileSketchesForBorders, rhs.ClassesCount, rhs.ClassWeights, rhs.ClassNames,
+                rhs.GpuCatFeaturesStorage);
 }
 
 bool NCatboostOptions::TDataProcessingOptions::operator!=(const TDataProcessingOptions& rhs) const {
@@ -31,6 +31,7 @@ namespace NCatboostOptions {
         TOption<bool> AllowConstLabel;
         TOption<TBinarizationOptions> FloatFeaturesBinarization;
         TOption<TMap<ui32, TBinarizationOptions>> PerFloatFeatureBinarization;
+        TOption<bool> UseQuantileSketchesForBorders;
         TOption<ui32> ClassesCount;
         TOption<TVector<float>> ClassWeights;
         TOption<TVector<TString>> ClassNames;
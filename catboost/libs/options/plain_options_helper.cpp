@@ -337,6 +337,7 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "ignored_features", &dataProcessingOptions, &seenKeys);
     CopyOption(plainOptions, "has_time", &dataProcessingOptions, &seenKeys);
     CopyOption(plainOptions, "allow_const_label", &dataProcessingOptions, &seenKeys);
+    CopyOption(plainOptions, "use_quantile_sketches_for_borders", &dataProcessingOptions, &seenKeys);
     CopyOption(plainOptions, "classes_count", &dataProcessingOptions, &seenKeys);
     CopyOption(plainOptions, "class_names", &dataProcessingOptions, &seenKeys);
     CopyOption(plainOptions, "class_weights", &dataProcessingOptions, &seenKeys);
@@ -364,6 +365,9 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "node_type", &systemOptions, &seenKeys);
     CopyOption(plainOptions, "node_port", &systemOptions, &seenKeys);
     CopyOption(plainOptions, "file_with_hosts", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "workers_load_learn_data", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "exchange_stats_in_float", &systemOptions, &seenKeys);
+    CopyOption(plainOptions, "worker_response_timeout", &systemOptions, &seenKeys);
 
 
     //rest
@@ -29,6 +29,19 @@ namespace NCatboostOptions {
         TCpuOnlyOption<ENodeType> NodeType;
         TCpuOnlyOption<TString> FileWithHosts;
         TCpuOnlyOption<ui32> NodePort;
+        /* workers load their parts of learn dataset themselves instead of receiving them from master.
+         * Master converts learn dataset to a quantized pool reading it block by block and keeps only
+         * quantized feature columns, target and weights (they are used for final ctr tables and
+         * snapshot checksum), raw feature values are never held in its memory as a whole.
+         * Datasets that quantized pools do not support (with categorical features, for example)
+         * are loaded by master as usual.
+         */
+        TCpuOnlyOption<bool> WorkersLoadLearnData;
+        // bucket stats are sent between hosts as float, halves traffic but loses precision of sums
+        TCpuOnlyOption<bool> ExchangeStatsInFloat;
+        // master fails if workers don't return results of a single step in this number of seconds, 0 is unlimited;
+        // training can be resumed from snapshot with the same or replaced worker hosts
+        TCpuOnlyOption<ui32> WorkerResponseTimeout;
 
         static ui32 GetUnusedNodePort() { return 0; }
         bool IsMaster() const;
@@ -0,0 +1,138 @@
+#include "quantile_sketch.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+
+#include <utility>
+
+
+namespace NCB {
+
+    TQuantileSketch::TQuantileSketch(ui32 levelCapacity)
+        : LevelCapacity(levelCapacity)
+        , Levels(1)
+        , PromoteOddPositions(1, false)
+    {
+        CB_ENSURE_INTERNAL(LevelCapacity >= 2, "TQuantileSketch: level capacity must be >= 2");
+        Levels[0].reserve(LevelCapacity);
+    }
+
+    void TQuantileSketch::Add(float value) {
+        if (IsNan(value)) {
+            ++NanCount;
+            return;
+        }
+        ++Count;
+        Levels[0].push_back(value);
+        if (Levels[0].size() >= LevelCapacity) {
+            CompactLevel(0);
+        }
+    }
+
+    void TQuantileSketch::Add(TConstArrayRef<float> values) {
+        for (float value : values) {
+            Add(value);
+        }
+    }
+
+    void TQuantileSketch::Merge(const TQuantileSketch& rhs) {
+        CB_ENSURE_INTERNAL(
+            LevelCapacity == rhs.LevelCapacity,
+            "TQuantileSketch::Merge: level capacities differ"
+        );
+
+        Count += rhs.Count;
+        NanCount += rhs.NanCount;
+
+        for (auto level : xrange(rhs.Levels.size())) {
+            if (level == Levels.size()) {
+                Levels.emplace_back();
+                PromoteOddPositions.push_back(false);
+            }
+            Levels[level].insert(Levels[level].end(), rhs.Levels[level].begin(), rhs.Levels[level].end());
+        }
+
+        // compaction of a level can only add values to higher levels, so one pass is enough
+        for (size_t level = 0; level < Levels.size(); ++level) {
+            if (Levels[level].size() >= LevelCapacity) {
+                CompactLevel(level);
+            }
+        }
+    }
+
+    size_t TQuantileSketch::GetStoredCount() const {
+        size_t result = 0;
+        for (const auto& levelValues : Levels) {
+            result += levelValues.size();
+        }
+        return result;
+    }
+
+    TVector<float> TQuantileSketch::GetSortedSample(ui32 size) const {
+        TVector<std::pair<float, ui64>> weightedValues;
+        weightedValues.reserve(GetStoredCount());
+        for (auto level : xrange(Levels.size())) {
+            const ui64 weight = ui64(1) << level;
+            for (float value : Levels[level]) {
+                weightedValues.emplace_back(value, weight);
+            }
+        }
+        Sort(weightedValues.begin(), weightedValues.end());
+
+        const ui32 sampleSize = (ui32)Min<ui64>(size, Count);
+
+        TVector<float> result;
+        result.reserve(sampleSize);
+
+        auto it = weightedValues.begin();
+        ui64 cumulativeWeight = 0;
+        for (auto i : xrange(sampleSize)) {
+            const double rank = (i + 0.5) * double(Count) / sampleSize;
+            while ((double)(cumulativeWeight + it->second) <= rank) {
+                cumulativeWeight += it->second;
+                ++it;
+                Y_ASSERT(it != weightedValues.end());
+            }
+            result.push_back(it->first);
+        }
+
+        return result;
+    }
+
+    ui64 TQuantileSketch::EstimateMemoryUsage(ui64 objectCount, ui32 levelCapacity) {
+        const ui64 levelCount = 1 + (ui64)Log2(Max<double>(double(objectCount) / levelCapacity, 1.0)) + 1;
+
+        // level buffers can temporarily hold up to 2 * levelCapacity values after Merge
+        return levelCount * 2 * levelCapacity * sizeof(float);
+    }
+
+    void TQuantileSketch::CompactLevel(size_t level) {
+        if (level + 1 == Levels.size()) {
+            Levels.emplace_back();
+            Levels.back().reserve(LevelCapacity);
+            PromoteOddPositions.push_back(false);
+        }
+
+        auto& values = Levels[level];
+        Sort(values.begin(), values.end());
+
+        // for odd size the largest value stays at this level
+        const size_t compactedSize = values.size() - values.size() % 2;
+        auto& nextLevelValues = Levels[level + 1];
+        for (size_t i = PromoteOddPositions[level] ? 1 : 0; i < compactedSize; i += 2) {
+            nextLevelValues.push_back(values[i]);
+        }
+        PromoteOddPositions[level] = !PromoteOddPositions[level];
+
+        values.erase(values.begin(), values.begin() + compactedSize);
+
+        if (nextLevelValues.size() >= LevelCapacity) {
+            CompactLevel(level + 1);
+        }
+    }
+
+}
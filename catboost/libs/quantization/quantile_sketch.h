@@ -0,0 +1,72 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /*
+     * Mergeable streaming quantile sketch (compactor hierarchy as in KLL / MRL sketches).
+     *
+     * Level h keeps values with weight 2^h. When a level reaches capacity it is sorted and every
+     * other value is promoted to the next level (the choice of odd/even positions alternates
+     * between compactions, so the result is deterministic and rank error does not accumulate in
+     * one direction).
+     * Total weight is preserved exactly, rank error is O(log(n / capacity) / capacity) * n.
+     *
+     * Sketches built for disjoint parts of data can be merged, so they can be built in parallel.
+     * NaNs are not added to the sketch, only counted.
+     */
+    class TQuantileSketch {
+    public:
+        static constexpr ui32 DEFAULT_LEVEL_CAPACITY = 4096;
+
+    public:
+        explicit TQuantileSketch(ui32 levelCapacity = DEFAULT_LEVEL_CAPACITY);
+
+        void Add(float value);
+        void Add(TConstArrayRef<float> values);
+
+        // rhs must have the same level capacity
+        void Merge(const TQuantileSketch& rhs);
+
+        // does not include NaNs
+        ui64 GetCount() const {
+            return Count;
+        }
+
+        ui64 GetNanCount() const {
+            return NanCount;
+        }
+
+        ui32 GetLevelCapacity() const {
+            return LevelCapacity;
+        }
+
+        // number of values currently stored
+        size_t GetStoredCount() const;
+
+        /*
+         * returns min(size, GetCount()) values with approximately evenly spaced ranks
+         * (i-th value has rank ~ (i + 0.5) * GetCount() / size), sorted in nondecreasing order
+         */
+        TVector<float> GetSortedSample(ui32 size) const;
+
+        // upper bound of memory used by a sketch for objectCount values (without NaNs)
+        static ui64 EstimateMemoryUsage(ui64 objectCount, ui32 levelCapacity = DEFAULT_LEVEL_CAPACITY);
+
+    private:
+        void CompactLevel(size_t level);
+
+    private:
+        ui32 LevelCapacity;
+        ui64 Count = 0;
+        ui64 NanCount = 0;
+
+        TVector<TVector<float>> Levels; // [level] values of weight 2^level
+        TVector<bool> PromoteOddPositions; // [level]
+    };
+
+}
@@ -0,0 +1,58 @@
+#include <library/unittest/registar.h>
+
+#include <catboost/libs/quantization/quantile_sketch.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+#include <cmath>
+#include <limits>
+
+Y_UNIT_TEST_SUITE(TQuantileSketchTests) {
+    Y_UNIT_TEST(TestExactForSmallData) {
+        NCB::TQuantileSketch sketch;
+        const TVector<float> values = {3.f, 1.f, std::numeric_limits<float>::quiet_NaN(), 2.f, 5.f, 4.f};
+        sketch.Add(values);
+
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), 5);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetNanCount(), 1);
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetSortedSample(10), (TVector<float>{1.f, 2.f, 3.f, 4.f, 5.f}));
+    }
+
+    Y_UNIT_TEST(TestMergedRankError) {
+        const ui32 objectCount = 1000000;
+        const ui32 partCount = 7;
+        const ui32 sampleSize = 1000;
+
+        TFastRng64 rng(0);
+        TVector<float> values;
+        values.yresize(objectCount);
+        for (auto& value : values) {
+            value = (float)std::exp(4.0 * rng.GenRandReal1());
+        }
+
+        TVector<NCB::TQuantileSketch> sketches(partCount, NCB::TQuantileSketch(256));
+        for (auto i : xrange(objectCount)) {
+            sketches[i % partCount].Add(values[i]);
+        }
+        for (auto i : xrange<ui32>(1, partCount)) {
+            sketches[0].Merge(sketches[i]);
+        }
+
+        UNIT_ASSERT_VALUES_EQUAL(sketches[0].GetCount(), objectCount);
+        UNIT_ASSERT(sketches[0].GetStoredCount() < objectCount / 20);
+
+        const TVector<float> sample = sketches[0].GetSortedSample(sampleSize);
+        UNIT_ASSERT_VALUES_EQUAL(sample.size(), sampleSize);
+        UNIT_ASSERT(IsSorted(sample.begin(), sample.end()));
+
+        Sort(values.begin(), values.end());
+        for (auto i : xrange(sampleSize)) {
+            const double rank = LowerBound(values.begin(), values.end(), sample[i]) - values.begin();
+            const double expectedRank = (i + 0.5) * objectCount / sampleSize;
+            UNIT_ASSERT_DOUBLES_EQUAL(rank / objectCount, expectedRank / objectCount, 0.02);
+        }
+    }
+}
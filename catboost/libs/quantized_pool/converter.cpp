@@ -0,0 +1,520 @@
+#include "converter.h"
+#include "serialization.h"
+
+#include <catboost/idl/pool/proto/quantization_schema.pb.h>
+#include <catboost/libs/column_description/cd_parser.h>
+#include <catboost/libs/column_description/column.h>
+#include <catboost/libs/data_new/borders_io.h>
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/data_new/loader.h>
+#include <catboost/libs/data_new/quantization.h>
+#include <catboost/libs/data_new/quantized_features_info.h>
+#include <catboost/libs/data_types/groupid.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+#include <catboost/libs/quantization/utils.h>
+#include <catboost/libs/quantization_schema/schema.h>
+#include <catboost/libs/quantization_schema/serialization.h>
+
+#include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/cast.h>
+#include <util/generic/hash.h>
+#include <util/generic/map.h>
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
+#include <util/generic/ymath.h>
+#include <util/string/cast.h>
+#include <util/system/unaligned_mem.h>
+
+#include <climits>
+
+using NCB::TFloatFeatureIdx;
+using NCB::TPoolConversionParams;
+using NCB::TQuantizedFeaturesInfo;
+using NCB::TQuantizedFeaturesInfoPtr;
+using NCB::TQuantizedPoolWriter;
+using NCB::TRawDataProvider;
+using NCB::TRawDataProviderPtr;
+using NCB::TRawObjectsDataProvider;
+
+namespace {
+    struct TColumnToWrite {
+        EColumn Type = EColumn::Num;
+        ui32 ColumnIndex = 0;
+
+        // float feature index for `EColumn::Num`, baseline index for `EColumn::Baseline`
+        ui32 TypedIndex = 0;
+    };
+
+    // all values of a float feature seen by the first pass
+    struct TFloatFeatureSummary {
+        TFloatFeatureIdx FloatFeatureIdx;
+        NCB::TFloatFeatureValuesSummary Values;
+    };
+
+    // per-column buffers are reused between blocks
+    struct TChunkBuffer {
+        TVector<ui8> Quants;
+        flatbuffers::FlatBufferBuilder Builder;
+    };
+
+    class TQuantizedPoolConverter {
+    public:
+        TQuantizedPoolConverter(
+            const TPoolConversionParams& params,
+            IOutputStream* output,
+            NPar::TLocalExecutor* localExecutor);
+
+        // first pass, returns false if borders of all features are known and pass can be stopped
+        bool AddBlockForBorders(TRawDataProviderPtr block);
+        void FinishBorders();
+
+        // second pass
+        void AddBlock(TRawDataProviderPtr block);
+        void Finish();
+
+    private:
+        void InitQuantizedFeaturesInfo(const NCB::TDataMetaInfo& metaInfo);
+        void Start(TRawDataProviderPtr firstBlock);
+
+        void QuantizeColumn(
+            const TRawDataProvider& block,
+            const TColumnToWrite& column,
+            TVector<ui8>* quants,
+            ui8* bitsPerDocument) const;
+
+    private:
+        const TPoolConversionParams& Params;
+        NPar::TLocalExecutor* LocalExecutor;
+        TQuantizedPoolWriter Writer;
+
+        bool Started = false;
+        ui32 DocumentCount = 0;
+
+        TQuantizedFeaturesInfoPtr QuantizedFeaturesInfo;
+        TVector<TFloatFeatureSummary> FloatFeatureSummaries; // only features without borders from file
+        NCB::NIdl::TPoolQuantizationSchema QuantizationSchema;
+
+        THashMap<size_t, size_t> ColumnIndexToLocalIndex;
+        TVector<EColumn> ColumnTypes;
+        TVector<TString> ColumnNames;
+        TVector<size_t> IgnoredColumnIndices;
+
+        TVector<TColumnToWrite> ColumnsToWrite;
+        TVector<THolder<TChunkBuffer>> ChunkBuffers; // [columnToWriteIdx]
+    };
+}
+
+TQuantizedPoolConverter::TQuantizedPoolConverter(
+    const TPoolConversionParams& params,
+    IOutputStream* const output,
+    NPar::TLocalExecutor* const localExecutor)
+    : Params(params)
+    , LocalExecutor(localExecutor)
+    , Writer(output) {
+}
+
+void TQuantizedPoolConverter::InitQuantizedFeaturesInfo(const NCB::TDataMetaInfo& metaInfo) {
+    CB_ENSURE(
+        metaInfo.ColumnsInfo.Defined(),
+        "Only pools with column description can be converted to quantized pool");
+
+    QuantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+        *metaInfo.FeaturesLayout,
+        Params.IgnoredFeatures,
+        Params.FloatFeaturesBinarization,
+        TMap<ui32, NCatboostOptions::TBinarizationOptions>(),
+        /*floatFeaturesAllowNansInTestOnly*/ true,
+        /*allowWriteFiles*/ false);
+
+    if (Params.InputBordersPath) {
+        NCB::LoadBordersAndNanModesFromFromFileInMatrixnetFormat(
+            Params.InputBordersPath,
+            QuantizedFeaturesInfo.Get());
+    }
+
+    QuantizedFeaturesInfo->GetFeaturesLayout()->IterateOverAvailableFeatures<EFeatureType::Float>(
+        [&] (TFloatFeatureIdx floatFeatureIdx) {
+            if (!QuantizedFeaturesInfo->HasBorders(floatFeatureIdx)) {
+                FloatFeatureSummaries.emplace_back();
+                FloatFeatureSummaries.back().FloatFeatureIdx = floatFeatureIdx;
+            }
+        });
+}
+
+bool TQuantizedPoolConverter::AddBlockForBorders(TRawDataProviderPtr block) {
+    if (!QuantizedFeaturesInfo) {
+        InitQuantizedFeaturesInfo(block->MetaInfo);
+    }
+    if (FloatFeatureSummaries.empty()) {
+        return false;
+    }
+
+    LocalExecutor->ExecRangeWithThrow(
+        [&] (int summaryIdx) {
+            auto& summary = FloatFeatureSummaries[summaryIdx];
+            const auto featureData
+                = (**block->ObjectsData->GetFloatFeature(*summary.FloatFeatureIdx)).GetArrayData();
+            featureData.ForEach([&] (ui32 /*idx*/, float value) {
+                summary.Values.Add(value);
+            });
+        },
+        0,
+        SafeIntegerCast<int>(FloatFeatureSummaries.size()),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+    return true;
+}
+
+void TQuantizedPoolConverter::FinishBorders() {
+    CB_ENSURE(QuantizedFeaturesInfo, "Pool is empty");
+
+    const ui32 maxSampleSize = NCB::TQuantizationOptions().MaxSubsetSizeForSlowBuildBordersAlgorithms;
+    auto& featuresLayout = *QuantizedFeaturesInfo->GetFeaturesLayout();
+
+    TVector<ENanMode> nanModes(FloatFeatureSummaries.size());
+    TVector<TVector<float>> borders(FloatFeatureSummaries.size());
+    LocalExecutor->ExecRangeWithThrow(
+        [&] (int summaryIdx) {
+            const auto& summary = FloatFeatureSummaries[summaryIdx];
+            const ui32 flatFeatureIdx = featuresLayout.GetExternalFeatureIdx(
+                *summary.FloatFeatureIdx,
+                EFeatureType::Float);
+
+            NCB::CalcBordersAndNanModeFromSummary(
+                flatFeatureIdx,
+                QuantizedFeaturesInfo->GetFloatFeatureBinarization(flatFeatureIdx),
+                summary.Values,
+                maxSampleSize,
+                &nanModes[summaryIdx],
+                &borders[summaryIdx]);
+        },
+        0,
+        SafeIntegerCast<int>(FloatFeatureSummaries.size()),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    for (auto summaryIdx : xrange(FloatFeatureSummaries.size())) {
+        const auto floatFeatureIdx = FloatFeatureSummaries[summaryIdx].FloatFeatureIdx;
+        if (borders[summaryIdx].empty()) {
+            // constant over the whole pool
+            featuresLayout.IgnoreExternalFeature(
+                featuresLayout.GetExternalFeatureIdx(*floatFeatureIdx, EFeatureType::Float));
+        }
+        QuantizedFeaturesInfo->SetNanMode(floatFeatureIdx, nanModes[summaryIdx]);
+        QuantizedFeaturesInfo->SetBorders(floatFeatureIdx, std::move(borders[summaryIdx]));
+    }
+    FloatFeatureSummaries.clear();
+}
+
+void TQuantizedPoolConverter::Start(TRawDataProviderPtr firstBlock) {
+    CB_ENSURE_INTERNAL(QuantizedFeaturesInfo, "Borders must be calculated before conversion");
+    const auto& metaInfo = firstBlock->MetaInfo;
+
+    const auto& featuresLayout = *QuantizedFeaturesInfo->GetFeaturesLayout();
+    const auto featuresMetaInfo = featuresLayout.GetExternalFeaturesMetaInfo();
+
+    NCB::TPoolQuantizationSchema schema;
+    schema.ClassNames = Params.ClassNames;
+
+    ui32 flatFeatureIdx = 0;
+    ui32 baselineIdx = 0;
+    const auto& columns = metaInfo.ColumnsInfo->Columns;
+    for (const ui32 columnIdx : xrange(columns.size())) {
+        const auto& column = columns[columnIdx];
+        switch (column.Type) {
+            case EColumn::Num: {
+                const auto& featureMetaInfo = featuresMetaInfo[flatFeatureIdx];
+                if (featureMetaInfo.IsIgnored || !featureMetaInfo.IsAvailable) {
+                    // also includes constant features, they are ignored by border calculation
+                    IgnoredColumnIndices.push_back(columnIdx);
+                } else {
+                    const auto floatFeatureIdx
+                        = featuresLayout.GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx);
+                    schema.FeatureIndices.push_back(flatFeatureIdx);
+                    schema.Borders.push_back(QuantizedFeaturesInfo->GetBorders(floatFeatureIdx));
+                    schema.NanModes.push_back(QuantizedFeaturesInfo->GetNanMode(floatFeatureIdx));
+                    ColumnsToWrite.push_back({column.Type, columnIdx, *floatFeatureIdx});
+                }
+                ++flatFeatureIdx;
+                break;
+            }
+            case EColumn::Categ: {
+                CB_ENSURE(
+                    featuresMetaInfo[flatFeatureIdx].IsIgnored,
+                    "Categorical features are not supported in quantized pools yet, feature #"
+                    << flatFeatureIdx << " (column " << columnIdx << ") must be ignored");
+                IgnoredColumnIndices.push_back(columnIdx);
+                ++flatFeatureIdx;
+                break;
+            }
+            case EColumn::Baseline:
+                ColumnsToWrite.push_back({column.Type, columnIdx, baselineIdx});
+                ++baselineIdx;
+                break;
+            case EColumn::Label:
+            case EColumn::Weight:
+            case EColumn::GroupWeight:
+            case EColumn::GroupId:
+            case EColumn::SubgroupId:
+                ColumnsToWrite.push_back({column.Type, columnIdx, 0});
+                break;
+            case EColumn::SampleId:
+                // string ids are not stored in quantized pool, column is only mentioned in metainfo
+                break;
+            case EColumn::Auxiliary:
+            case EColumn::Timestamp:
+            case EColumn::Sparse:
+            case EColumn::Prediction:
+                ythrow TCatBoostException()
+                    << "Column " << columnIdx << " has type " << column.Type
+                    << " that is not supported in quantized pools";
+        }
+
+        ColumnIndexToLocalIndex.emplace(columnIdx, ColumnTypes.size());
+        ColumnTypes.push_back(column.Type);
+        ColumnNames.push_back(column.Id);
+    }
+
+    CB_ENSURE(!schema.FeatureIndices.empty(), "All features are either constant or ignored.");
+    QuantizationSchema = NCB::QuantizationSchemaToProto(schema);
+
+    ChunkBuffers.reserve(ColumnsToWrite.size());
+    for (size_t i = 0; i < ColumnsToWrite.size(); ++i) {
+        ChunkBuffers.push_back(MakeHolder<TChunkBuffer>());
+    }
+
+    Started = true;
+}
+
+template <typename T, typename TGetValue>
+static void StoreValues(const ui32 objectCount, const TGetValue& getValue, TVector<ui8>* const quants) {
+    quants->yresize(objectCount * sizeof(T));
+    auto* const dst = quants->data();
+    for (ui32 i = 0; i < objectCount; ++i) {
+        WriteUnaligned<T>(dst + i * sizeof(T), static_cast<T>(getValue(i)));
+    }
+}
+
+void TQuantizedPoolConverter::QuantizeColumn(
+    const TRawDataProvider& block,
+    const TColumnToWrite& column,
+    TVector<ui8>* const quants,
+    ui8* const bitsPerDocument) const {
+
+    const ui32 objectCount = block.GetObjectCount();
+    switch (column.Type) {
+        case EColumn::Num: {
+            const TFloatFeatureIdx floatFeatureIdx(column.TypedIndex);
+            const TConstArrayRef<float> borders = QuantizedFeaturesInfo->GetBorders(floatFeatureIdx);
+            const ENanMode nanMode = QuantizedFeaturesInfo->GetNanMode(floatFeatureIdx);
+            const auto featureData = (**block.ObjectsData->GetFloatFeature(column.TypedIndex)).GetArrayData();
+            if (nanMode == ENanMode::Forbidden) {
+                // possible only for borders loaded from file, calculated borders take all objects into account
+                featureData.ForEach([&] (ui32 /*idx*/, float value) {
+                    CB_ENSURE(
+                        !IsNan(value),
+                        "Feature #" << block.MetaInfo.FeaturesLayout->GetExternalFeatureIdx(
+                            column.TypedIndex,
+                            EFeatureType::Float)
+                        << ": There are nan values, but nan mode in borders file is Forbidden");
+                });
+            }
+
+            *bitsPerDocument = NCB::CalHistogramWidthForBorders(borders.size());
+            if (*bitsPerDocument == 8) {
+                quants->yresize(objectCount);
+                featureData.ForEach([&] (ui32 idx, float value) {
+                    (*quants)[idx] = NCB::Binarize<ui8>(nanMode, borders, value);
+                });
+            } else {
+                quants->yresize(objectCount * sizeof(ui16));
+                featureData.ForEach([&] (ui32 idx, float value) {
+                    WriteUnaligned<ui16>(
+                        quants->data() + idx * sizeof(ui16),
+                        NCB::Binarize<ui16>(nanMode, borders, value));
+                });
+            }
+            return;
+        }
+        case EColumn::Label: {
+            const auto target = *block.RawTargetData.GetTarget();
+            *bitsPerDocument = sizeof(float) * CHAR_BIT;
+            StoreValues<float>(
+                objectCount,
+                [&] (ui32 i) {
+                    float value;
+                    CB_ENSURE(
+                        TryFromString<float>(target[i], value),
+                        "Only numeric labels are supported in quantized pools, got " << target[i]);
+                    return value;
+                },
+                quants);
+            return;
+        }
+        case EColumn::Weight: {
+            const auto& weights = block.RawTargetData.GetWeights();
+            *bitsPerDocument = sizeof(float) * CHAR_BIT;
+            StoreValues<float>(objectCount, [&] (ui32 i) { return weights[i]; }, quants);
+            return;
+        }
+        case EColumn::GroupWeight: {
+            const auto& groupWeights = block.RawTargetData.GetGroupWeights();
+            *bitsPerDocument = sizeof(float) * CHAR_BIT;
+            StoreValues<float>(objectCount, [&] (ui32 i) { return groupWeights[i]; }, quants);
+            return;
+        }
+        case EColumn::Baseline: {
+            // TODO(akhropov): switch to storing floats - MLTOOLS-2394
+            const auto baseline = (*block.RawTargetData.GetBaseline())[column.TypedIndex];
+            *bitsPerDocument = sizeof(double) * CHAR_BIT;
+            StoreValues<double>(objectCount, [&] (ui32 i) { return baseline[i]; }, quants);
+            return;
+        }
+        case EColumn::GroupId: {
+            const auto groupIds = *block.ObjectsData->GetGroupIds();
+            *bitsPerDocument = sizeof(TGroupId) * CHAR_BIT;
+            StoreValues<TGroupId>(objectCount, [&] (ui32 i) { return groupIds[i]; }, quants);
+            return;
+        }
+        case EColumn::SubgroupId: {
+            const auto subgroupIds = *block.ObjectsData->GetSubgroupIds();
+            *bitsPerDocument = sizeof(TSubgroupId) * CHAR_BIT;
+            StoreValues<TSubgroupId>(objectCount, [&] (ui32 i) { return subgroupIds[i]; }, quants);
+            return;
+        }
+        default:
+            CB_ENSURE_INTERNAL(false, "Unexpected column type " << column.Type);
+    }
+}
+
+void TQuantizedPoolConverter::AddBlock(TRawDataProviderPtr block) {
+    if (!Started) {
+        Start(block);
+    }
+
+    const ui32 objectCount = block->GetObjectCount();
+    CB_ENSURE(
+        static_cast<ui64>(DocumentCount) + objectCount <= Max<ui32>(),
+        "CatBoost does not support datasets with more than " << Max<ui32>() << " objects");
+
+    LocalExecutor->ExecRangeWithThrow(
+        [&] (int columnToWriteIdx) {
+            auto& buffer = *ChunkBuffers[columnToWriteIdx];
+            ui8 bitsPerDocument = 0;
+            QuantizeColumn(*block, ColumnsToWrite[columnToWriteIdx], &buffer.Quants, &bitsPerDocument);
+            NCB::BuildQuantizedFeatureChunk(bitsPerDocument, buffer.Quants, &buffer.Builder);
+        },
+        0,
+        SafeIntegerCast<int>(ColumnsToWrite.size()),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    for (const auto columnToWriteIdx : xrange(ColumnsToWrite.size())) {
+        const auto& builder = ChunkBuffers[columnToWriteIdx]->Builder;
+        Writer.WriteChunk(
+            ColumnsToWrite[columnToWriteIdx].ColumnIndex,
+            DocumentCount,
+            objectCount,
+            MakeArrayRef(builder.GetBufferPointer(), builder.GetSize()));
+    }
+
+    DocumentCount += objectCount;
+    CATBOOST_DEBUG_LOG << "Converted " << DocumentCount << " objects to quantized pool" << Endl;
+}
+
+void TQuantizedPoolConverter::Finish() {
+    CB_ENSURE(Started && DocumentCount > 0, "Pool is empty");
+
+    Writer.Finish(
+        ColumnIndexToLocalIndex,
+        ColumnTypes,
+        ColumnNames,
+        DocumentCount,
+        IgnoredColumnIndices,
+        QuantizationSchema);
+}
+
+// calls `processBlock` for blocks of pool until it returns false
+template <typename TProcessBlock>
+static void ForEachRawBlock(
+    const TPoolConversionParams& params,
+    NPar::TLocalExecutor* const localExecutor,
+    const TProcessBlock& processBlock) {
+
+    auto datasetLoader = GetProcessor<IDatasetLoader>(
+        params.PoolPath, // for choosing processor
+
+        // processor args
+        TDatasetLoaderPullArgs {
+            params.PoolPath,
+
+            TDatasetLoaderCommonArgs {
+                /*PairsFilePath=*/TPathWithScheme(),
+                /*GroupWeightsFilePath=*/TPathWithScheme(),
+                /*BaselineFilePath=*/TPathWithScheme(),
+                params.ClassNames,
+                params.DsvPoolFormatParams.Format,
+                MakeCdProviderFromFile(params.DsvPoolFormatParams.CdFilePath),
+                params.IgnoredFeatures,
+                EObjectsOrder::Undefined,
+                params.BlockSize,
+                localExecutor
+            }
+        }
+    );
+
+    auto* const rawObjectsOrderDatasetLoader = dynamic_cast<IRawObjectsOrderDatasetLoader*>(
+        datasetLoader.Get());
+    CB_ENSURE(
+        rawObjectsOrderDatasetLoader,
+        "Pool " << params.PoolPath.Path << " with scheme '" << params.PoolPath.Scheme
+        << "' can't be read in blocks and converted to quantized pool");
+
+    THolder<IDataProviderBuilder> dataProviderBuilder = CreateDataProviderBuilder(
+        datasetLoader->GetVisitorType(),
+        TDataProviderBuilderOptions{},
+        localExecutor);
+    CB_ENSURE_INTERNAL(
+        dataProviderBuilder,
+        "Failed to create data provider builder for visitor of type " << datasetLoader->GetVisitorType());
+
+    auto* const visitor = dynamic_cast<IRawObjectsOrderDataVisitor*>(dataProviderBuilder.Get());
+    CB_ENSURE_INTERNAL(visitor, "failed cast of IDataProviderBuilder to IRawObjectsOrderDataVisitor");
+
+    const auto addBlock = [&processBlock] (TDataProviderPtr block) {
+        auto rawBlock = block->CastMoveTo<TRawObjectsDataProvider>();
+        CB_ENSURE_INTERNAL(rawBlock, "Data provider is expected to contain raw objects data");
+        return processBlock(std::move(rawBlock));
+    };
+
+    while (rawObjectsOrderDatasetLoader->DoBlock(visitor)) {
+        if (!addBlock(dataProviderBuilder->GetResult())) {
+            return;
+        }
+    }
+    if (auto lastResult = dataProviderBuilder->GetLastResult()) {
+        addBlock(std::move(lastResult));
+    }
+}
+
+void NCB::ConvertPoolToQuantized(
+    const TPoolConversionParams& params,
+    IOutputStream* const output,
+    NPar::TLocalExecutor* const localExecutor) {
+
+    TQuantizedPoolConverter converter(params, output, localExecutor);
+
+    ForEachRawBlock(params, localExecutor, [&] (TRawDataProviderPtr block) {
+        return converter.AddBlockForBorders(std::move(block));
+    });
+    converter.FinishBorders();
+
+    ForEachRawBlock(params, localExecutor, [&] (TRawDataProviderPtr block) {
+        converter.AddBlock(std::move(block));
+        return true;
+    });
+    converter.Finish();
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <catboost/libs/data_util/path_with_scheme.h>
+#include <catboost/libs/options/binarization_options.h>
+#include <catboost/libs/options/load_options.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/stream/fwd.h>
+#include <util/system/types.h>
+
+namespace NCB {
+    struct TPoolConversionParams {
+        TPathWithScheme PoolPath;
+        NCatboostOptions::TDsvPoolFormatParams DsvPoolFormatParams;
+
+        // Borders in Matrixnet format. Borders for features that are absent in this file are
+        // calculated on all objects of the pool.
+        TString InputBordersPath;
+
+        NCatboostOptions::TBinarizationOptions FloatFeaturesBinarization;
+        TVector<ui32> IgnoredFeatures;
+        TVector<TString> ClassNames;
+
+        ui32 BlockSize = 1 << 17;
+    };
+
+    // Converts raw pool to quantized pool reading it block by block, so only one block of the pool
+    // is kept in memory at any moment.
+    //
+    // If borders of some features are not loaded from `params.InputBordersPath`, the first pass
+    // builds quantile sketches of all values of these features, their borders, nan modes and
+    // constant features are determined from the sketches. The second pass quantizes columns of each
+    // block in parallel and appends them to `output` as separate chunks.
+    void ConvertPoolToQuantized(
+        const TPoolConversionParams& params,
+        IOutputStream* output,
+        NPar::TLocalExecutor* localExecutor);
+}
@@ -16,6 +16,7 @@
 #include <util/generic/array_ref.h>
 #include <util/generic/array_size.h>
 #include <util/generic/deque.h>
+#include <util/generic/hash.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
 #include <util/generic/utility.h>
@@ -111,30 +112,6 @@ namespace {
     };
 }
 
-static void WriteChunk(
-    const NCB::TQuantizedPool::TChunkDescription& chunk,
-    TCountingOutput* const output,
-    TDeque<TChunkInfo>* const chunkInfos,
-    flatbuffers::FlatBufferBuilder* const builder) {
-
-    builder->Clear();
-
-    const auto quantsOffset = builder->CreateVector(
-        chunk.Chunk->Quants()->data(),
-        chunk.Chunk->Quants()->size());
-    NCB::NIdl::TQuantizedFeatureChunkBuilder chunkBuilder(*builder);
-    chunkBuilder.add_BitsPerDocument(chunk.Chunk->BitsPerDocument());
-    chunkBuilder.add_Quants(quantsOffset);
-    builder->Finish(chunkBuilder.Finish());
-
-    AddPadding(16, output);
-
-    const auto chunkOffset = output->Counter();
-    output->Write(builder->GetBufferPointer(), builder->GetSize());
-
-    chunkInfos->emplace_back(builder->GetSize(), chunkOffset, chunk.DocumentOffset, chunk.DocumentCount);
-}
-
 static void WriteHeader(TCountingOutput* const output) {
     output->Write(Magic, MagicSize);
     WriteLittleEndian(Version, output);
@@ -222,67 +199,179 @@ static TPoolMetainfo MakePoolMetainfo(
     return metainfo;
 }
 
-static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave) {
-    TCountingOutput output(slave);
+class NCB::TQuantizedPoolWriter::TImpl {
+public:
+    explicit TImpl(IOutputStream* slave)
+        : Output(slave) {
+        WriteHeader(&Output);
+        ChunksOffset = Output.Counter();
+    }
+
+    void WriteChunk(
+        const ui32 columnIndex,
+        const ui32 documentOffset,
+        const ui32 documentCount,
+        const TConstArrayRef<ui8> chunk) {
+
+        CB_ENSURE(!Finished, "Attempt to write chunk into finished quantized pool");
+
+        AddPadding(16, &Output);
+
+        const auto chunkOffset = Output.Counter();
+        Output.Write(chunk.data(), chunk.size());
+
+        ColumnIndexToChunkInfos[columnIndex].emplace_back(
+            chunk.size(),
+            chunkOffset,
+            documentOffset,
+            documentCount);
+    }
+
+    void Finish(
+        const THashMap<size_t, size_t>& columnIndexToLocalIndex,
+        const TConstArrayRef<EColumn> columnTypes,
+        const TConstArrayRef<TString> columnNames,
+        const size_t documentCount,
+        const TConstArrayRef<size_t> ignoredColumnIndices,
+        const NCB::NIdl::TPoolQuantizationSchema& quantizationSchema) {
+
+        CB_ENSURE(!Finished, "Attempt to finish quantized pool twice");
+        Finished = true;
+
+        for (const auto& [columnIndex, chunkInfos] : ColumnIndexToChunkInfos) {
+            CB_ENSURE(
+                columnIndexToLocalIndex.contains(columnIndex),
+                "Chunks were written for column " << columnIndex << " that is absent in pool metainfo");
+        }
+
+        const ui64 poolMetainfoSizeOffset = Output.Counter();
+        {
+            const auto poolMetainfo = MakePoolMetainfo(
+                columnIndexToLocalIndex,
+                columnTypes,
+                columnNames,
+                documentCount,
+                ignoredColumnIndices);
+            const ui32 poolMetainfoSize = poolMetainfo.ByteSizeLong();
+            WriteLittleEndian(poolMetainfoSize, &Output);
+            poolMetainfo.SerializeToStream(&Output);
+        }
+
+        const ui64 quantizationSchemaSizeOffset = Output.Counter();
+        const ui32 quantizationSchemaSize = quantizationSchema.ByteSizeLong();
+        WriteLittleEndian(quantizationSchemaSize, &Output);
+        quantizationSchema.SerializeToStream(&Output);
+
+        const auto sortedTrueFeatureIndices = CollectAndSortKeys(columnIndexToLocalIndex);
+        const TDeque<TChunkInfo> noChunks;
+
+        const ui64 featureCountOffset = Output.Counter();
+        const ui32 featureCount = sortedTrueFeatureIndices.size();
+        WriteLittleEndian(featureCount, &Output);
+        for (const ui32 trueFeatureIndex : sortedTrueFeatureIndices) {
+            const auto* const chunkInfosPtr = ColumnIndexToChunkInfos.FindPtr(trueFeatureIndex);
+            const auto& chunkInfos = chunkInfosPtr ? *chunkInfosPtr : noChunks;
+            const ui32 chunkCount = chunkInfos.size();
+
+            WriteLittleEndian(trueFeatureIndex, &Output);
+            WriteLittleEndian(chunkCount, &Output);
+            for (const auto& chunkInfo : chunkInfos) {
+                WriteLittleEndian(chunkInfo.Size, &Output);
+                WriteLittleEndian(chunkInfo.Offset, &Output);
+                WriteLittleEndian(chunkInfo.DocumentOffset, &Output);
+                WriteLittleEndian(chunkInfo.DocumentsInChunkCount, &Output);
+            }
+        }
+
+        WriteLittleEndian(ChunksOffset, &Output);
+        WriteLittleEndian(poolMetainfoSizeOffset, &Output);
+        WriteLittleEndian(quantizationSchemaSizeOffset, &Output);
+        WriteLittleEndian(featureCountOffset, &Output);
+        Output.Write(MagicEnd, MagicEndSize);
+    }
+
+private:
+    TCountingOutput Output;
+    ui64 ChunksOffset = 0;
+    bool Finished = false;
+    THashMap<ui32, TDeque<TChunkInfo>> ColumnIndexToChunkInfos;
+};
+
+NCB::TQuantizedPoolWriter::TQuantizedPoolWriter(IOutputStream* const output)
+    : Impl(MakeHolder<TImpl>(output)) {
+}
 
-    WriteHeader(&output);
+NCB::TQuantizedPoolWriter::~TQuantizedPoolWriter() = default;
 
-    const auto chunksOffset = output.Counter();
+void NCB::TQuantizedPoolWriter::WriteChunk(
+    const ui32 columnIndex,
+    const ui32 documentOffset,
+    const ui32 documentCount,
+    const TConstArrayRef<ui8> chunk) {
+
+    Impl->WriteChunk(columnIndex, documentOffset, documentCount, chunk);
+}
+
+void NCB::TQuantizedPoolWriter::Finish(
+    const THashMap<size_t, size_t>& columnIndexToLocalIndex,
+    const TConstArrayRef<EColumn> columnTypes,
+    const TConstArrayRef<TString> columnNames,
+    const size_t documentCount,
+    const TConstArrayRef<size_t> ignoredColumnIndices,
+    const NCB::NIdl::TPoolQuantizationSchema& quantizationSchema) {
+
+    Impl->Finish(
+        columnIndexToLocalIndex,
+        columnTypes,
+        columnNames,
+        documentCount,
+        ignoredColumnIndices,
+        quantizationSchema);
+}
+
+void NCB::BuildQuantizedFeatureChunk(
+    const ui8 bitsPerDocument,
+    const TConstArrayRef<ui8> quants,
+    flatbuffers::FlatBufferBuilder* const builder) {
+
+    builder->Clear();
+
+    const auto quantsOffset = builder->CreateVector(quants.data(), quants.size());
+    NCB::NIdl::TQuantizedFeatureChunkBuilder chunkBuilder(*builder);
+    chunkBuilder.add_BitsPerDocument(static_cast<NCB::NIdl::EBitsPerDocumentFeature>(bitsPerDocument));
+    chunkBuilder.add_Quants(quantsOffset);
+    builder->Finish(chunkBuilder.Finish());
+}
+
+static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave) {
+    NCB::TQuantizedPoolWriter writer(slave);
 
     const auto sortedTrueFeatureIndices = CollectAndSortKeys(pool.ColumnIndexToLocalIndex);
-    TDeque<TDeque<TChunkInfo>> perFeatureChunkInfos;
-    perFeatureChunkInfos.resize(pool.ColumnIndexToLocalIndex.size());
     {
         flatbuffers::FlatBufferBuilder builder;
         for (const auto trueFeatureIndex : sortedTrueFeatureIndices) {
             const auto localIndex = pool.ColumnIndexToLocalIndex.at(trueFeatureIndex);
-            auto* const chunkInfos = &perFeatureChunkInfos[localIndex];
             for (const auto& chunk : pool.Chunks[localIndex]) {
-                WriteChunk(chunk, &output, chunkInfos, &builder);
+                NCB::BuildQuantizedFeatureChunk(
+                    chunk.Chunk->BitsPerDocument(),
+                    MakeArrayRef(chunk.Chunk->Quants()->data(), chunk.Chunk->Quants()->size()),
+                    &builder);
+                writer.WriteChunk(
+                    trueFeatureIndex,
+                    chunk.DocumentOffset,
+                    chunk.DocumentCount,
+                    MakeArrayRef(builder.GetBufferPointer(), builder.GetSize()));
             }
         }
     }
 
-    const ui64 poolMetainfoSizeOffset = output.Counter();
-    {
-        const auto poolMetainfo = MakePoolMetainfo(
-            pool.ColumnIndexToLocalIndex,
-            pool.ColumnTypes,
-            pool.ColumnNames,
-            pool.DocumentCount,
-            pool.IgnoredColumnIndices);
-        const ui32 poolMetainfoSize = poolMetainfo.ByteSizeLong();
-        WriteLittleEndian(poolMetainfoSize, &output);
-        poolMetainfo.SerializeToStream(&output);
-    }
-
-    const ui64 quantizationSchemaSizeOffset = output.Counter();
-    const ui32 quantizationSchemaSize = pool.QuantizationSchema.ByteSizeLong();
-    WriteLittleEndian(quantizationSchemaSize, &output);
-    pool.QuantizationSchema.SerializeToStream(&output);
-
-    const ui64 featureCountOffset = output.Counter();
-    const ui32 featureCount = sortedTrueFeatureIndices.size();
-    WriteLittleEndian(featureCount, &output);
-    for (const ui32 trueFeatureIndex : sortedTrueFeatureIndices) {
-        const auto localIndex = pool.ColumnIndexToLocalIndex.at(trueFeatureIndex);
-        const ui32 chunkCount = perFeatureChunkInfos[localIndex].size();
-
-        WriteLittleEndian(trueFeatureIndex, &output);
-        WriteLittleEndian(chunkCount, &output);
-        for (const auto& chunkInfo : perFeatureChunkInfos[localIndex]) {
-            WriteLittleEndian(chunkInfo.Size, &output);
-            WriteLittleEndian(chunkInfo.Offset, &output);
-            WriteLittleEndian(chunkInfo.DocumentOffset, &output);
-            WriteLittleEndian(chunkInfo.DocumentsInChunkCount, &output);
-        }
-    }
-
-    WriteLittleEndian(chunksOffset, &output);
-    WriteLittleEndian(poolMetainfoSizeOffset, &output);
-    WriteLittleEndian(quantizationSchemaSizeOffset, &output);
-    WriteLittleEndian(featureCountOffset, &output);
-    output.Write(MagicEnd, MagicEndSize);
+    writer.Finish(
+        pool.ColumnIndexToLocalIndex,
+        pool.ColumnTypes,
+        pool.ColumnNames,
+        pool.DocumentCount,
+        pool.IgnoredColumnIndices,
+        pool.QuantizationSchema);
 }
 
 void NCB::SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* const output) {
@@ -597,7 +686,7 @@ NCB::TQuantizedPool NCB::LoadQuantizedPool(
 
 static NCB::TQuantizedPoolDigest GetQuantizedPoolDigest(
     const TPoolMetainfo& poolMetainfo,
-    const TPoolQuantizationSchema& quantizationSchema) {
+    const NCB::NIdl::TPoolQuantizationSchema& quantizationSchema) {
 
     NCB::TQuantizedPoolDigest digest;
     const auto columnIndices = CollectAndSortKeys(poolMetainfo.GetColumnIndexToType());
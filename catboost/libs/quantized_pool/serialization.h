@@ -1,7 +1,17 @@
 #pragma once
 
+#include <catboost/libs/column_description/column.h>
+
+#include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
+#include <util/generic/hash.h>
+#include <util/generic/ptr.h>
 #include <util/stream/fwd.h>
+#include <util/system/types.h>
+
+namespace flatbuffers {
+    class FlatBufferBuilder;
+}
 
 namespace NCB {
     struct TQuantizedPool;
@@ -16,6 +26,41 @@ namespace NCB {
 namespace NCB {
     void SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* output);
 
+    // Writes quantized pool in the same format as `SaveQuantizedPool`, but chunks are appended to
+    // `output` as soon as they are ready, so the whole pool never has to be present in memory.
+    //
+    // Each column may be written as any number of chunks in any order, chunks are only required
+    // to not overlap in documents.
+    class TQuantizedPoolWriter {
+    public:
+        explicit TQuantizedPoolWriter(IOutputStream* output);
+        ~TQuantizedPoolWriter();
+
+        // `chunk` is a finished `NIdl::TQuantizedFeatureChunk` flatbuffer (see
+        // `BuildQuantizedFeatureChunk`).
+        void WriteChunk(ui32 columnIndex, ui32 documentOffset, ui32 documentCount, TConstArrayRef<ui8> chunk);
+
+        // Writes pool metainfo and chunk index, no chunks can be written after this call.
+        void Finish(
+            const THashMap<size_t, size_t>& columnIndexToLocalIndex,
+            TConstArrayRef<EColumn> columnTypes,
+            TConstArrayRef<TString> columnNames,
+            size_t documentCount,
+            TConstArrayRef<size_t> ignoredColumnIndices,
+            const NIdl::TPoolQuantizationSchema& quantizationSchema);
+
+    private:
+        class TImpl;
+        THolder<TImpl> Impl;
+    };
+
+    // Builds `NIdl::TQuantizedFeatureChunk` flatbuffer in `builder`, previous content of `builder`
+    // is discarded.
+    void BuildQuantizedFeatureChunk(
+        ui8 bitsPerDocument,
+        TConstArrayRef<ui8> quants,
+        flatbuffers::FlatBufferBuilder* builder);
+
     struct TLoadQuantizedPoolParameters {
         bool LockMemory = true;
         bool Precharge = true;
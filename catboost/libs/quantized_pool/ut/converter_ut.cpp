@@ -0,0 +1,88 @@
+#include <catboost/idl/pool/proto/quantization_schema.pb.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/quantized_pool/converter.h>
+#include <catboost/libs/quantized_pool/pool.h>
+#include <catboost/libs/quantized_pool/serialization.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/stream/file.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
+
+#include <algorithm>
+
+
+// label, feature with nan only in the second block, feature constant in the first block, constant feature
+static const TStringBuf PoolData =
+    "0\t1\t7\t5\n"
+    "1\t2\t7\t5\n"
+    "0\t3\t7\t5\n"
+    "1\tnan\t7\t5\n"
+    "0\t4\t8\t5\n"
+    "1\t5\t9\t5\n";
+
+static NCB::TPoolConversionParams MakeConversionParams(
+    const TTempFile& poolFile,
+    const TTempFile& cdFile,
+    ENanMode nanMode) {
+
+    {
+        TFileOutput pool(poolFile.Name());
+        pool << PoolData;
+        TFileOutput cd(cdFile.Name());
+        cd << "0\tLabel\n";
+    }
+
+    NCB::TPoolConversionParams params;
+    params.PoolPath = NCB::TPathWithScheme(poolFile.Name(), "dsv");
+    params.DsvPoolFormatParams.CdFilePath = NCB::TPathWithScheme(cdFile.Name(), "dsv");
+    params.FloatFeaturesBinarization.NanMode = nanMode;
+    params.BlockSize = 2;
+    return params;
+}
+
+Y_UNIT_TEST_SUITE(ConverterTests) {
+    Y_UNIT_TEST(TestBordersAreCalculatedOnAllBlocks) {
+        TTempFile poolFile(MakeTempName());
+        TTempFile cdFile(MakeTempName());
+        TTempFile quantizedPoolFile(MakeTempName());
+        const auto params = MakeConversionParams(poolFile, cdFile, ENanMode::Min);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(1);
+        {
+            TFileOutput output(quantizedPoolFile.Name());
+            NCB::ConvertPoolToQuantized(params, &output, &localExecutor);
+        }
+
+        const auto pool = NCB::LoadQuantizedPool(quantizedPoolFile.Name(), {false, false});
+        UNIT_ASSERT_VALUES_EQUAL(pool.DocumentCount, 6);
+
+        const auto& featureSchemas = pool.QuantizationSchema.GetFeatureIndexToSchema();
+        UNIT_ASSERT(featureSchemas.count(0));
+        UNIT_ASSERT_EQUAL(featureSchemas.at(0).GetNanMode(), NCB::NIdl::NM_MIN);
+
+        UNIT_ASSERT(featureSchemas.count(1));
+        UNIT_ASSERT(featureSchemas.at(1).BordersSize() > 0);
+
+        UNIT_ASSERT(!featureSchemas.count(2));
+        const auto& ignoredColumns = pool.IgnoredColumnIndices;
+        UNIT_ASSERT(std::find(ignoredColumns.begin(), ignoredColumns.end(), 3) != ignoredColumns.end());
+    }
+
+    Y_UNIT_TEST(TestNanInLaterBlockWithForbiddenNanMode) {
+        TTempFile poolFile(MakeTempName());
+        TTempFile cdFile(MakeTempName());
+        TTempFile quantizedPoolFile(MakeTempName());
+        const auto params = MakeConversionParams(poolFile, cdFile, ENanMode::Forbidden);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(1);
+        TFileOutput output(quantizedPoolFile.Name());
+        UNIT_ASSERT_EXCEPTION(
+            NCB::ConvertPoolToQuantized(params, &output, &localExecutor),
+            TCatBoostException);
+    }
+}
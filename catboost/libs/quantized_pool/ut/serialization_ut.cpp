@@ -16,6 +16,7 @@
 #include <util/generic/array_ref.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
+#include <util/generic/vector.h>
 #include <util/memory/blob.h>
 #include <util/stream/file.h>
 #include <util/stream/input.h>
@@ -23,6 +24,9 @@
 #include <util/stream/output.h>
 #include <util/system/fstat.h>
 
+#include <climits>
+#include <utility>
+
 using NCB::NIdl::TFeatureQuantizationSchema;
 using NCB::NIdl::TPoolQuantizationSchema;
 
@@ -169,6 +173,71 @@ Y_UNIT_TEST_SUITE(SerializationTests) {
         TString diff;
         UNIT_ASSERT_C(IsEqual(expectedQuantizationSchema, quantizationSchema, &diff), diff.data());
     }
+
+    Y_UNIT_TEST(TestWriterWithMultipleChunks) {
+        const auto pool = MakeQuantizedPool();
+        const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
+
+        // write each column as two chunks, chunks of different columns are interleaved
+        {
+            TFileOutput output(path.GetPath());
+            NCB::TQuantizedPoolWriter writer(&output);
+            flatbuffers::FlatBufferBuilder builder;
+            for (const auto& [begin, end] : {std::make_pair(size_t(2), size_t(3)), std::make_pair(size_t(0), size_t(2))}) {
+                for (const auto [columnIndex, localIndex] : pool.ColumnIndexToLocalIndex) {
+                    const auto* const chunk = pool.Chunks[localIndex][0].Chunk;
+                    const size_t bytesPerDocument = chunk->BitsPerDocument() / CHAR_BIT;
+                    NCB::BuildQuantizedFeatureChunk(
+                        chunk->BitsPerDocument(),
+                        MakeArrayRef(
+                            chunk->Quants()->data() + begin * bytesPerDocument,
+                            (end - begin) * bytesPerDocument),
+                        &builder);
+                    writer.WriteChunk(
+                        columnIndex,
+                        begin,
+                        end - begin,
+                        MakeArrayRef(builder.GetBufferPointer(), builder.GetSize()));
+                }
+            }
+            writer.Finish(
+                pool.ColumnIndexToLocalIndex,
+                pool.ColumnTypes,
+                pool.ColumnNames,
+                pool.DocumentCount,
+                pool.IgnoredColumnIndices,
+                pool.QuantizationSchema);
+        }
+
+        const auto loadedPool = NCB::LoadQuantizedPool(path.GetPath(), {false, false});
+        UNIT_ASSERT_VALUES_EQUAL(loadedPool.DocumentCount, pool.DocumentCount);
+        UNIT_ASSERT_VALUES_EQUAL(loadedPool.ColumnIndexToLocalIndex.size(), pool.ColumnIndexToLocalIndex.size());
+        for (const auto [columnIndex, localIndex] : pool.ColumnIndexToLocalIndex) {
+            const auto* const expectedChunk = pool.Chunks[localIndex][0].Chunk;
+            const auto& loadedChunks = loadedPool.Chunks[loadedPool.ColumnIndexToLocalIndex.at(columnIndex)];
+            UNIT_ASSERT_VALUES_EQUAL(loadedChunks.size(), 2);
+
+            TVector<ui8> quants(expectedChunk->Quants()->size());
+            const size_t bytesPerDocument = expectedChunk->BitsPerDocument() / CHAR_BIT;
+            for (const auto& loadedChunk : loadedChunks) {
+                UNIT_ASSERT_VALUES_EQUAL(
+                    static_cast<int>(loadedChunk.Chunk->BitsPerDocument()),
+                    static_cast<int>(expectedChunk->BitsPerDocument()));
+                UNIT_ASSERT_VALUES_EQUAL(
+                    loadedChunk.Chunk->Quants()->size(),
+                    loadedChunk.DocumentCount * bytesPerDocument);
+                Copy(
+                    loadedChunk.Chunk->Quants()->begin(),
+                    loadedChunk.Chunk->Quants()->end(),
+                    quants.begin() + loadedChunk.DocumentOffset * bytesPerDocument);
+            }
+
+            UNIT_ASSERT(Equal(
+                quants.begin(),
+                quants.end(),
+                expectedChunk->Quants()->begin()));
+        }
+    }
 }
 
 Y_UNIT_TEST_SUITE(DigestTests) {
@@ -10,6 +10,7 @@
 #include <catboost/libs/algo/learn_context.h>
 #include <catboost/libs/algo/train.h>
 #include <catboost/libs/algo/tree_print.h>
+#include <catboost/libs/column_description/cd_parser.h>
 #include <catboost/libs/data_new/borders_io.h>
 #include <catboost/libs/data_new/load_data.h>
 #include <catboost/libs/distributed/master.h>
@@ -30,11 +31,14 @@
 #include <catboost/libs/options/plain_options_helper.h>
 #include <catboost/libs/options/system_options.h>
 #include <catboost/libs/pairs/util.h>
+#include <catboost/libs/quantized_pool/converter.h>
 #include <catboost/libs/target/classification_target_helper.h>
 
 #include <library/grid_creator/binarization.h>
 #include <library/json/json_prettifier.h>
 
+#include <util/folder/path.h>
+#include <util/generic/hash_set.h>
 #include <util/generic/mapfindptr.h>
 #include <util/generic/scope.h>
 #include <util/generic/vector.h>
@@ -42,7 +46,10 @@
 #include <util/generic/ymath.h>
 #include <util/random/shuffle.h>
 #include <util/system/compiler.h>
+#include <util/stream/file.h>
 #include <util/system/hp_timer.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
 
 
 using namespace NCB;
@@ -145,6 +152,24 @@ static void InitializeAndCheckMetricData(
         approxDimension
     );
     CheckMetrics(metrics, ctx.Params.LossFunctionDescription.Get().GetLossFunction());
+    {
+        TVector<TTargetDependentCacheData> cachedDatasets;
+        auto addCachedDataset = [&] (const TTrainingForCPUDataProvider& dataset) {
+            const auto& targetData = dataset.TargetData;
+            auto maybeTarget = targetData->GetTarget();
+            auto maybeQueriesInfo = targetData->GetGroupInfo();
+            if (maybeTarget && maybeQueriesInfo) {
+                cachedDatasets.push_back({*maybeTarget, *maybeQueriesInfo, targetData});
+            }
+        };
+        addCachedDataset(*data.Learn);
+        for (const auto& testData : data.Test) {
+            if (testData) {
+                addCachedDataset(*testData);
+            }
+        }
+        EnableTargetDependentCaches(metrics, cachedDatasets, ctx.LocalExecutor);
+    }
     if (!ctx.Params.SystemOptions->IsSingleHost()) {
         if (!AllOf(metrics, [](const auto& metric) { return metric->IsAdditiveMetric(); })) {
             CATBOOST_WARNING_LOG << "In distributed training, non-additive metrics are not evaluated on train dataset" << Endl;
@@ -328,7 +353,7 @@ static void Train(
     InitializeAndCheckMetricData(data, forceCalcEvalMetricOnEveryIteration, *ctx, &metricsData);
 
     if (ctx->TryLoadProgress() && ctx->Params.SystemOptions->IsMaster()) {
-        MapRestoreApproxFromTreeStruct(ctx);
+        MapRestoreApproxFromTreeStruct(data, ctx);
     }
 
     TLoggingData loggingData;
@@ -538,8 +563,10 @@ namespace {
             if (!systemOptions->IsSingleHost()) { // send target, weights, baseline (if present), binarized features to workers and ask them to create plain folds
                 InitializeMaster(&ctx);
                 CB_ENSURE(IsPlainMode(ctx.Params.BoostingOptions->BoostingType), "Distributed training requires plain boosting");
-                CB_ENSURE(!ctx.Layout->GetCatFeatureCount(), "Distributed training doesn't support categorical features");
-                MapBuildPlainFold(trainingDataForCpu.Learn, &ctx);
+                CB_ENSURE(
+                    ctx.Params.CatFeatureParams->CtrLeafCountLimit.Get() == Max<ui64>(),
+                    "Distributed training doesn't support ctr leaf count limit");
+                MapBuildPlainFold(trainingDataForCpu.Learn, internalOptions.PoolLoadParams, &ctx);
             }
             TVector<TVector<double>> oneRawValues(ctx.LearnProgress.ApproxDimension);
             TVector<TVector<TVector<double>>> rawValues(trainingDataForCpu.Test.size(), oneRawValues);
@@ -677,7 +704,8 @@ static void TrainModel(
     TFullModel* modelPtr,
     const TVector<TEvalResult*>& evalResultPtrs,
     TMetricsAndTimeLeftHistory* metricsAndTimeHistory,
-    NPar::TLocalExecutor* const executor)
+    NPar::TLocalExecutor* const executor,
+    const NCatboostOptions::TPoolLoadParams* poolLoadParams = nullptr)
 {
     CB_ENSURE(pools.Learn != nullptr, "Train data must be provided");
     CB_ENSURE(pools.Test.size() == evalResultPtrs.size());
@@ -792,8 +820,11 @@ static void TrainModel(
             *trainingData.Learn->ObjectsData->GetQuantizedFeaturesInfo());
     }
 
+    TTrainModelInternalOptions internalOptions;
+    internalOptions.PoolLoadParams = poolLoadParams;
+
     modelTrainerHolder->TrainModel(
-        TTrainModelInternalOptions(),
+        internalOptions,
         updatedTrainOptionsJson,
         updatedOutputOptions,
         objectiveDescriptor,
@@ -810,6 +841,91 @@ static void TrainModel(
 }
 
 
+/* Master of distributed training with workers_load_learn_data doesn't need raw learn features:
+ * workers read and quantize their parts themselves. So learn data is converted to a quantized pool
+ * in train dir reading it block by block (borders are calculated from quantile sketches of all values),
+ * then master loads this pool and holds only quantized feature columns, target, weights and group ids.
+ * Returns false if learn data has columns that quantized pools don't support, it is loaded as usual then.
+ */
+static bool CanConvertLearnDataForDistributedMaster(
+    const NCatboostOptions::TCatBoostOptions& catBoostOptions,
+    const NCatboostOptions::TPoolLoadParams& loadOptions
+) {
+    const auto& systemOptions = catBoostOptions.SystemOptions.Get();
+    if ((catBoostOptions.GetTaskType() != ETaskType::CPU) ||
+        !systemOptions.IsMaster() ||
+        !systemOptions.WorkersLoadLearnData.Get() ||
+        (loadOptions.CvParams.FoldCount != 0) ||
+        !loadOptions.DsvPoolFormatParams.CdFilePath.Inited())
+    {
+        return false;
+    }
+    const auto& dataProcessingOptions = catBoostOptions.DataProcessingOptions.Get();
+    if (!dataProcessingOptions.ClassNames.Get().empty() ||
+        !dataProcessingOptions.PerFloatFeatureBinarization.Get().empty())
+    {
+        CATBOOST_WARNING_LOG << "Master loads raw learn data: class names and per feature binarization"
+            " are not supported in quantized pools" << Endl;
+        return false;
+    }
+
+    const THashSet<ui32> ignoredFeatures(
+        loadOptions.IgnoredFeatures.begin(),
+        loadOptions.IgnoredFeatures.end());
+    ui32 flatFeatureIdx = 0;
+    for (const auto& column : ReadCD(loadOptions.DsvPoolFormatParams.CdFilePath)) {
+        switch (column.Type) {
+            case EColumn::Categ:
+                if (!ignoredFeatures.contains(flatFeatureIdx)) {
+                    CATBOOST_WARNING_LOG << "Master loads raw learn data: categorical features"
+                        " are not supported in quantized pools" << Endl;
+                    return false;
+                }
+                break;
+            case EColumn::Auxiliary:
+            case EColumn::Timestamp:
+            case EColumn::Sparse:
+            case EColumn::Prediction:
+                CATBOOST_WARNING_LOG << "Master loads raw learn data: column type " << column.Type
+                    << " is not supported in quantized pools" << Endl;
+                return false;
+            default:
+                break;
+        }
+        if (IsFactorColumn(column.Type)) {
+            ++flatFeatureIdx;
+        }
+    }
+    return true;
+}
+
+static THolder<TTempFile> ConvertLearnDataForDistributedMaster(
+    const NCatboostOptions::TCatBoostOptions& catBoostOptions,
+    const NCatboostOptions::TOutputFilesOptions& outputOptions,
+    const NCatboostOptions::TPoolLoadParams& loadOptions,
+    NPar::TLocalExecutor* executor
+) {
+    TFsPath trainDir = outputOptions.GetTrainDir() ? TFsPath(outputOptions.GetTrainDir()) : TFsPath::Cwd();
+    if (!trainDir.Exists()) {
+        trainDir.MkDirs();
+    }
+    // unique name, so that concurrent runs in the same train dir and user files are not overwritten
+    auto quantizedLearnFile = MakeHolder<TTempFile>(MakeTempName(trainDir.c_str(), "learn_quantized"));
+
+    TPoolConversionParams conversionParams;
+    conversionParams.PoolPath = loadOptions.LearnSetPath;
+    conversionParams.DsvPoolFormatParams = loadOptions.DsvPoolFormatParams;
+    conversionParams.InputBordersPath = loadOptions.BordersFile;
+    conversionParams.FloatFeaturesBinarization
+        = catBoostOptions.DataProcessingOptions->FloatFeaturesBinarization.Get();
+    conversionParams.IgnoredFeatures = loadOptions.IgnoredFeatures;
+
+    TOFStream output(quantizedLearnFile->Name());
+    ConvertPoolToQuantized(conversionParams, &output, executor);
+    output.Finish();
+    return quantizedLearnFile;
+}
+
 void TrainModel(
     const NCatboostOptions::TPoolLoadParams& loadOptions,
     const NCatboostOptions::TOutputFilesOptions& outputOptions,
@@ -830,9 +946,22 @@ void TrainModel(
     NPar::TLocalExecutor executor;
     executor.RunAdditionalThreads(catBoostOptions.SystemOptions.Get().NumThreads.Get() - 1);
 
+    // workers get original loadOptions to read their parts of learn data
+    NCatboostOptions::TPoolLoadParams masterLoadOptions = loadOptions;
+    THolder<TTempFile> quantizedLearnFile;
+    if (CanConvertLearnDataForDistributedMaster(catBoostOptions, loadOptions)) {
+        quantizedLearnFile = ConvertLearnDataForDistributedMaster(
+            catBoostOptions,
+            outputOptions,
+            loadOptions,
+            &executor);
+        masterLoadOptions.LearnSetPath = TPathWithScheme(quantizedLearnFile->Name(), "quantized");
+        profile.AddOperation("Convert learn data to quantized pool for master");
+    }
+
     TVector<TString> classNames = catBoostOptions.DataProcessingOptions->ClassNames;
     TDataProviders pools = LoadPools(
-        loadOptions,
+        masterLoadOptions,
         catBoostOptions.DataProcessingOptions->HasTimeFlag.Get() ?
             EObjectsOrder::Ordered : EObjectsOrder::Undefined,
         &classNames,
@@ -899,7 +1028,8 @@ void TrainModel(
         nullptr,
         GetMutablePointers(evalResults),
         nullptr,
-        &executor
+        &executor,
+        &loadOptions
     );
     auto modelFormat = outputOptions.GetModelFormats()[0];
     const auto fullModelPath = NCatboostOptions::AddExtension(
@@ -33,6 +33,10 @@ struct TTrainModelInternalOptions {
 
     // force it even if overfitting detector is disabled, used in Cross-Validation
     bool ForceCalcEvalMetricOnEveryIteration = false;
+
+    // where learn data has been loaded from, nullptr if it is not loaded from files.
+    // Used if workers in distributed training load their parts of learn data themselves
+    const NCatboostOptions::TPoolLoadParams* PoolLoadParams = nullptr;
 };
 
 
@@ -1123,6 +1123,40 @@ def test_apply_missing_vals(boosting_type):
     return local_canonical_file(output_eval_path)
 
 
+def test_calc_binary_output():
+    model_path = yatest.common.test_output_path('model.bin')
+    output_dsv_path = yatest.common.test_output_path('test.eval')
+    output_binary_path = yatest.common.test_output_path('test.eval.bin')
+
+    cmd = (
+        CATBOOST_PATH,
+        'fit',
+        '--loss-function', 'MultiClass',
+        '-f', data_file('cloudness_small', 'train_small'),
+        '--column-description', data_file('cloudness_small', 'train.cd'),
+        '-i', '10',
+        '-T', '4',
+        '-m', model_path,
+    )
+    yatest.common.execute(cmd)
+
+    calc_cmd = (
+        CATBOOST_PATH,
+        'calc',
+        '--input-path', data_file('cloudness_small', 'test_small'),
+        '--column-description', data_file('cloudness_small', 'train.cd'),
+        '-m', model_path,
+        '--prediction-type', 'RawFormulaVal,Probability',
+        '--eval-period', '5',
+    )
+    yatest.common.execute(calc_cmd + ('--output-path', output_dsv_path))
+    yatest.common.execute(calc_cmd + ('--output-path', 'binary://' + output_binary_path))
+
+    dsv_predictions = np.loadtxt(output_dsv_path, delimiter='\t', skiprows=1)[:, 1:]
+    binary_predictions = np.fromfile(output_binary_path, dtype=np.float64).reshape(dsv_predictions.shape)
+    assert np.allclose(dsv_predictions, binary_predictions, rtol=1e-5, atol=1e-6)
+
+
 @pytest.mark.parametrize('boosting_type', BOOSTING_TYPE)
 @pytest.mark.parametrize(
     'dev_score_calc_obj_block_size',
@@ -2228,6 +2262,58 @@ def test_feature_border_types(border_type, boosting_type):
     return [local_canonical_file(output_eval_path)]
 
 
+@pytest.mark.parametrize('border_type', BORDER_TYPES)
+def test_use_quantile_sketches_for_borders(border_type):
+    border_count = 32
+
+    def run_catboost(use_sketches):
+        suffix = '_sketches' if use_sketches else ''
+        borders_path = yatest.common.test_output_path('borders{}.tsv'.format(suffix))
+        test_error_path = yatest.common.test_output_path('test_error{}.tsv'.format(suffix))
+        cmd = [
+            CATBOOST_PATH,
+            'fit',
+            '--use-best-model', 'false',
+            '--loss-function', 'Logloss',
+            '-f', data_file('adult', 'train_small'),
+            '-t', data_file('adult', 'test_small'),
+            '--column-description', data_file('adult', 'train.cd'),
+            '-i', '20',
+            '-T', '4',
+            '-x', str(border_count),
+            '--feature-border-type', border_type,
+            '-m', yatest.common.test_output_path('model{}.bin'.format(suffix)),
+            '--test-err-log', test_error_path,
+            '--output-borders-file', borders_path,
+        ]
+        if use_sketches:
+            cmd.append('--use-quantile-sketches-for-borders')
+        yatest.common.execute(cmd)
+        return borders_path, test_error_path
+
+    borders_path, test_error_path = run_catboost(use_sketches=False)
+    sketches_borders_path, sketches_test_error_path = run_catboost(use_sketches=True)
+
+    def read_borders(path):
+        borders = {}
+        with open(path) as borders_file:
+            for line in borders_file:
+                feature_idx, border = line.split('\t')[:2]
+                borders.setdefault(int(feature_idx), []).append(float(border))
+        return borders
+
+    borders = read_borders(borders_path)
+    sketches_borders = read_borders(sketches_borders_path)
+    assert set(borders.keys()) <= set(sketches_borders.keys())
+    for feature_borders in sketches_borders.values():
+        assert len(feature_borders) <= border_count
+        assert feature_borders == sorted(set(feature_borders))
+
+    final_loss = np.loadtxt(test_error_path, skiprows=1)[-1][1]
+    sketches_final_loss = np.loadtxt(sketches_test_error_path, skiprows=1)[-1][1]
+    assert abs(sketches_final_loss - final_loss) < 0.01
+
+
 @pytest.mark.parametrize('depth', [4, 8])
 @pytest.mark.parametrize('boosting_type', BOOSTING_TYPE)
 def test_deep_tree_classification(depth, boosting_type):
@@ -4092,6 +4178,85 @@ def test_dist_train(dev_score_calc_obj_block_size):
         dev_score_calc_obj_block_size=dev_score_calc_obj_block_size)))]
 
 
+@pytest.mark.parametrize('loss_function,pool,cd', [
+    ('Logloss', 'higgs', 'train_weight.cd'),
+    ('MultiClass', 'cloudness_small', 'train_float.cd'),
+])
+def test_dist_train_workers_load_learn_data(loss_function, pool, cd):
+    cmd = make_deterministic_train_cmd(
+        loss_function=loss_function,
+        pool=pool,
+        train='train_small',
+        test='test_small',
+        cd=cd)
+
+    # master calculates borders from quantile sketches of learn data, reuse them in single host training
+    borders_path = yatest.common.test_output_path('borders.tsv')
+    eval_1_path = yatest.common.test_output_path('test_1.eval')
+    execute_dist_train(cmd + (
+        '--workers-load-learn-data',
+        '--output-borders-file', borders_path,
+        '--eval-file', eval_1_path,))
+
+    eval_0_path = yatest.common.test_output_path('test_0.eval')
+    yatest.common.execute(cmd + ('--input-borders-file', borders_path, '--eval-file', eval_0_path,))
+
+    eval_0 = np.loadtxt(eval_0_path, dtype='float', delimiter='\t', skiprows=1)
+    eval_1 = np.loadtxt(eval_1_path, dtype='float', delimiter='\t', skiprows=1)
+    assert(np.allclose(eval_0, eval_1, rtol=1e-3))
+
+
+@pytest.mark.parametrize('loss_function,pool,cd', [
+    ('Logloss', 'higgs', 'train_weight.cd'),
+    ('MultiClass', 'cloudness_small', 'train_float.cd'),
+])
+def test_dist_train_exchange_stats_in_float(loss_function, pool, cd):
+    run_dist_train(make_deterministic_train_cmd(
+        loss_function=loss_function,
+        pool=pool,
+        train='train_small',
+        test='test_small',
+        cd=cd,
+        other_options=('--exchange-stats-in-float',)))
+
+
+@pytest.mark.parametrize('workers_load_learn_data', [False, True], ids=['master_loads_data', 'workers_load_data'])
+def test_dist_train_local_workers(workers_load_learn_data):
+    cmd = make_deterministic_train_cmd(
+        loss_function='Logloss',
+        pool='higgs',
+        train='train_small',
+        test='test_small',
+        cd='train.cd')
+    local_workers_cmd = cmd + ('--local-worker-count', '3',)
+    if workers_load_learn_data:
+        # master calculates borders from quantile sketches of learn data, reuse them in single host training
+        borders_path = yatest.common.test_output_path('borders.tsv')
+        local_workers_cmd += ('--workers-load-learn-data', '--output-borders-file', borders_path,)
+        cmd += ('--input-borders-file', borders_path,)
+
+    local_workers_eval_path = yatest.common.test_output_path('local_workers_test.eval')
+    yatest.common.execute(local_workers_cmd + ('--eval-file', local_workers_eval_path,))
+
+    eval_path = yatest.common.test_output_path('test.eval')
+    yatest.common.execute(cmd + ('--eval-file', eval_path,))
+
+    eval = np.loadtxt(eval_path, dtype='float', delimiter='\t', skiprows=1)
+    local_workers_eval = np.loadtxt(local_workers_eval_path, dtype='float', delimiter='\t', skiprows=1)
+    assert(np.allclose(eval, local_workers_eval, rtol=1e-3))
+
+
+@pytest.mark.parametrize('loss_function', ['Logloss', 'RMSE'])
+def test_dist_train_with_cat_features(loss_function):
+    run_dist_train(make_deterministic_train_cmd(
+        loss_function=loss_function,
+        pool='adult',
+        train='train_small',
+        test='test_small',
+        cd='train.cd',
+        other_options=('--counter-calc-method', 'Full')))
+
+
 @pytest.mark.parametrize(
     'dev_score_calc_obj_block_size',
     SCORE_CALC_OBJ_BLOCK_SIZES,
@@ -4288,6 +4453,88 @@ def test_dist_train_snapshot():
     return [local_canonical_file(eval_5_plus_5_trees_path)]
 
 
+def test_dist_train_snapshot_with_cat_features():
+    train_cmd = make_deterministic_train_cmd(
+        loss_function='Logloss',
+        pool='adult',
+        train='train_small',
+        test='test_small',
+        cd='train.cd')
+
+    eval_10_trees_path = yatest.common.test_output_path('10_trees.eval')
+    yatest.common.execute(train_cmd + ('-i', '10', '--eval-file', eval_10_trees_path,))
+
+    snapshot_path = yatest.common.test_output_path('snapshot')
+    execute_dist_train(train_cmd + ('-i', '5', '--snapshot-file', snapshot_path,))
+
+    eval_5_plus_5_trees_path = yatest.common.test_output_path('5_plus_5_trees.eval')
+    execute_dist_train(train_cmd + ('-i', '10', '--eval-file', eval_5_plus_5_trees_path, '--snapshot-file', snapshot_path,))
+
+    eval_10_trees = np.loadtxt(eval_10_trees_path, dtype='float', delimiter='\t', skiprows=1)
+    eval_5_plus_5_trees = np.loadtxt(eval_5_plus_5_trees_path, dtype='float', delimiter='\t', skiprows=1)
+    assert(np.allclose(eval_10_trees, eval_5_plus_5_trees, rtol=1e-3))
+
+
+def test_dist_train_resume_after_worker_failure():
+    iterations = 100
+    train_cmd = make_deterministic_train_cmd(
+        loss_function='Logloss',
+        pool='adult',
+        train='train_small',
+        test='test_small',
+        cd='train.cd',
+        other_options=('-i', str(iterations)))
+
+    eval_path = yatest.common.test_output_path('test.eval')
+    yatest.common.execute(train_cmd + ('--eval-file', eval_path,))
+
+    snapshot_path = yatest.common.test_output_path('snapshot')
+    snapshot_options = ('--snapshot-file', snapshot_path, '--snapshot-interval', '0')
+    hosts_path = yatest.common.test_output_path('hosts.txt')
+    with network.PortManager() as pm:
+        ports = [pm.get_port(), pm.get_port()]
+        with open(hosts_path, 'w') as hosts:
+            for port in ports:
+                hosts.write('localhost:' + str(port) + '\n')
+        workers = [
+            yatest.common.execute((CATBOOST_PATH, 'run-worker', '--node-port', str(port),), wait=False)
+            for port in ports
+        ]
+        while any(pm.is_port_free(port) for port in ports):
+            time.sleep(1)
+
+        failed_learn_error_path = yatest.common.test_output_path('failed_learn_error.tsv')
+        master = yatest.common.execute(
+            train_cmd + snapshot_options + (
+                '--learn-err-log', failed_learn_error_path,
+                '--worker-response-timeout', '10',
+                '--node-type', 'Master',
+                '--file-with-hosts', hosts_path,
+            ),
+            wait=False)
+        while master.running and not os.path.exists(snapshot_path):
+            time.sleep(0.1)
+        assert master.running, 'Training finished before worker failure'
+        workers[1].kill()
+        master.wait(check_exit_code=False)
+        if workers[0].running:
+            workers[0].kill()
+
+    assert master.exit_code != 0
+    assert "Workers didn't respond in" in master.std_err
+    # snapshot is saved after the last logged iteration at most
+    failed_iteration_count = len(np.loadtxt(failed_learn_error_path, delimiter='\t', skiprows=1, ndmin=2))
+    assert failed_iteration_count < iterations
+
+    # new workers get parts of learn data by their positions in file with hosts
+    resumed_eval_path = yatest.common.test_output_path('resumed_test.eval')
+    execute_dist_train(train_cmd + snapshot_options + ('--eval-file', resumed_eval_path,))
+
+    eval = np.loadtxt(eval_path, dtype='float', delimiter='\t', skiprows=1)
+    resumed_eval = np.loadtxt(resumed_eval_path, dtype='float', delimiter='\t', skiprows=1)
+    assert(np.allclose(eval, resumed_eval, rtol=1e-3))
+
+
 def test_dist_train_yetirank():
     return [local_canonical_file(run_dist_train(make_deterministic_train_cmd(
             loss_function='YetiRank',
@@ -4730,6 +4977,24 @@ def test_eval_non_additive_metric(eval_period):
     second_metrics = np.loadtxt(output_eval_in_parts, skiprows=1)
     assert np.all(first_metrics == second_metrics)
 
+    output_eval_single_pass = yatest.common.test_output_path('eval_single_pass.eval')
+    cmd = (
+        CATBOOST_PATH,
+        'eval-metrics',
+        '--metrics', 'AUC:hints=skip_train~false',
+        '--input-path', data_file('adult', 'test_small'),
+        '--column-description', data_file('adult', 'train.cd'),
+        '-m', output_model_path,
+        '-o', output_eval_single_pass,
+        '--eval-period', eval_period,
+        '--single-pass',
+        '--block-size', '10'
+    )
+    yatest.common.execute(cmd)
+
+    third_metrics = np.loadtxt(output_eval_single_pass, skiprows=1)
+    assert np.all(first_metrics == third_metrics)
+
     return [local_canonical_file(output_eval_path)]
 
 
@@ -5764,6 +6029,42 @@ def test_shap_verbose():
         assert line_count == 5
 
 
+def test_shap_used_ram_limit():
+    output_model_path = yatest.common.test_output_path('model.bin')
+    cmd_fit = [
+        CATBOOST_PATH,
+        'fit',
+        '--loss-function', 'MultiClass',
+        '-f', data_file('cloudness_small', 'train_small'),
+        '--column-description', data_file('cloudness_small', 'train.cd'),
+        '-i', '100',
+        '--depth', '6',
+        '-T', '4',
+        '-m', output_model_path,
+    ]
+    yatest.common.execute(cmd_fit)
+
+    output_values_paths = []
+    for used_ram_limit in [None, '256KB']:
+        output_values_path = yatest.common.test_output_path('shapval_{}'.format(used_ram_limit))
+        cmd_shap = [
+            CATBOOST_PATH,
+            'fstr',
+            '-o', output_values_path,
+            '--input-path', data_file('cloudness_small', 'train_small'),
+            '--column-description', data_file('cloudness_small', 'train.cd'),
+            '--fstr-type', 'ShapValues',
+            '-T', '4',
+            '-m', output_model_path,
+        ]
+        if used_ram_limit is not None:
+            cmd_shap += ['--shap-used-ram-limit', used_ram_limit]
+        yatest.common.execute(cmd_shap)
+        output_values_paths.append(output_values_path)
+
+    assert np.allclose(np.loadtxt(output_values_paths[0]), np.loadtxt(output_values_paths[1]), atol=1e-9)
+
+
 @pytest.mark.parametrize('bagging_temperature', ['0', '1'])
 @pytest.mark.parametrize('sampling_unit', SAMPLING_UNIT_TYPES)
 @pytest.mark.parametrize(
@@ -858,6 +858,34 @@ cdef extern from "catboost/python-package/catboost/helpers.h":
         TVector[TVector[double]] ComputeScores()
         void AddPool(const TDataProvider& srcData)
 
+    cdef cppclass TNumpyFeaturesBuffer:
+        const char* Data
+        char DTypeKind
+        ui32 ItemSize
+        ui32 ObjectCount
+        ui32 FeatureCount
+        i64 ObjectStride
+        i64 FeatureStride
+
+    cdef bool_t IsNumpyNumFeaturesDTypeSupported(char dtypeKind, ui32 itemSize)
+    cdef bool_t IsNumpyCatFeaturesDTypeSupported(char dtypeKind, ui32 itemSize)
+
+    cdef void AddNumFeaturesFromNumpyBuffer(
+        const TNumpyFeaturesBuffer& buffer,
+        TConstArrayRef[ui32] columnIndices,
+        TConstArrayRef[ui32] flatFeatureIndices,
+        TLocalExecutor* localExecutor,
+        IRawFeaturesOrderDataVisitor* visitor
+    ) nogil except +ProcessException
+
+    cdef void AddCatFeaturesFromNumpyBuffer(
+        const TNumpyFeaturesBuffer& buffer,
+        TConstArrayRef[ui32] columnIndices,
+        TConstArrayRef[ui32] flatFeatureIndices,
+        TLocalExecutor* localExecutor,
+        IRawFeaturesOrderDataVisitor* visitor
+    ) nogil except +ProcessException
+
 
 cdef inline float _FloatOrNan(object obj) except *:
     try:
@@ -1356,9 +1384,73 @@ cdef _get_object_count(data):
     else:
         return np.shape(data)[0]
 
+cdef bool_t _is_np_buffer_supported(np.ndarray values, bool_t is_cat_feature):
+    cdef char dtype_kind = <char>ord(values.dtype.kind)
+    cdef ui32 item_size = <ui32>values.dtype.itemsize
+    if not values.dtype.isnative:
+        return False
+    if is_cat_feature:
+        return IsNumpyCatFeaturesDTypeSupported(dtype_kind, item_size)
+    return IsNumpyNumFeaturesDTypeSupported(dtype_kind, item_size)
+
+
+# values must be 1-dimensional (single feature column) or 2-dimensional [object_idx, feature_idx] array
+# with dtype supported by _is_np_buffer_supported
+# column_indices are columns of values to add (all columns if empty) as flat_feature_indices features
+cdef _add_features_from_np_buffer(
+    np.ndarray values,
+    const TVector[ui32]& column_indices,
+    const TVector[ui32]& flat_feature_indices,
+    bool_t is_cat_feature,
+    TLocalExecutor* local_executor,
+    IRawFeaturesOrderDataVisitor* builder_visitor
+):
+    cdef TNumpyFeaturesBuffer buffer
+    cdef TConstArrayRef[ui32] column_indices_ref = TConstArrayRef[ui32](
+        column_indices.data(),
+        column_indices.size()
+    )
+    cdef TConstArrayRef[ui32] flat_feature_indices_ref = TConstArrayRef[ui32](
+        flat_feature_indices.data(),
+        flat_feature_indices.size()
+    )
+
+    buffer.Data = <const char*>values.data
+    buffer.DTypeKind = <char>ord(values.dtype.kind)
+    buffer.ItemSize = <ui32>values.dtype.itemsize
+    buffer.ObjectCount = <ui32>values.shape[0]
+    buffer.ObjectStride = <i64>values.strides[0]
+    if values.ndim == 2:
+        buffer.FeatureCount = <ui32>values.shape[1]
+        buffer.FeatureStride = <i64>values.strides[1]
+    else:
+        buffer.FeatureCount = 1
+        buffer.FeatureStride = 0
+
+    if is_cat_feature:
+        with nogil:
+            AddCatFeaturesFromNumpyBuffer(
+                buffer,
+                column_indices_ref,
+                flat_feature_indices_ref,
+                local_executor,
+                builder_visitor
+            )
+    else:
+        with nogil:
+            AddNumFeaturesFromNumpyBuffer(
+                buffer,
+                column_indices_ref,
+                flat_feature_indices_ref,
+                local_executor,
+                builder_visitor
+            )
+
+
 cdef _set_features_order_data_np(
-    const float [:,:] num_feature_values,
+    np.ndarray num_feature_values,
     object [:,:] cat_feature_values, # cannot be const due to https://github.com/cython/cython/issues/2485
+    TLocalExecutor* local_executor,
     IRawFeaturesOrderDataVisitor* builder_visitor
 ):
     if (num_feature_values is None) and (cat_feature_values is None):
@@ -1373,6 +1465,8 @@ cdef _set_features_order_data_np(
 
     cdef TString factor_string
     cdef TVector[TString] cat_factor_data
+    cdef TVector[ui32] all_column_indices # empty
+    cdef TVector[ui32] num_feature_indices
     cdef ui32 doc_idx
     cdef ui32 num_feature_idx
     cdef ui32 cat_feature_idx
@@ -1380,19 +1474,20 @@ cdef _set_features_order_data_np(
     cdef ui32 dst_feature_idx
 
     cat_factor_data.reserve(doc_count)
-    dst_feature_idx = <ui32>0
-
-    dst_feature_idx = 0
-    for num_feature_idx in range(num_feature_count):
-        builder_visitor[0].AddFloatFeature(
-            dst_feature_idx,
-            TMaybeOwningConstArrayHolder[float].CreateNonOwning(
-                TConstArrayRef[float](&num_feature_values[0, num_feature_idx], doc_count)
-                if doc_count > 0
-                else TConstArrayRef[float]()
-            )
+
+    if num_feature_count > 0:
+        for num_feature_idx in range(num_feature_count):
+            num_feature_indices.push_back(num_feature_idx)
+        _add_features_from_np_buffer(
+            num_feature_values,
+            all_column_indices,
+            num_feature_indices,
+            False,
+            local_executor,
+            builder_visitor
         )
-        dst_feature_idx += 1
+
+    dst_feature_idx = num_feature_count
     for cat_feature_idx in range(cat_feature_count):
         cat_factor_data.clear()
         for doc_idx in range(doc_count):
@@ -1402,6 +1497,57 @@ cdef _set_features_order_data_np(
         dst_feature_idx += 1
 
 
+# returns True if all columns of 2-dimensional numpy array can be processed by _add_features_from_np_buffer
+cdef bool_t _is_np_features_order_data_supported(np.ndarray data, const TFeaturesLayout* features_layout):
+    cdef ui32 cat_feature_count = features_layout.GetCatFeatureCount()
+    cdef ui32 feature_count = features_layout.GetExternalFeatureCount()
+    if data.ndim != 2:
+        return False
+    if (cat_feature_count > 0) and not _is_np_buffer_supported(data, True):
+        return False
+    if (cat_feature_count < feature_count) and not _is_np_buffer_supported(data, False):
+        return False
+    return True
+
+
+cdef _set_features_order_data_np_matrix(
+    np.ndarray data,
+    const TFeaturesLayout* features_layout,
+    TLocalExecutor* local_executor,
+    IRawFeaturesOrderDataVisitor* builder_visitor
+):
+    cdef TVector[bool_t] is_cat_feature_mask = _get_is_cat_feature_mask(features_layout)
+    cdef TVector[ui32] cat_feature_indices
+    cdef TVector[ui32] num_feature_indices
+    cdef ui32 flat_feature_idx
+
+    for flat_feature_idx in range(is_cat_feature_mask.size()):
+        if is_cat_feature_mask[flat_feature_idx]:
+            cat_feature_indices.push_back(flat_feature_idx)
+        else:
+            num_feature_indices.push_back(flat_feature_idx)
+
+    # all columns of each type at once to convert C-ordered data in cache-friendly blocks
+    if cat_feature_indices.size() > 0:
+        _add_features_from_np_buffer(
+            data,
+            cat_feature_indices,
+            cat_feature_indices,
+            True,
+            local_executor,
+            builder_visitor
+        )
+    if num_feature_indices.size() > 0:
+        _add_features_from_np_buffer(
+            data,
+            num_feature_indices,
+            num_feature_indices,
+            False,
+            local_executor,
+            builder_visitor
+        )
+
+
 cdef float get_float_feature(ui32 doc_idx, ui32 flat_feature_idx, src_value) except*:
     try:
         return _FloatOrNan(src_value)
@@ -1454,6 +1600,7 @@ cdef get_cat_factor_bytes_representation(
 cdef object _set_features_order_data_pd_data_frame(
     data_frame,
     const TFeaturesLayout* features_layout,
+    TLocalExecutor* local_executor,
     IRawFeaturesOrderDataVisitor* builder_visitor
 ):
     cdef TVector[bool_t] is_cat_feature_mask = _get_is_cat_feature_mask(features_layout)
@@ -1466,19 +1613,35 @@ cdef object _set_features_order_data_pd_data_frame(
     cdef TIntrusivePtr[IResourceHolder] num_factor_data_holder
 
     cdef TVector[TString] cat_factor_data
+    cdef TVector[ui32] all_column_indices # empty
+    cdef TVector[ui32] flat_feature_indices
     cdef ui32 doc_idx
     cdef ui32 flat_feature_idx
     cdef np.ndarray column_values # for columns that are not of type pandas.Categorical
     cdef bool_t column_type_is_pandas_Categorical
 
     cat_factor_data.reserve(doc_count)
+    flat_feature_indices.resize(1)
 
     new_data_holders = []
     for flat_feature_idx, (column_name, column_data) in enumerate(data_frame.iteritems()):
         column_type_is_pandas_Categorical = column_data.dtype.name == 'category'
         if not column_type_is_pandas_Categorical:
             column_values = column_data.values
-        if is_cat_feature_mask[flat_feature_idx]:
+        flat_feature_indices[0] = flat_feature_idx
+        if (is_cat_feature_mask[flat_feature_idx] and
+            (not column_type_is_pandas_Categorical) and
+            _is_np_buffer_supported(column_values, True)
+           ):
+            _add_features_from_np_buffer(
+                column_values,
+                all_column_indices,
+                flat_feature_indices,
+                True,
+                local_executor,
+                builder_visitor
+            )
+        elif is_cat_feature_mask[flat_feature_idx]:
             cat_factor_data.clear()
             for doc_idx in range(doc_count):
                 get_cat_factor_bytes_representation(
@@ -1507,10 +1670,21 @@ cdef object _set_features_order_data_pd_data_frame(
                 )
             )
         else:
-            num_factor_data = create_num_factor_data(
-                flat_feature_idx,
-                column_values if not column_type_is_pandas_Categorical else np.asarray(column_data)
-            )
+            if column_type_is_pandas_Categorical:
+                column_values = np.asarray(column_data)
+            if _is_np_buffer_supported(column_values, False):
+                new_data_holders.append(column_values)
+                _add_features_from_np_buffer(
+                    column_values,
+                    all_column_indices,
+                    flat_feature_indices,
+                    False,
+                    local_executor,
+                    builder_visitor
+                )
+                continue
+
+            num_factor_data = create_num_factor_data(flat_feature_idx, column_values)
             num_factor_data_holder.Reset(num_factor_data.Get())
             builder_visitor[0].AddFloatFeature(
                 flat_feature_idx,
@@ -1802,12 +1976,17 @@ cdef class _PoolBase:
         group_weight,
         subgroup_id,
         pairs_weight,
-        baseline):
+        baseline,
+        int thread_count):
 
         cdef TDataProviderBuilderOptions options
         cdef THolder[IDataProviderBuilder] data_provider_builder
         cdef IRawFeaturesOrderDataVisitor* builder_visitor
 
+        # shared by conversions of all feature columns
+        cdef TLocalExecutor local_executor
+        local_executor.RunAdditionalThreads(thread_count - 1)
+
         CreateDataProviderBuilderAndVisitor(options, &data_provider_builder, &builder_visitor)
 
         cdef TVector[TIntrusivePtr[IResourceHolder]] resource_holders
@@ -1828,6 +2007,7 @@ cdef class _PoolBase:
             _set_features_order_data_np(
                 data.num_feature_data,
                 data.cat_feature_data,
+                &local_executor,
                 builder_visitor)
 
             # set after _set_features_order_data_np call because we can't pass const cat_feature_data to it
@@ -1840,12 +2020,18 @@ cdef class _PoolBase:
             new_data_holders = _set_features_order_data_pd_data_frame(
                 data,
                 data_meta_info.FeaturesLayout.Get(),
+                &local_executor,
                 builder_visitor
             )
-        elif isinstance(data, np.ndarray) and data.dtype == np.float32:
+        elif isinstance(data, np.ndarray):
             new_data_holders = data
             data.setflags(write=0)
-            _set_features_order_data_np(data, None, builder_visitor)
+            _set_features_order_data_np_matrix(
+                data,
+                data_meta_info.FeaturesLayout.Get(),
+                &local_executor,
+                builder_visitor
+            )
         else:
             raise CatBoostError(
                 '[Internal error] wrong data type for _init_features_order_layout_pool: ' + type(data)
@@ -1937,7 +2123,7 @@ cdef class _PoolBase:
         self.__pool = data_provider_builder.Get()[0].GetResult()
 
 
-    cpdef _init_pool(self, data, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names):
+    cpdef _init_pool(self, data, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names, thread_count):
         if group_weight is not None and weight is not None:
             raise CatBoostError('Pool must have either weight or group_weight.')
 
@@ -1953,19 +2139,18 @@ cdef class _PoolBase:
 
         data_meta_info.FeaturesLayout = _init_features_layout(data, cat_features, feature_names)
 
+        thread_count = UpdateThreadCount(thread_count)
+
+        # numeric numpy data of any memory layout is converted to features order in C++ in parallel,
+        # generic objects are processed one by one in objects order
         do_use_raw_data_in_features_order = False
-        if isinstance(data, FeaturesData):
-            if ((data.num_feature_data is not None) and
-                data.num_feature_data.flags.aligned and
-                data.num_feature_data.flags.f_contiguous
-               ):
-                do_use_raw_data_in_features_order = True
-        elif isinstance(data, pd.DataFrame):
+        if isinstance(data, (FeaturesData, pd.DataFrame)):
             do_use_raw_data_in_features_order = True
-        else:
-            if isinstance(data, np.ndarray) and data.dtype == np.float32:
-                if data.flags.aligned and data.flags.f_contiguous:
-                    do_use_raw_data_in_features_order = True
+        elif isinstance(data, np.ndarray):
+            do_use_raw_data_in_features_order = _is_np_features_order_data_supported(
+                data,
+                data_meta_info.FeaturesLayout.Get()
+            )
 
         if do_use_raw_data_in_features_order:
             self._init_features_order_layout_pool(
@@ -1978,7 +2163,8 @@ cdef class _PoolBase:
                 group_weight,
                 subgroup_id,
                 pairs_weight,
-                baseline
+                baseline,
+                thread_count
             )
         else:
             self._init_objects_order_layout_pool(
@@ -257,8 +257,7 @@ class Pool(_PoolBase):
             Must be None if 'data' parameter has FeatureData type
 
         thread_count : int, optional (default=-1)
-            Thread count to read data from file.
-            Use only with reading data from file.
+            Thread count to read data from file or to convert numpy and pandas data.
             If -1, then the number of threads is set to the number of cores.
 
         """
@@ -288,7 +287,7 @@ class Pool(_PoolBase):
                             " but 'cat_features' parameter specifies nonzero number of categorical features"
                         )
 
-                self._init(data, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names)
+                self._init(data, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names, thread_count)
         super(Pool, self).__init__()
 
     def _check_files(self, data, column_description, pairs):
@@ -581,7 +580,7 @@ class Pool(_PoolBase):
             self._check_thread_count(thread_count)
             self._read_pool(pool_file, column_description, pairs, delimiter[0], has_header, thread_count)
 
-    def _init(self, data, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names):
+    def _init(self, data, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names, thread_count):
         """
         Initialize Pool from array like data.
         """
@@ -643,7 +642,8 @@ class Pool(_PoolBase):
             self._check_baseline_shape(baseline, samples_count)
         if feature_names is not None:
             self._check_feature_names(feature_names, features_count)
-        self._init_pool(data, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names)
+        self._check_thread_count(thread_count)
+        self._init_pool(data, label, cat_features, pairs, weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, feature_names, thread_count)
 
 
 def _build_train_pool(X, y, cat_features, pairs, sample_weight, group_id, group_weight, subgroup_id, pairs_weight, baseline, column_description):
@@ -2001,6 +2001,9 @@ class CatBoostClassifier(CatBoost):
         the Categ features to Num and the choice of a tree structure).
     allow_const_label : bool, [default=False]
         To allow the constant label value in dataset.
+    use_quantile_sketches_for_borders : bool, [default=False]
+        Calculate float feature borders from mergeable quantile sketches of all feature values
+        instead of a random subset of objects.
     classes_count : int, [default=None]
         The upper limit for the numeric class label.
         Defines the number of classes for multiclassification.
@@ -2227,7 +2230,8 @@ class CatBoostClassifier(CatBoost):
         min_samples_in_leaf=None,
         max_leaves_count=None,
         leaf_estimation_backtracking=None,
-        ctr_history_unit=None
+        ctr_history_unit=None,
+        use_quantile_sketches_for_borders=None
     ):
         params = {}
         not_params = ["not_params", "self", "params", "__class__"]
@@ -2605,7 +2609,8 @@ class CatBoostRegressor(CatBoost):
         min_samples_in_leaf=None,
         max_leaves_count=None,
         leaf_estimation_backtracking=None,
-        ctr_history_unit=None
+        ctr_history_unit=None,
+        use_quantile_sketches_for_borders=None
     ):
         params = {}
         not_params = ["not_params", "self", "params", "__class__"]
@@ -2,10 +2,23 @@
 
 #include "helpers.h"
 
+#include <catboost/libs/cat_feature/cat_feature.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/helpers/interrupt.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/hash.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/string/cast.h>
+#include <util/system/unaligned_mem.h>
+
+#include <type_traits>
+
 extern "C" PyObject* PyCatboostExceptionType;
 
 void ProcessException() {
@@ -131,3 +144,320 @@ TVector<double> EvalMetricsForUtils(
     }
     return metricResults;
 }
+
+
+namespace {
+    // features are converted in FEATURE_BLOCK_SIZE x OBJECT_BLOCK_SIZE tiles so that source rows of
+    // C-ordered arrays are read by whole cache lines and each task has enough work
+    constexpr ui32 FEATURE_BLOCK_SIZE = 16;
+    constexpr ui32 OBJECT_BLOCK_SIZE = 1 << 16;
+
+    template <class TFunc>
+    void DispatchNumpyIntegerDType(char dtypeKind, ui32 itemSize, TFunc&& func) {
+        switch (dtypeKind) {
+            case 'i':
+                switch (itemSize) {
+                    case 1: func(i8()); return;
+                    case 2: func(i16()); return;
+                    case 4: func(i32()); return;
+                    case 8: func(i64()); return;
+                }
+                break;
+            case 'u':
+                switch (itemSize) {
+                    case 1: func(ui8()); return;
+                    case 2: func(ui16()); return;
+                    case 4: func(ui32()); return;
+                    case 8: func(ui64()); return;
+                }
+                break;
+        }
+        CB_ENSURE(false, "Unsupported numpy integer dtype: kind='" << dtypeKind << "', itemsize=" << itemSize);
+    }
+
+    template <class TFunc>
+    void DispatchNumpyNumericDType(char dtypeKind, ui32 itemSize, TFunc&& func) {
+        if (dtypeKind == 'f') {
+            switch (itemSize) {
+                case 4: func(float()); return;
+                case 8: func(double()); return;
+            }
+        } else if ((dtypeKind == 'b') && (itemSize == 1)) {
+            func(ui8());
+            return;
+        } else if ((dtypeKind == 'i') || (dtypeKind == 'u')) {
+            DispatchNumpyIntegerDType(dtypeKind, itemSize, std::forward<TFunc>(func));
+            return;
+        }
+        CB_ENSURE(false, "Unsupported numpy dtype for numeric features: kind='" << dtypeKind << "', itemsize=" << itemSize);
+    }
+
+    template <class T>
+    inline T ReadNumpyValue(const TNumpyFeaturesBuffer& buffer, ui32 objectIdx, ui32 columnIdx) {
+        return ReadUnaligned<T>(
+            buffer.Data + (i64)objectIdx * buffer.ObjectStride + (i64)columnIdx * buffer.FeatureStride
+        );
+    }
+
+    // all buffer columns if columnIndices is empty
+    TVector<ui32> GetColumnIndices(const TNumpyFeaturesBuffer& buffer, TConstArrayRef<ui32> columnIndices) {
+        if (columnIndices.empty()) {
+            TVector<ui32> allColumnIndices(buffer.FeatureCount);
+            Iota(allColumnIndices.begin(), allColumnIndices.end(), 0);
+            return allColumnIndices;
+        }
+        for (auto columnIdx : columnIndices) {
+            CB_ENSURE_INTERNAL(columnIdx < buffer.FeatureCount, "column index is out of buffer feature count");
+        }
+        return TVector<ui32>(columnIndices.begin(), columnIndices.end());
+    }
+
+    // calls f(featureBegin, featureEnd, objectBegin, objectEnd) for all tiles in parallel,
+    // features are positions in the list of featureCount selected columns
+    template <class TFunc>
+    void ParallelForNumpyBufferTiles(
+        const TNumpyFeaturesBuffer& buffer,
+        ui32 featureCount,
+        NPar::TLocalExecutor* localExecutor,
+        TFunc&& func
+    ) {
+        const ui32 featureBlockCount = CeilDiv(featureCount, FEATURE_BLOCK_SIZE);
+        const ui32 objectBlockCount = CeilDiv(buffer.ObjectCount, OBJECT_BLOCK_SIZE);
+
+        localExecutor->ExecRangeWithThrow(
+            [&] (int tileIdx) {
+                const ui32 featureBlockIdx = (ui32)tileIdx % featureBlockCount;
+                const ui32 objectBlockIdx = (ui32)tileIdx / featureBlockCount;
+                const ui32 featureBegin = featureBlockIdx * FEATURE_BLOCK_SIZE;
+                const ui32 featureEnd = Min(featureBegin + FEATURE_BLOCK_SIZE, featureCount);
+                const ui32 objectBegin = objectBlockIdx * OBJECT_BLOCK_SIZE;
+                const ui32 objectEnd = Min(objectBegin + OBJECT_BLOCK_SIZE, buffer.ObjectCount);
+                func(featureBegin, featureEnd, objectBegin, objectEnd);
+            },
+            0,
+            SafeIntegerCast<int>(featureBlockCount * objectBlockCount),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+
+    /*
+     * readValue(objectIdx, columnIdx, hashValue) must call hashValue with the string value,
+     * string data is only required to be alive during this call
+     */
+    template <class TReadValue>
+    void AddCatFeaturesFromNumpyBufferImpl(
+        const TNumpyFeaturesBuffer& buffer,
+        TConstArrayRef<ui32> columns,
+        TConstArrayRef<ui32> flatFeatureIndices,
+        NPar::TLocalExecutor* localExecutor,
+        NCB::IRawFeaturesOrderDataVisitor* visitor,
+        TReadValue&& readValue
+    ) {
+        const ui32 objectBlockCount = CeilDiv(buffer.ObjectCount, OBJECT_BLOCK_SIZE);
+
+        TVector<TVector<ui32>> hashes(columns.size());
+        // [featureIdx][objectBlockIdx], each tile collects its own unique values
+        TVector<TVector<THashMap<ui32, TString>>> hashToStringParts(columns.size());
+        for (auto featureIdx : xrange(columns.size())) {
+            hashes[featureIdx].yresize(buffer.ObjectCount);
+            hashToStringParts[featureIdx].resize(objectBlockCount);
+        }
+
+        ParallelForNumpyBufferTiles(
+            buffer,
+            columns.size(),
+            localExecutor,
+            [&] (ui32 featureBegin, ui32 featureEnd, ui32 objectBegin, ui32 objectEnd) {
+                const ui32 objectBlockIdx = objectBegin / OBJECT_BLOCK_SIZE;
+                for (auto objectIdx : xrange(objectBegin, objectEnd)) {
+                    for (auto featureIdx : xrange(featureBegin, featureEnd)) {
+                        auto& hashToString = hashToStringParts[featureIdx][objectBlockIdx];
+                        readValue(
+                            objectIdx,
+                            columns[featureIdx],
+                            [&] (TStringBuf value) {
+                                const ui32 hashVal = CalcCatFeatureHash(value);
+                                hashes[featureIdx][objectIdx] = hashVal;
+                                THashMap<ui32, TString>::insert_ctx insertCtx = nullptr;
+                                if (!hashToString.contains(hashVal, insertCtx)) {
+                                    hashToString.emplace_direct(insertCtx, hashVal, TString(value));
+                                }
+                            }
+                        );
+                    }
+                }
+            }
+        );
+
+        for (auto featureIdx : xrange(columns.size())) {
+            auto& parts = hashToStringParts[featureIdx];
+            THashMap<ui32, TString> hashToString;
+            if (!parts.empty()) {
+                hashToString = std::move(parts[0]);
+                for (auto objectBlockIdx : xrange<size_t>(1, parts.size())) {
+                    for (auto& [hashVal, value] : parts[objectBlockIdx]) {
+                        hashToString.emplace(hashVal, std::move(value));
+                    }
+                }
+            }
+            parts = TVector<THashMap<ui32, TString>>(); // release memory
+
+            visitor->AddCatFeature(
+                flatFeatureIndices[featureIdx],
+                NCB::TMaybeOwningConstArrayHolder<ui32>::CreateOwning(std::move(hashes[featureIdx])),
+                std::move(hashToString)
+            );
+        }
+    }
+}
+
+bool IsNumpyNumFeaturesDTypeSupported(char dtypeKind, ui32 itemSize) {
+    switch (dtypeKind) {
+        case 'f':
+            return (itemSize == 4) || (itemSize == 8);
+        case 'b':
+            return itemSize == 1;
+        case 'i':
+        case 'u':
+            return (itemSize == 1) || (itemSize == 2) || (itemSize == 4) || (itemSize == 8);
+        default:
+            return false;
+    }
+}
+
+bool IsNumpyCatFeaturesDTypeSupported(char dtypeKind, ui32 itemSize) {
+    switch (dtypeKind) {
+        case 'S':
+            return itemSize > 0;
+        case 'i':
+        case 'u':
+            return (itemSize == 1) || (itemSize == 2) || (itemSize == 4) || (itemSize == 8);
+        default:
+            return false;
+    }
+}
+
+void AddNumFeaturesFromNumpyBuffer(
+    const TNumpyFeaturesBuffer& buffer,
+    TConstArrayRef<ui32> columnIndices,
+    TConstArrayRef<ui32> flatFeatureIndices,
+    NPar::TLocalExecutor* localExecutor,
+    NCB::IRawFeaturesOrderDataVisitor* visitor
+) {
+    const TVector<ui32> columns = GetColumnIndices(buffer, columnIndices);
+    CB_ENSURE_INTERNAL(
+        flatFeatureIndices.size() == columns.size(),
+        "flatFeatureIndices size is not equal to column count"
+    );
+
+    if ((buffer.DTypeKind == 'f') && (buffer.ItemSize == sizeof(float)) && (buffer.ObjectStride == sizeof(float))
+        && (reinterpret_cast<size_t>(buffer.Data) % alignof(float) == 0))
+    {
+        for (auto featureIdx : xrange(columns.size())) {
+            const float* column = reinterpret_cast<const float*>(
+                buffer.Data + (i64)columns[featureIdx] * buffer.FeatureStride
+            );
+            visitor->AddFloatFeature(
+                flatFeatureIndices[featureIdx],
+                NCB::TMaybeOwningConstArrayHolder<float>::CreateNonOwning(
+                    TConstArrayRef<float>(column, buffer.ObjectCount)
+                )
+            );
+        }
+        return;
+    }
+
+    TVector<TVector<float>> features(columns.size());
+    for (auto& feature : features) {
+        feature.yresize(buffer.ObjectCount);
+    }
+
+    DispatchNumpyNumericDType(
+        buffer.DTypeKind,
+        buffer.ItemSize,
+        [&] (auto typeTag) {
+            using TSrc = decltype(typeTag);
+            ParallelForNumpyBufferTiles(
+                buffer,
+                columns.size(),
+                localExecutor,
+                [&] (ui32 featureBegin, ui32 featureEnd, ui32 objectBegin, ui32 objectEnd) {
+                    for (auto objectIdx : xrange(objectBegin, objectEnd)) {
+                        for (auto featureIdx : xrange(featureBegin, featureEnd)) {
+                            features[featureIdx][objectIdx] = static_cast<float>(
+                                ReadNumpyValue<TSrc>(buffer, objectIdx, columns[featureIdx])
+                            );
+                        }
+                    }
+                }
+            );
+        }
+    );
+
+    for (auto featureIdx : xrange(columns.size())) {
+        visitor->AddFloatFeature(
+            flatFeatureIndices[featureIdx],
+            NCB::TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(features[featureIdx]))
+        );
+    }
+}
+
+void AddCatFeaturesFromNumpyBuffer(
+    const TNumpyFeaturesBuffer& buffer,
+    TConstArrayRef<ui32> columnIndices,
+    TConstArrayRef<ui32> flatFeatureIndices,
+    NPar::TLocalExecutor* localExecutor,
+    NCB::IRawFeaturesOrderDataVisitor* visitor
+) {
+    const TVector<ui32> columns = GetColumnIndices(buffer, columnIndices);
+    CB_ENSURE_INTERNAL(
+        flatFeatureIndices.size() == columns.size(),
+        "flatFeatureIndices size is not equal to column count"
+    );
+
+    if (buffer.DTypeKind == 'S') {
+        AddCatFeaturesFromNumpyBufferImpl(
+            buffer,
+            columns,
+            flatFeatureIndices,
+            localExecutor,
+            visitor,
+            [&] (ui32 objectIdx, ui32 columnIdx, auto&& hashValue) {
+                const char* value = buffer.Data + (i64)objectIdx * buffer.ObjectStride
+                    + (i64)columnIdx * buffer.FeatureStride;
+                size_t size = buffer.ItemSize;
+                while ((size > 0) && (value[size - 1] == '\0')) {
+                    --size;
+                }
+                hashValue(TStringBuf(value, size));
+            }
+        );
+        return;
+    }
+
+    DispatchNumpyIntegerDType(
+        buffer.DTypeKind,
+        buffer.ItemSize,
+        [&] (auto typeTag) {
+            using TSrc = decltype(typeTag);
+            // i8 and ui8 must be printed as numbers, not characters
+            using TDecimal = std::conditional_t<std::is_signed<TSrc>::value, i64, ui64>;
+            AddCatFeaturesFromNumpyBufferImpl(
+                buffer,
+                columns,
+                flatFeatureIndices,
+                localExecutor,
+                visitor,
+                [&] (ui32 objectIdx, ui32 columnIdx, auto&& hashValue) {
+                    char value[32];
+                    const size_t size = ToString(
+                        static_cast<TDecimal>(ReadNumpyValue<TSrc>(buffer, objectIdx, columnIdx)),
+                        value,
+                        sizeof(value)
+                    );
+                    hashValue(TStringBuf(value, size));
+                }
+            );
+        }
+    );
+}
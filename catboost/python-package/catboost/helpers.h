@@ -1,13 +1,18 @@
 #pragma once
 
 #include <catboost/libs/algo/plot.h>
+#include <catboost/libs/data_new/visitor.h>
 #include <catboost/libs/data_types/groupid.h>
 #include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/metrics/metric.h>
 #include <catboost/libs/options/loss_description.h>
 #include <catboost/libs/target/data_providers.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
 #include <util/generic/noncopyable.h>
+#include <util/system/types.h>
 
 #include <Python.h>
 
@@ -52,6 +57,56 @@ TVector<double> EvalMetricsForUtils(
 );
 
 
+/*
+ * 2D features array buffer as exposed by numpy: C- or Fortran-ordered arrays, their views and
+ * single pandas columns (FeatureCount = 1) are all described by data pointer and strides.
+ * DTypeKind and ItemSize are numpy's dtype.kind and dtype.itemsize.
+ */
+struct TNumpyFeaturesBuffer {
+    const char* Data = nullptr;
+    char DTypeKind = 'f';
+    ui32 ItemSize = sizeof(float);
+    ui32 ObjectCount = 0;
+    ui32 FeatureCount = 0;
+    i64 ObjectStride = 0; // in bytes
+    i64 FeatureStride = 0; // in bytes
+};
+
+// float ('f'), signed and unsigned integer ('i', 'u') and bool ('b') dtypes
+bool IsNumpyNumFeaturesDTypeSupported(char dtypeKind, ui32 itemSize);
+
+// signed and unsigned integer ('i', 'u') and fixed size bytes ('S') dtypes
+bool IsNumpyCatFeaturesDTypeSupported(char dtypeKind, ui32 itemSize);
+
+/*
+ * Converts buffer columns columnIndices (all columns if empty) to float features in parallel blocks
+ * and adds them to visitor as flatFeatureIndices[i] features for i-th column.
+ * Pass all columns of a 2D array in one call: blocks of rows of C-ordered arrays are then read once.
+ * Contiguous float32 columns are passed without copying, so buffer must be kept alive while
+ * the resulting data provider is used.
+ */
+void AddNumFeaturesFromNumpyBuffer(
+    const TNumpyFeaturesBuffer& buffer,
+    TConstArrayRef<ui32> columnIndices,
+    TConstArrayRef<ui32> flatFeatureIndices,
+    NPar::TLocalExecutor* localExecutor,
+    NCB::IRawFeaturesOrderDataVisitor* visitor
+);
+
+/*
+ * Same columns selection as in AddNumFeaturesFromNumpyBuffer.
+ * Integer values are converted to their decimal representation (as for integer python objects),
+ * bytes values are used as is without trailing zero bytes (as numpy does)
+ */
+void AddCatFeaturesFromNumpyBuffer(
+    const TNumpyFeaturesBuffer& buffer,
+    TConstArrayRef<ui32> columnIndices,
+    TConstArrayRef<ui32> flatFeatureIndices,
+    NPar::TLocalExecutor* localExecutor,
+    NCB::IRawFeaturesOrderDataVisitor* visitor
+);
+
+
 inline TVector<NCatboostOptions::TLossDescription> CreateMetricLossDescriptions(
     const TVector<TString>& metricDescriptions) {
 
@@ -2775,6 +2775,24 @@ def test_loading_pool_with_numpy_str():
     assert _check_shape(Pool(np.array([['abc', '2'], ['1', '2']]), np.array([1, 3]), cat_features=[0]), object_count=2, features_count=2)
 
 
+def test_loading_pool_from_numpy_layouts_and_dtypes():
+    data = [[0, 1, 2, 10], [3, 5, 4, 11], [6, 0, 7, 10]]
+    labels = [0, 1, 1]
+    expected_features = Pool(data, labels, cat_features=[3]).get_features()
+    for dtype in [np.float32, np.float64, np.int8, np.int32, np.int64, np.uint16, np.uint64]:
+        for order in ['C', 'F']:
+            np_data = np.array(data, dtype=dtype, order=order)
+            pool = Pool(np_data, labels, cat_features=[3] if np.issubdtype(dtype, np.integer) else None)
+            if np.issubdtype(dtype, np.integer):
+                assert _check_data(pool.get_features(), expected_features)
+            else:
+                assert _check_data(pool.get_features(), Pool(np_data.tolist(), labels).get_features())
+            # non-contiguous view
+            np_data_view = np_data[::2, :3]
+            expected_view_features = Pool([row[:3] for row in data[::2]], labels[::2]).get_features()
+            assert _check_data(Pool(np_data_view, labels[::2]).get_features(), expected_view_features)
+
+
 def test_loading_pool_with_lists():
     assert _check_shape(Pool([['abc', 2], ['1', 2]], [1, 3], cat_features=[0]), object_count=2, features_count=2)
 
@@ -0,0 +1,361 @@
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/data_new/quantization.h>
+#include <catboost/libs/data_types/groupid.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/restorable_rng.h>
+#include <catboost/libs/logging/logging.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/options/binarization_options.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/getopt/small/last_getopt.h>
+#include <library/json/json_reader.h>
+#include <library/json/json_writer.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/folder/path.h>
+#include <util/folder/tempdir.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/map.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/system/hp_timer.h>
+
+#include <cmath>
+
+
+using namespace NCB;
+
+
+/* Benchmark of CPU training hot paths on a deterministic synthetic dataset.
+ *
+ * Prints JSON with generation and quantization times and average per-iteration times of training
+ * phases, collected from the detailed profile of the training loop.
+ */
+
+
+namespace {
+    struct TSyntheticDataParams {
+        ui32 ObjectCount = 100000;
+        ui32 FloatFeatureCount = 50;
+        ui32 CatFeatureCount = 0;
+        ui32 CatFeatureCardinality = 100;
+        ui32 AverageGroupSize = 0; // 0 means no groups
+        bool BinaryTarget = false;
+        ui64 Seed = 0;
+    };
+
+    struct TBenchmarkParams {
+        TSyntheticDataParams Data;
+        ui32 IterationCount = 100;
+        ui32 Depth = 6;
+        ui32 BorderCount = 254;
+        ui32 ThreadCount = 1;
+        TString LossFunction = "RMSE";
+        TString BoostingType = "Plain";
+        TString OutputPath; // stdout if empty
+    };
+}
+
+
+// phases of interest and profile operations that contribute to them
+static const TVector<std::pair<TString, TVector<TString>>> PhaseOperationPrefixes = {
+    {"CalcWeightedDerivatives", {"Calc derivatives"}},
+    {"ComputeOnlineCTRs", {"ComputeOnlineCTRs"}},
+    {"CalcStatsAndScores", {"Calc scores "}},
+    {"UpdateApproxDeltas", {"CalcApprox tree struct", "CalcApprox result leaves"}}
+};
+
+
+static TDataProviderPtr GenerateData(const TSyntheticDataParams& params) {
+    const ui32 objectCount = params.ObjectCount;
+    const ui32 featureCount = params.FloatFeatureCount + params.CatFeatureCount;
+
+    TFastRng64 rng(params.Seed);
+
+    TVector<TVector<float>> floatFeatures(params.FloatFeatureCount); // [featureIdx][objectIdx]
+    for (auto& feature : floatFeatures) {
+        feature.yresize(objectCount);
+        for (auto& value : feature) {
+            value = (float)rng.GenRandReal1();
+        }
+    }
+
+    TVector<TVector<ui32>> catFeatureValues(params.CatFeatureCount); // [featureIdx][objectIdx]
+    for (auto& feature : catFeatureValues) {
+        feature.yresize(objectCount);
+        for (auto& value : feature) {
+            // skewed towards small values, like real categorical features
+            value = (ui32)(params.CatFeatureCardinality * Sqr(rng.GenRandReal1()));
+        }
+    }
+
+    // target depends on a few float features and on hashes of categorical values
+    TVector<float> target(objectCount);
+    for (auto objectIdx : xrange(objectCount)) {
+        double signal = 0.0;
+        for (auto featureIdx : xrange(Min<ui32>(params.FloatFeatureCount, 5))) {
+            signal += (featureIdx % 2 ? 1.0 : -1.0) * floatFeatures[featureIdx][objectIdx] / (featureIdx + 1);
+        }
+        for (auto featureIdx : xrange(Min<ui32>(params.CatFeatureCount, 5))) {
+            const ui32 value = catFeatureValues[featureIdx][objectIdx];
+            signal += 0.5 * (((value * 2654435761u) >> 16) % 2 ? 1.0 : -1.0) / (featureIdx + 1);
+        }
+        signal += 0.1 * (rng.GenRandReal1() - 0.5);
+        target[objectIdx] = params.BinaryTarget ? (float)(signal > 0.0) : (float)signal;
+    }
+
+    TVector<TGroupId> groupIds;
+    if (params.AverageGroupSize) {
+        groupIds.yresize(objectCount);
+        ui32 groupIdx = 0;
+        for (ui32 groupBegin = 0; groupBegin < objectCount; ++groupIdx) {
+            const ui32 groupSize = 1 + rng.Uniform(2 * params.AverageGroupSize - 1);
+            const ui32 groupEnd = Min(groupBegin + groupSize, objectCount);
+            for (auto objectIdx : xrange(groupBegin, groupEnd)) {
+                groupIds[objectIdx] = CalcGroupIdFor(ToString(groupIdx));
+            }
+            groupBegin = groupEnd;
+        }
+    }
+
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TVector<ui32> catFeatureIndices;
+            for (auto catFeatureIdx : xrange(params.CatFeatureCount)) {
+                catFeatureIndices.push_back(params.FloatFeatureCount + catFeatureIdx);
+            }
+
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.HasGroupId = !groupIds.empty();
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                featureCount,
+                catFeatureIndices,
+                TVector<TString>{});
+
+            visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+            for (auto objectIdx : xrange(groupIds.size())) {
+                visitor->AddGroupId(objectIdx, groupIds[objectIdx]);
+            }
+            for (auto featureIdx : xrange(params.FloatFeatureCount)) {
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(floatFeatures[featureIdx]))
+                );
+            }
+            for (auto catFeatureIdx : xrange(params.CatFeatureCount)) {
+                TVector<TString> values;
+                values.reserve(objectCount);
+                for (auto value : catFeatureValues[catFeatureIdx]) {
+                    values.push_back(ToString(value));
+                }
+                visitor->AddCatFeature(params.FloatFeatureCount + catFeatureIdx, TConstArrayRef<TString>(values));
+            }
+            visitor->AddTarget(target);
+
+            visitor->Finish();
+        }
+    );
+}
+
+
+static NJson::TJsonValue ReadProfileSummary(const TString& profileJsonLogPath) {
+    TIFStream in(profileJsonLogPath);
+    NJson::TJsonValue summary;
+    TString line;
+    while (in.ReadLine(line)) {
+        NJson::TJsonValue record;
+        if (NJson::ReadJsonTree(line, &record) && record.Has("average_period")) {
+            summary = std::move(record);
+        }
+    }
+    CB_ENSURE(summary.IsDefined(), "No profile summary in " << profileJsonLogPath);
+    return summary;
+}
+
+
+static NJson::TJsonValue RunBenchmark(const TBenchmarkParams& params) {
+    NJson::TJsonValue result;
+    auto& config = result["config"];
+    config["rows"] = params.Data.ObjectCount;
+    config["float_features"] = params.Data.FloatFeatureCount;
+    config["cat_features"] = params.Data.CatFeatureCount;
+    config["cat_cardinality"] = params.Data.CatFeatureCardinality;
+    config["average_group_size"] = params.Data.AverageGroupSize;
+    config["binary_target"] = params.Data.BinaryTarget;
+    config["seed"] = params.Data.Seed;
+    config["iterations"] = params.IterationCount;
+    config["depth"] = params.Depth;
+    config["border_count"] = params.BorderCount;
+    config["thread_count"] = params.ThreadCount;
+    config["loss_function"] = params.LossFunction;
+    config["boosting_type"] = params.BoostingType;
+
+    auto& phases = result["phases"]; // seconds
+
+    THPTimer timer;
+    TDataProviderPtr data = GenerateData(params.Data);
+    phases["GenerateData"] = timer.PassedReset();
+
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(params.ThreadCount - 1);
+
+    TRawDataProviderPtr rawData = data->CastMoveTo<TRawObjectsDataProvider>();
+    CB_ENSURE_INTERNAL(rawData, "Synthetic data is not raw");
+    data.Drop();
+
+    auto quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+        *rawData->MetaInfo.FeaturesLayout,
+        TConstArrayRef<ui32>(),
+        NCatboostOptions::TBinarizationOptions(EBorderSelectionType::GreedyLogSum, params.BorderCount)
+    );
+    TQuantizationOptions quantizationOptions;
+    quantizationOptions.GpuCompatibleFormat = false;
+    TRestorableFastRng64 rand(params.Data.Seed);
+
+    timer.Reset();
+    TQuantizedDataProviderPtr quantizedData = Quantize(
+        quantizationOptions,
+        std::move(rawData),
+        quantizedFeaturesInfo,
+        &rand,
+        &executor
+    );
+    phases["Quantize"] = timer.PassedReset();
+
+    TTempDir trainDir;
+    const TString profileLogName = "profile.log";
+
+    NJson::TJsonValue trainParams;
+    trainParams.InsertValue("iterations", params.IterationCount);
+    trainParams.InsertValue("depth", params.Depth);
+    trainParams.InsertValue("thread_count", params.ThreadCount);
+    trainParams.InsertValue("loss_function", params.LossFunction);
+    trainParams.InsertValue("boosting_type", params.BoostingType);
+    trainParams.InsertValue("random_seed", params.Data.Seed);
+    trainParams.InsertValue("detailed_profile", true);
+    trainParams.InsertValue("logging_level", "Silent");
+    trainParams.InsertValue("train_dir", trainDir.Name());
+    trainParams.InsertValue("profile_log", profileLogName);
+
+    TDataProviders dataProviders;
+    dataProviders.Learn = quantizedData->CastMoveTo<TObjectsDataProvider>();
+    quantizedData.Drop();
+
+    TFullModel model;
+    timer.Reset();
+    TrainModel(
+        trainParams,
+        quantizedFeaturesInfo,
+        /*objectiveDescriptor*/ Nothing(),
+        /*evalMetricDescriptor*/ Nothing(),
+        std::move(dataProviders),
+        /*outputModelPath*/ "",
+        &model,
+        /*evalResultPtrs*/ {}
+    );
+    result["train_time"] = timer.PassedReset();
+
+    const NJson::TJsonValue profileSummary = ReadProfileSummary(
+        JoinFsPaths(trainDir.Name(), profileLogName + ".json")
+    );
+    result["average_iteration_time"] = profileSummary["average_iteration_time"];
+
+    // average times per iteration
+    auto& operations = result["operations"];
+    TMap<TString, double> phaseTimes;
+    for (const auto& [operation, time] : profileSummary["times"].GetMapSafe()) {
+        operations[operation] = time;
+        for (const auto& [phase, prefixes] : PhaseOperationPrefixes) {
+            if (AnyOf(prefixes, [&] (const TString& prefix) { return operation.StartsWith(prefix); })) {
+                phaseTimes[phase] += time.GetDoubleRobust();
+            }
+        }
+    }
+    for (const auto& [phase, prefixes] : PhaseOperationPrefixes) {
+        Y_UNUSED(prefixes);
+        phases[phase] = phaseTimes[phase]; // 0 if phase has not run (e.g. no cat features for CTRs)
+    }
+
+    return result;
+}
+
+
+int main(int argc, char** argv) {
+    using namespace NLastGetopt;
+
+    TBenchmarkParams params;
+
+    TOpts opts = NLastGetopt::TOpts::Default();
+    opts.AddLongOption("rows").RequiredArgument("INT")
+        .DefaultValue(params.Data.ObjectCount)
+        .StoreResult(&params.Data.ObjectCount);
+    opts.AddLongOption("float-features").RequiredArgument("INT")
+        .DefaultValue(params.Data.FloatFeatureCount)
+        .StoreResult(&params.Data.FloatFeatureCount);
+    opts.AddLongOption("cat-features").RequiredArgument("INT")
+        .DefaultValue(params.Data.CatFeatureCount)
+        .StoreResult(&params.Data.CatFeatureCount);
+    opts.AddLongOption("cat-cardinality").RequiredArgument("INT")
+        .Help("Number of distinct values of each categorical feature")
+        .DefaultValue(params.Data.CatFeatureCardinality)
+        .StoreResult(&params.Data.CatFeatureCardinality);
+    opts.AddLongOption("group-size").RequiredArgument("INT")
+        .Help("Average size of query groups, group sizes are uniform in [1, 2 * INT - 1]. 0 means no groups")
+        .DefaultValue(params.Data.AverageGroupSize)
+        .StoreResult(&params.Data.AverageGroupSize);
+    opts.AddLongOption("binary-target")
+        .Help("Generate 0/1 target (for Logloss and other binary classification losses)")
+        .NoArgument()
+        .SetFlag(&params.Data.BinaryTarget);
+    opts.AddLongOption("seed").RequiredArgument("INT")
+        .Help("Seed for data generation and training")
+        .DefaultValue(params.Data.Seed)
+        .StoreResult(&params.Data.Seed);
+    opts.AddLongOption('i', "iterations").RequiredArgument("INT")
+        .DefaultValue(params.IterationCount)
+        .StoreResult(&params.IterationCount);
+    opts.AddLongOption("depth").RequiredArgument("INT")
+        .DefaultValue(params.Depth)
+        .StoreResult(&params.Depth);
+    opts.AddLongOption('x', "border-count").RequiredArgument("INT")
+        .DefaultValue(params.BorderCount)
+        .StoreResult(&params.BorderCount);
+    opts.AddLongOption('T', "thread-count").RequiredArgument("INT")
+        .DefaultValue(params.ThreadCount)
+        .StoreResult(&params.ThreadCount);
+    opts.AddLongOption("loss-function").RequiredArgument("STRING")
+        .DefaultValue(params.LossFunction)
+        .StoreResult(&params.LossFunction);
+    opts.AddLongOption("boosting-type").RequiredArgument("STRING")
+        .DefaultValue(params.BoostingType)
+        .StoreResult(&params.BoostingType);
+    opts.AddLongOption('o', "output").RequiredArgument("PATH")
+        .Help("Write JSON with timings to PATH instead of stdout")
+        .StoreResult(&params.OutputPath);
+    opts.SetFreeArgsNum(0);
+    TOptsParseResult args(&opts, argc, argv);
+
+    CB_ENSURE(params.Data.ObjectCount > 0, "rows should be positive");
+    CB_ENSURE(params.Data.FloatFeatureCount + params.Data.CatFeatureCount > 0, "No features");
+    CB_ENSURE(params.Data.CatFeatureCardinality > 0, "cat-cardinality should be positive");
+    CB_ENSURE(params.ThreadCount > 0, "thread-count should be positive");
+
+    const NJson::TJsonValue result = RunBenchmark(params);
+
+    if (params.OutputPath) {
+        TOFStream out(params.OutputPath);
+        NJson::WriteJson(&out, &result, /*formatOutput*/ true, /*sortkeys*/ true);
+    } else {
+        NJson::WriteJson(&Cout, &result, /*formatOutput*/ true, /*sortkeys*/ true);
+        Cout << Endl;
+    }
+    return 0;
+}
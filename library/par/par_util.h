@@ -127,6 +127,7 @@ namespace NPar {
         };
 
         TIntrusivePtr<TCallback> Callback;
+        bool IsAbandoned = false;
 
     public:
         TJobExecutor(TJobDescription* descr, IEnvironment* env) {
@@ -138,11 +139,16 @@ namespace NPar {
             ctx->Run(descr, Callback.Get());
         }
         ~TJobExecutor() {
-            Y_ASSERT(Callback->IsReadyFlag);
+            Y_ASSERT(Callback->IsReadyFlag || IsAbandoned);
         }
         bool IsReady() const {
             return Callback->IsReadyFlag;
         }
+        // returns false if results are not ready in timeout, executor can be destroyed without waiting for them then
+        bool WaitResult(TDuration timeout) {
+            IsAbandoned = !Callback->Ready.WaitT(timeout);
+            return !IsAbandoned;
+        }
         void GetRawResult(TVector<TVector<char>>* res) {
             Callback->Ready.Wait();
             Y_ASSERT(Callback->IsReadyFlag);